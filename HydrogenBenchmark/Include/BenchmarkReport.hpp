@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Hydrogen/Hydrogen.hpp>
+#include <Hydrogen/Renderer/RenderGraph.hpp>
+
+#include <filesystem>
+
+// Timing metrics where both runs stay below this are treated as noise by Compare
+#define BENCHMARK_TIME_NOISE_FLOOR_MS 0.05
+
+struct BenchmarkFrame
+{
+	double CpuMs = 0.0;
+	Hydrogen::RgFrameStats Graph;
+};
+
+struct BenchmarkMemory
+{
+	uint64_t AllocationCount = 0;
+	uint64_t AllocationBytes = 0;
+	uint64_t BlockCount = 0;
+	uint64_t BlockBytes = 0;
+	uint64_t PeakAllocationBytes = 0;
+};
+
+class BenchmarkReport
+{
+public:
+	std::string Scene;
+	std::string Device;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint32_t WarmupFrames = 0;
+
+	void AddFrame(BenchmarkFrame frame) { m_Frames.push_back(std::move(frame)); }
+	void AddGpuTimings(const Hydrogen::RgGpuFrameTimings& timings) { m_GpuFrames.push_back(timings); }
+	void SampleMemory(VmaAllocator allocator);
+
+	size_t GetFrameCount() const { return m_Frames.size(); }
+
+	json ToJson() const;
+	bool Write(const std::filesystem::path& path) const;
+
+	static bool Read(const std::filesystem::path& path, json& outReport);
+
+	// Logs every metric of current against baseline and returns how many got worse by more than thresholdPercent
+	static uint32_t Compare(const json& baseline, const json& current, double thresholdPercent);
+
+private:
+	std::vector<BenchmarkFrame> m_Frames;
+	std::vector<Hydrogen::RgGpuFrameTimings> m_GpuFrames;
+	BenchmarkMemory m_Memory;
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// --bind-cost [binds], times the lookup of a pipeline bind through the old spec hash and through a registered handle without starting the renderer
+int RunBindBenchmark(const std::vector<std::string>& args);
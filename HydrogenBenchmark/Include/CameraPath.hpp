@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Hydrogen/Hydrogen.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <filesystem>
+
+struct CameraPathKey
+{
+	glm::vec3 Position{ 0.0f };
+	glm::vec3 Target{ 0.0f };
+};
+
+// Catmull-Rom spline through recorded camera keys, sampled by normalized time so a run is independent of frame timing
+class CameraPath
+{
+public:
+	CameraPath() = default;
+	CameraPath(std::vector<CameraPathKey> keys, bool loop)
+		: m_Keys(std::move(keys)), m_Loop(loop) {}
+
+	// { "loop": true, "keys": [ { "position": [x, y, z], "target": [x, y, z] }, ... ] }
+	static bool Load(const std::filesystem::path& path, CameraPath& outPath);
+	static CameraPath CreateOrbit(const glm::vec3& center, float radius, float height, uint32_t keyCount = 8);
+
+	// t in [0, 1] over the whole path
+	void Evaluate(float t, glm::vec3& outPosition, glm::quat& outRotation) const;
+
+	bool IsEmpty() const { return m_Keys.empty(); }
+	size_t GetKeyCount() const { return m_Keys.size(); }
+
+private:
+	const CameraPathKey& GetKey(int64_t index) const;
+
+	std::vector<CameraPathKey> m_Keys;
+	bool m_Loop = false;
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// --jobs [--max-threads N] [--out <report>], measures job system overhead and scaling without starting the renderer
+int RunJobBenchmark(const std::vector<std::string>& args);
@@ -0,0 +1,542 @@
+#include <Hydrogen/Hydrogen.hpp>
+
+#include "CameraPath.hpp"
+#include "BenchmarkReport.hpp"
+#include "JobBenchmark.hpp"
+#include "BindBenchmark.hpp"
+
+#include <chrono>
+#include <filesystem>
+
+using namespace Hydrogen;
+
+class BenchmarkApp : public Application
+{
+private:
+	// [--scene <name>] [--frames N] [--warmup N] [--path <camera path>] [--out <report>] [--width W] [--height H]
+	void ParseCommandLine()
+	{
+		for (size_t i = 0; i < CommandLineArgs.size(); i++)
+		{
+			const std::string& arg = CommandLineArgs[i];
+			bool hasValue = i + 1 < CommandLineArgs.size();
+
+			if (arg == "--scene" && hasValue)
+				ApplicationSpec.StartupScene = CommandLineArgs[++i];
+			else if (arg == "--frames" && hasValue)
+				m_MeasuredFrames = std::max(1u, (uint32_t)std::stoul(CommandLineArgs[++i]));
+			else if (arg == "--warmup" && hasValue)
+				m_WarmupFrames = (uint32_t)std::stoul(CommandLineArgs[++i]);
+			else if (arg == "--path" && hasValue)
+				m_CameraPathFile = CommandLineArgs[++i];
+			else if (arg == "--out" && hasValue)
+				m_ReportFile = CommandLineArgs[++i];
+			else if (arg == "--width" && hasValue)
+				ApplicationSpec.ViewportSize.x = (float)std::stoi(CommandLineArgs[++i]);
+			else if (arg == "--height" && hasValue)
+				ApplicationSpec.ViewportSize.y = (float)std::stoi(CommandLineArgs[++i]);
+			else
+				HY_APP_WARN("Ignoring unknown command line argument '{}'", arg);
+		}
+	}
+
+	Entity FindActiveCamera()
+	{
+		Entity activeCameraEntity;
+		CurrentScene->GetScene()->IterateComponents<CameraComponent>(
+			[&](Entity entity, CameraComponent& camera)
+			{
+				if (camera.Active)
+					activeCameraEntity = entity;
+			});
+
+		return activeCameraEntity;
+	}
+
+	void SetupCameraPath(Entity cameraEntity)
+	{
+		if (!m_CameraPathFile.empty() && CameraPath::Load(m_CameraPathFile, m_CameraPath))
+		{
+			HY_APP_INFO("Driving the camera along '{}' ({} keys)", m_CameraPathFile.string(), m_CameraPath.GetKeyCount());
+			return;
+		}
+
+		// without a recorded path orbit the origin at the distance the scene camera starts from
+		glm::vec3 start = cameraEntity.GetComponent<TransformComponent>().GetTranslation();
+		float radius = std::max(glm::length(glm::vec2(start.x, start.z)), 1.0f);
+		m_CameraPath = CameraPath::CreateOrbit(glm::vec3(0.0f), radius, start.y);
+
+		HY_APP_INFO("Driving the camera along a default orbit with radius {:.1f}", radius);
+	}
+
+	void DriveCamera(Entity cameraEntity)
+	{
+		// warmup frames hold the first pose so pipeline creation does not shift the measured path
+		uint64_t frame = GetFrameCount();
+		float t = 0.0f;
+		if (frame >= m_WarmupFrames && m_MeasuredFrames > 1)
+		{
+			t = (float)(frame - m_WarmupFrames) / (float)(m_MeasuredFrames - 1);
+		}
+
+		glm::vec3 position;
+		glm::quat rotation;
+		m_CameraPath.Evaluate(t, position, rotation);
+
+		auto& transform = cameraEntity.GetComponent<TransformComponent>();
+		transform.SetTranslation(position);
+		transform.SetRotation(rotation);
+
+		auto& camera = cameraEntity.GetComponent<CameraComponent>();
+		camera.CalculateView(cameraEntity);
+
+		uint32_t width = (uint32_t)MainViewport->GetWidth();
+		uint32_t height = (uint32_t)MainViewport->GetHeight();
+		if (camera.ViewportWidth != width || camera.ViewportHeight != height)
+		{
+			camera.ViewportWidth = width;
+			camera.ViewportHeight = height;
+			camera.CalculateProj();
+		}
+	}
+
+	std::unique_ptr<Renderer> m_Renderer;
+	BenchmarkReport m_Report;
+	CameraPath m_CameraPath;
+	Entity m_CameraEntity;
+
+	uint64_t m_LastGpuTimingsFrame = UINT64_MAX;
+
+	uint32_t m_MeasuredFrames = 600;
+	uint32_t m_WarmupFrames = 30;
+	std::filesystem::path m_CameraPathFile;
+	std::filesystem::path m_ReportFile = "benchmark_report.json";
+
+public:
+	virtual void OnSetup() override
+	{
+		ApplicationSpec.Name = "Hydrogen Benchmark";
+		ApplicationSpec.Version = { 1, 0 };
+		ApplicationSpec.ViewportTitle = "Hydrogen Benchmark";
+		ApplicationSpec.ViewportSize = { 1920, 1080 };
+		ApplicationSpec.UseDebugGUI = false;
+		ApplicationSpec.StartupScene = "PointLightStress.hyscene";
+
+		ParseCommandLine();
+
+		// headless runs advance with a fixed time step, which keeps scripts and animation identical between runs
+		ApplicationSpec.Headless = true;
+		ApplicationSpec.FrameLimit = (uint64_t)m_WarmupFrames + m_MeasuredFrames;
+	}
+
+	virtual void OnStartup() override
+	{
+		m_Renderer = std::make_unique<Renderer>(ActiveRenderDevice.get());
+
+		m_Report.Scene = ApplicationSpec.StartupScene;
+		m_Report.Device = GetCurrentRenderDeviceDesc().Name;
+		m_Report.Width = (uint32_t)MainViewport->GetWidth();
+		m_Report.Height = (uint32_t)MainViewport->GetHeight();
+		m_Report.WarmupFrames = m_WarmupFrames;
+
+		m_CameraEntity = FindActiveCamera();
+		HY_ASSERT(m_CameraEntity.IsValid(), "Benchmark scene '{}' has no active camera", ApplicationSpec.StartupScene);
+		SetupCameraPath(m_CameraEntity);
+
+		CurrentScene->GetScene()->InitScripts();
+	}
+
+	virtual void OnShutdown() override
+	{
+		HY_APP_INFO("Benchmark finished, {} frames measured", m_Report.GetFrameCount());
+		if (m_Report.Write(m_ReportFile))
+		{
+			HY_APP_INFO("Wrote benchmark report to '{}'", m_ReportFile.string());
+		}
+
+		m_Renderer.reset();
+	}
+
+	virtual void OnUpdate(float dt) override
+	{
+		PhysicsUpdate(dt);
+		DriveCamera(m_CameraEntity);
+
+		using clock = std::chrono::high_resolution_clock;
+		auto frameStart = clock::now();
+
+		const auto& camera = m_CameraEntity.GetComponent<CameraComponent>();
+		glm::vec3 cameraPos = glm::vec3(glm::inverse(camera.View)[3]);
+
+		RenderSettings settings = { .Display = { .Width = (uint64_t)MainViewport->GetWidth(), .Height = (uint64_t)MainViewport->GetHeight(), .RenderToSwapChain = false } };
+		DefaultRenderer::RenderSceneDeferred(m_Renderer.get(), settings, camera, cameraPos, CurrentScene->GetScene());
+
+		std::chrono::duration<double, std::milli> frameTime = clock::now() - frameStart;
+
+		if (GetFrameCount() < m_WarmupFrames)
+		{
+			return;
+		}
+
+		BenchmarkFrame frame;
+		frame.CpuMs = frameTime.count();
+		frame.Graph = m_Renderer->GetRenderGraph()->GetFrameStats();
+		m_Report.AddFrame(std::move(frame));
+		m_Report.SampleMemory(ActiveRenderDevice->GetAllocator());
+
+		// GPU timings trail by a few frames, only keep each measured frame once
+		const RenderGraph* graph = m_Renderer->GetRenderGraph();
+		const auto& gpuTimings = graph->GetGpuTimings();
+		if (graph->HasGpuTimings() && gpuTimings.FrameNumber >= m_WarmupFrames && gpuTimings.FrameNumber != m_LastGpuTimingsFrame)
+		{
+			m_LastGpuTimingsFrame = gpuTimings.FrameNumber;
+			m_Report.AddGpuTimings(gpuTimings);
+		}
+	}
+
+	virtual void OnImGuiRender() override
+	{
+	}
+
+	virtual void OnSwapchainRecreation() override
+	{
+	}
+
+	virtual void OnRenderDeviceChangeStart() override
+	{
+		m_Renderer.reset();
+	}
+
+	virtual void OnRenderDeviceChangeFinish() override
+	{
+		m_Renderer = std::make_unique<Renderer>(ActiveRenderDevice.get());
+	}
+};
+
+// --compare <baseline.json> <current.json> [--threshold <percent>]
+static int RunCompare(const std::vector<std::string>& args)
+{
+	if (args.size() < 3)
+	{
+		HY_APP_ERROR("Usage: HydrogenBenchmark --compare <baseline.json> <current.json> [--threshold <percent>]");
+		return 2;
+	}
+
+	double threshold = 5.0;
+	for (size_t i = 3; i + 1 < args.size(); i++)
+	{
+		if (args[i] == "--threshold")
+			threshold = std::stod(args[++i]);
+	}
+
+	json baseline, current;
+	if (!BenchmarkReport::Read(args[1], baseline) || !BenchmarkReport::Read(args[2], current))
+	{
+		return 2;
+	}
+
+	uint32_t regressions = BenchmarkReport::Compare(baseline, current, threshold);
+	if (regressions > 0)
+	{
+		HY_APP_ERROR("{} metrics regressed by more than {:.1f}%", regressions, threshold);
+		return 1;
+	}
+
+	HY_APP_INFO("No metric regressed by more than {:.1f}%", threshold);
+	return 0;
+}
+
+static bool MeasureSceneLoad(uint32_t entityCount)
+{
+	using clock = std::chrono::high_resolution_clock;
+	using milliseconds = std::chrono::duration<double, std::milli>;
+
+	json serialized;
+	std::vector<uint8_t> binary;
+	{
+		Scene source;
+
+		// every entity parents to one created before it, so post deserialization resolves a UUID per entity
+		std::vector<uint64_t> uuids;
+		uuids.reserve(entityCount);
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			Entity entity(&source, "Entity " + std::to_string(i));
+			entity.GetComponent<TransformComponent>().SetTranslation(glm::vec3((float)(i % 100), 0.0f, (float)(i / 100)));
+			if (i > 0)
+			{
+				entity.GetComponent<RelationshipComponent>().ParentUUID = uuids[(i - 1) / 8];
+			}
+
+			uuids.push_back(entity.GetUUID());
+		}
+
+		auto start = clock::now();
+		serialized = source.SerializeScene();
+		double saveMs = milliseconds(clock::now() - start).count();
+
+		start = clock::now();
+		std::string text = serialized.dump(4);
+		double dumpMs = milliseconds(clock::now() - start).count();
+
+		start = clock::now();
+		binary = source.SerializeSceneBinary();
+		double binarySaveMs = milliseconds(clock::now() - start).count();
+
+		HY_APP_INFO("[{}] JSON save {:.2f} ms + {:.2f} ms to text, {} KB", entityCount, saveMs, dumpMs, text.size() / 1024);
+		HY_APP_INFO("[{}] Binary save {:.2f} ms, {} KB", entityCount, binarySaveMs, binary.size() / 1024);
+	}
+
+	Scene loaded;
+	auto start = clock::now();
+	loaded.DeserializeScene(serialized);
+	double loadMs = milliseconds(clock::now() - start).count();
+
+	Scene binaryLoaded;
+	start = clock::now();
+	bool binaryOk = binaryLoaded.DeserializeSceneBinary(binary.data(), binary.size());
+	double binaryLoadMs = milliseconds(clock::now() - start).count();
+
+	start = clock::now();
+	uint32_t resolved = 0;
+	uint32_t binaryResolved = 0;
+	for (const auto& [key, value] : serialized.items())
+	{
+		uint64_t uuid = std::stoull(key);
+		if (loaded.GetEntityByUUID(uuid).IsValid())
+			resolved++;
+		if (binaryLoaded.GetEntityByUUID(uuid).IsValid())
+			binaryResolved++;
+	}
+	double lookupMs = milliseconds(clock::now() - start).count();
+
+	// the binary load has to come back to the same json, otherwise it dropped or mangled something
+	bool binaryMatches = binaryOk && binaryLoaded.SerializeScene() == serialized;
+
+	// what entering play mode in the editor costs
+	Scene clone;
+	start = clock::now();
+	loaded.Clone(clone);
+	double cloneMs = milliseconds(clock::now() - start).count();
+
+	uint32_t cloned = 0;
+	for (const auto& [key, value] : serialized.items())
+	{
+		if (clone.GetEntityByUUID(std::stoull(key)).IsValid())
+			cloned++;
+	}
+
+	HY_APP_INFO("[{}] JSON load {:.2f} ms", entityCount, loadMs);
+	HY_APP_INFO("[{}] Binary load {:.2f} ms, {} round trip", entityCount, binaryLoadMs, binaryMatches ? "matching" : "MISMATCHED");
+	HY_APP_INFO("[{}] Resolved {}/{} UUIDs in both scenes in {:.2f} ms", entityCount, std::min(resolved, binaryResolved), entityCount, lookupMs);
+	HY_APP_INFO("[{}] Cloned {}/{} entities in {:.2f} ms", entityCount, cloned, entityCount, cloneMs);
+
+	return binaryMatches && resolved == entityCount && binaryResolved == entityCount && cloned == entityCount;
+}
+
+// --scene-load [entity counts...], times JSON and binary round trips and a clone of a synthetic hierarchy without starting the renderer
+static int RunSceneLoad(const std::vector<std::string>& args)
+{
+	std::vector<uint32_t> entityCounts;
+	for (size_t i = 1; i < args.size(); i++)
+	{
+		entityCounts.push_back((uint32_t)std::stoul(args[i]));
+	}
+
+	if (entityCounts.empty())
+		entityCounts = { 10000, 100000 };
+
+	bool passed = true;
+	for (uint32_t entityCount : entityCounts)
+	{
+		passed &= MeasureSceneLoad(entityCount);
+	}
+
+	return passed ? 0 : 1;
+}
+
+// --prefab-spawn [copy count], times bulk prefab instantiation against spawning the same copies one call at a time
+static int RunPrefabSpawn(const std::vector<std::string>& args)
+{
+	uint32_t copyCount = args.size() > 1 ? (uint32_t)std::stoul(args[1]) : 10000;
+
+	using clock = std::chrono::high_resolution_clock;
+	using milliseconds = std::chrono::duration<double, std::milli>;
+
+	// a light with a few children, written out like an editor made prefab
+	const uint32_t childCount = 7;
+	std::filesystem::path prefabPath = std::filesystem::temp_directory_path() / "Benchmark.hyprefab";
+	{
+		Scene source;
+		Entity root(&source, "Root");
+		root.AddComponent<PointLightComponent>();
+		for (uint32_t i = 0; i < childCount; i++)
+		{
+			Entity child(&source, "Child " + std::to_string(i));
+			child.GetComponent<TransformComponent>().SetTranslation(glm::vec3((float)i, 1.0f, 0.0f));
+			source.SetParent(child, root);
+		}
+
+		std::ofstream fout(prefabPath);
+		fout << source.SerializeScene().dump(4);
+	}
+
+	PrefabAsset prefab(prefabPath.string(), json::object());
+
+	auto start = clock::now();
+	prefab.GetTemplate();
+	double templateMs = milliseconds(clock::now() - start).count();
+
+	std::vector<glm::vec3> offsets(copyCount);
+	for (uint32_t i = 0; i < copyCount; i++)
+		offsets[i] = glm::vec3((float)(i % 100) * 10.0f, 0.0f, (float)(i / 100) * 10.0f);
+
+	Scene bulk;
+	start = clock::now();
+	std::vector<Entity> roots = bulk.Instantiate(prefab, copyCount, offsets);
+	double bulkMs = milliseconds(clock::now() - start).count();
+
+	Scene single;
+	start = clock::now();
+	for (uint32_t i = 0; i < copyCount; i++)
+		single.Instantiate(prefab, 1, { offsets[i] });
+	double singleMs = milliseconds(clock::now() - start).count();
+
+	std::filesystem::remove(prefabPath);
+
+	// every copy has to hang together on its own and sit where it was asked to
+	bulk.UpdateTransforms();
+	uint32_t intact = 0;
+	for (uint32_t i = 0; i < roots.size(); i++)
+	{
+		auto children = bulk.GetChildren(roots[i]);
+		bool placed = glm::all(glm::equal(roots[i].GetComponent<TransformComponent>().GetWorldPosition(), offsets[i]));
+		if (children.size() == childCount && placed && roots[i].HasComponent<PointLightComponent>())
+			intact++;
+	}
+
+	uint32_t entityCount = copyCount * (childCount + 1);
+	HY_APP_INFO("Prefab template built in {:.2f} ms", templateMs);
+	HY_APP_INFO("[{}] Bulk spawn of {} entities {:.2f} ms", copyCount, entityCount, bulkMs);
+	HY_APP_INFO("[{}] One copy per call {:.2f} ms", copyCount, singleMs);
+	HY_APP_INFO("[{}] {}/{} copies intact", copyCount, intact, copyCount);
+
+	return intact == copyCount && roots.size() == copyCount ? 0 : 1;
+}
+
+// --component-iteration [entity count] [passes], times the hot component loops of a frame without starting the renderer
+static int RunComponentIteration(const std::vector<std::string>& args)
+{
+	uint32_t entityCount = args.size() > 1 ? (uint32_t)std::stoul(args[1]) : 100000;
+	uint32_t passes = args.size() > 2 ? std::max(1u, (uint32_t)std::stoul(args[2])) : 100;
+
+	using clock = std::chrono::high_resolution_clock;
+	using milliseconds = std::chrono::duration<double, std::milli>;
+
+	HY_APP_INFO("sizeof Transform {} B, Relationship {} B, PointLight {} B, DirectionalLight {} B",
+		sizeof(TransformComponent), sizeof(RelationshipComponent), sizeof(PointLightComponent), sizeof(DirectionalLightComponent));
+
+	Scene scene;
+	for (uint32_t i = 0; i < entityCount; i++)
+	{
+		Entity entity(&scene, "Entity " + std::to_string(i));
+		entity.GetComponent<TransformComponent>().SetTranslation(glm::vec3((float)(i % 100), 0.0f, (float)(i / 100)));
+
+		// every eighth entity is a light, like the point light stress scene
+		if (i % 8 == 0)
+			entity.AddComponent<PointLightComponent>();
+	}
+	scene.UpdateTransforms();
+
+	auto& registry = scene.GetRegistry();
+
+	// the sum keeps the loops from being optimized away
+	float checksum = 0.0f;
+
+	auto start = clock::now();
+	for (uint32_t pass = 0; pass < passes; pass++)
+	{
+		for (auto [entity, transform] : registry.view<TransformComponent>().each())
+			checksum += transform.GetWorldPosition().y + (float)pass;
+	}
+	double transformMs = milliseconds(clock::now() - start).count() / passes;
+
+	start = clock::now();
+	for (uint32_t pass = 0; pass < passes; pass++)
+	{
+		for (const glm::mat4& matrix : scene.GetWorldTransforms().Matrices)
+			checksum += matrix[3].y + (float)pass;
+	}
+	double streamMs = milliseconds(clock::now() - start).count() / passes;
+
+	start = clock::now();
+	for (uint32_t pass = 0; pass < passes; pass++)
+	{
+		for (auto [entity, light, transform] : registry.view<PointLightComponent, TransformComponent>().each())
+			checksum += light.Intensity * light.Radius + transform.GetWorldPosition().x;
+	}
+	double lightMs = milliseconds(clock::now() - start).count() / passes;
+
+	start = clock::now();
+	for (uint32_t pass = 0; pass < passes; pass++)
+	{
+		for (auto [entity, transform] : registry.view<TransformComponent>().each())
+			transform.SetTranslation(transform.GetTranslation() + glm::vec3(0.0f, 0.001f, 0.0f));
+
+		scene.UpdateTransforms();
+	}
+	double hierarchyMs = milliseconds(clock::now() - start).count() / passes;
+
+	HY_APP_INFO("Transform iteration over {} entities: {:.3f} ms", entityCount, transformMs);
+	HY_APP_INFO("Packed world matrix walk: {:.3f} ms", streamMs);
+	HY_APP_INFO("Point light gather: {:.3f} ms", lightMs);
+	HY_APP_INFO("Move everything and rebuild world matrices: {:.3f} ms", hierarchyMs);
+	HY_APP_INFO("Checksum {}", checksum);
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	Hydrogen::EngineLogger::Init();
+	Hydrogen::AppLogger::Init();
+
+	std::vector<std::string> args(argv + 1, argv + argc);
+	int exitCode = 0;
+
+	if (!args.empty() && args[0] == "--compare")
+	{
+		exitCode = RunCompare(args);
+	}
+	else if (!args.empty() && args[0] == "--scene-load")
+	{
+		exitCode = RunSceneLoad(args);
+	}
+	else if (!args.empty() && args[0] == "--prefab-spawn")
+	{
+		exitCode = RunPrefabSpawn(args);
+	}
+	else if (!args.empty() && args[0] == "--component-iteration")
+	{
+		exitCode = RunComponentIteration(args);
+	}
+	else if (!args.empty() && args[0] == "--jobs")
+	{
+		exitCode = RunJobBenchmark(args);
+	}
+	else if (!args.empty() && args[0] == "--bind-cost")
+	{
+		exitCode = RunBindBenchmark(args);
+	}
+	else
+	{
+		auto app = std::make_shared<BenchmarkApp>();
+		app->CommandLineArgs = args;
+		app->Run();
+	}
+
+	Hydrogen::EngineLogger::Shutdown();
+	Hydrogen::AppLogger::Shutdown();
+
+	return exitCode;
+}
@@ -0,0 +1,309 @@
+#include "BenchmarkReport.hpp"
+
+#include <fstream>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace Hydrogen;
+
+static json Summarize(std::vector<double> samples)
+{
+	json summary = { { "avg", 0.0 }, { "min", 0.0 }, { "max", 0.0 }, { "p95", 0.0 } };
+	if (samples.empty())
+	{
+		return summary;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	size_t p95Index = std::min(samples.size() - 1, (size_t)std::ceil(0.95 * (double)samples.size()) - 1);
+
+	summary["avg"] = std::accumulate(samples.begin(), samples.end(), 0.0) / (double)samples.size();
+	summary["min"] = samples.front();
+	summary["max"] = samples.back();
+	summary["p95"] = samples[p95Index];
+	return summary;
+}
+
+static json AverageCommands(const std::vector<RgCommandStats>& samples)
+{
+	RgCommandStats total;
+	for (const auto& sample : samples)
+	{
+		total.Add(sample);
+	}
+
+	double count = samples.empty() ? 1.0 : (double)samples.size();
+	return {
+		{ "draws", total.DrawCount / count },
+		{ "dispatches", total.DispatchCount / count },
+		{ "pipeline_binds", total.PipelineBindCount / count },
+		{ "descriptor_set_binds", total.DescriptorSetBindCount / count },
+		{ "vertex_buffer_binds", total.VertexBufferBindCount / count },
+		{ "index_buffer_binds", total.IndexBufferBindCount / count }
+	};
+}
+
+void BenchmarkReport::SampleMemory(VmaAllocator allocator)
+{
+	VmaTotalStatistics stats{};
+	vmaCalculateStatistics(allocator, &stats);
+
+	m_Memory.AllocationCount = stats.total.statistics.allocationCount;
+	m_Memory.AllocationBytes = stats.total.statistics.allocationBytes;
+	m_Memory.BlockCount = stats.total.statistics.blockCount;
+	m_Memory.BlockBytes = stats.total.statistics.blockBytes;
+	m_Memory.PeakAllocationBytes = std::max(m_Memory.PeakAllocationBytes, m_Memory.AllocationBytes);
+}
+
+json BenchmarkReport::ToJson() const
+{
+	auto collect = [this](auto getter)
+		{
+			std::vector<double> samples;
+			samples.reserve(m_Frames.size());
+			for (const auto& frame : m_Frames)
+			{
+				samples.push_back(getter(frame));
+			}
+			return Summarize(std::move(samples));
+		};
+
+	json report;
+	report["scene"] = Scene;
+	report["device"] = Device;
+	report["width"] = Width;
+	report["height"] = Height;
+	report["warmup"] = WarmupFrames;
+	report["frames"] = m_Frames.size();
+
+	report["frame"]["cpu_ms"] = collect([](const BenchmarkFrame& f) { return f.CpuMs; });
+
+	std::vector<double> gpuFrameMs;
+	for (const auto& gpuFrame : m_GpuFrames)
+	{
+		gpuFrameMs.push_back(gpuFrame.TotalMs);
+	}
+	report["frame"]["gpu_ms"] = Summarize(std::move(gpuFrameMs));
+
+	json& phases = report["phases"];
+	phases["compile_resources_ms"] = collect([](const BenchmarkFrame& f) { return f.Graph.CompileResourcesMs; });
+	phases["compile_passes_ms"] = collect([](const BenchmarkFrame& f) { return f.Graph.CompilePassesMs; });
+	phases["prewarm_ms"] = collect([](const BenchmarkFrame& f) { return f.Graph.PrewarmMs; });
+	phases["descriptor_update_ms"] = collect([](const BenchmarkFrame& f) { return f.Graph.DescriptorUpdateMs; });
+	phases["parallel_record_ms"] = collect([](const BenchmarkFrame& f) { return f.Graph.ParallelRecordMs; });
+	phases["record_ms"] = collect([](const BenchmarkFrame& f) { return f.Graph.RecordMs; });
+
+	// passes keep the order they first appeared in, a pass missing from a frame is left out of its samples
+	std::vector<std::string> passNames;
+	for (const auto& frame : m_Frames)
+	{
+		for (const auto& pass : frame.Graph.Passes)
+		{
+			if (std::find(passNames.begin(), passNames.end(), pass.Name) == passNames.end())
+			{
+				passNames.push_back(pass.Name);
+			}
+		}
+	}
+
+	report["passes"] = json::array();
+	for (const auto& name : passNames)
+	{
+		std::vector<double> recordMs;
+		std::vector<RgCommandStats> commands;
+		for (const auto& frame : m_Frames)
+		{
+			for (const auto& pass : frame.Graph.Passes)
+			{
+				if (pass.Name != name)
+					continue;
+
+				recordMs.push_back(pass.RecordMs);
+				commands.push_back(pass.Commands);
+			}
+		}
+
+		std::vector<double> gpuMs;
+		for (const auto& gpuFrame : m_GpuFrames)
+		{
+			for (const auto& pass : gpuFrame.Passes)
+			{
+				if (pass.Name == name)
+					gpuMs.push_back(pass.Ms);
+			}
+		}
+
+		report["passes"].push_back({
+			{ "name", name },
+			{ "record_ms", Summarize(std::move(recordMs)) },
+			{ "gpu_ms", Summarize(std::move(gpuMs)) },
+			{ "commands", AverageCommands(commands) }
+		});
+	}
+
+	std::vector<RgCommandStats> totals;
+	for (const auto& frame : m_Frames)
+	{
+		totals.push_back(frame.Graph.Commands);
+	}
+	report["commands"] = AverageCommands(totals);
+
+	report["memory"] = {
+		{ "allocations", m_Memory.AllocationCount },
+		{ "allocated_bytes", m_Memory.AllocationBytes },
+		{ "blocks", m_Memory.BlockCount },
+		{ "block_bytes", m_Memory.BlockBytes },
+		{ "peak_allocated_bytes", m_Memory.PeakAllocationBytes }
+	};
+
+	return report;
+}
+
+bool BenchmarkReport::Write(const std::filesystem::path& path) const
+{
+	if (path.has_parent_path())
+	{
+		std::filesystem::create_directories(path.parent_path());
+	}
+
+	std::ofstream fout(path);
+	if (!fout.is_open())
+	{
+		HY_APP_ERROR("Failed to write benchmark report '{}'", path.string());
+		return false;
+	}
+
+	fout << ToJson().dump(4);
+	return true;
+}
+
+bool BenchmarkReport::Read(const std::filesystem::path& path, json& outReport)
+{
+	std::ifstream fin(path);
+	if (!fin.is_open())
+	{
+		HY_APP_ERROR("Failed to open benchmark report '{}'", path.string());
+		return false;
+	}
+
+	outReport = json::parse(fin, nullptr, false);
+	if (outReport.is_discarded())
+	{
+		HY_APP_ERROR("Benchmark report '{}' is not valid json", path.string());
+		return false;
+	}
+
+	return true;
+}
+
+// Every metric is lower is better, timings compare their average
+static std::vector<std::pair<std::string, double>> FlattenMetrics(const json& report)
+{
+	std::vector<std::pair<std::string, double>> metrics;
+
+	if (report.contains("frame"))
+	{
+		for (const auto& [name, summary] : report["frame"].items())
+		{
+			metrics.push_back({ "frame." + name, summary.value("avg", 0.0) });
+		}
+	}
+
+	if (report.contains("phases"))
+	{
+		for (const auto& [name, summary] : report["phases"].items())
+		{
+			metrics.push_back({ "phases." + name, summary.value("avg", 0.0) });
+		}
+	}
+
+	if (report.contains("passes"))
+	{
+		for (const auto& pass : report["passes"])
+		{
+			std::string prefix = "passes." + pass.value("name", std::string()) + ".";
+			metrics.push_back({ prefix + "record_ms", pass["record_ms"].value("avg", 0.0) });
+			if (pass.contains("gpu_ms"))
+			{
+				metrics.push_back({ prefix + "gpu_ms", pass["gpu_ms"].value("avg", 0.0) });
+			}
+
+			for (const auto& [name, value] : pass["commands"].items())
+			{
+				metrics.push_back({ prefix + name, value.get<double>() });
+			}
+		}
+	}
+
+	for (const char* section : { "commands", "memory" })
+	{
+		if (!report.contains(section))
+			continue;
+
+		for (const auto& [name, value] : report[section].items())
+		{
+			metrics.push_back({ std::string(section) + "." + name, value.get<double>() });
+		}
+	}
+
+	return metrics;
+}
+
+uint32_t BenchmarkReport::Compare(const json& baseline, const json& current, double thresholdPercent)
+{
+	auto baselineMetrics = FlattenMetrics(baseline);
+	auto currentMetrics = FlattenMetrics(current);
+
+	std::unordered_map<std::string, double> currentLookup(currentMetrics.begin(), currentMetrics.end());
+
+	uint32_t regressions = 0;
+	for (const auto& [name, baselineValue] : baselineMetrics)
+	{
+		auto it = currentLookup.find(name);
+		if (it == currentLookup.end())
+		{
+			HY_APP_INFO("{:<48} {:>12.4f} -> (missing)", name, baselineValue);
+			continue;
+		}
+
+		double currentValue = it->second;
+		bool isTiming = name.ends_with("_ms");
+		if (isTiming && baselineValue < BENCHMARK_TIME_NOISE_FLOOR_MS && currentValue < BENCHMARK_TIME_NOISE_FLOOR_MS)
+		{
+			continue;
+		}
+
+		double deltaPercent = 0.0;
+		if (baselineValue > 0.0)
+		{
+			deltaPercent = (currentValue - baselineValue) / baselineValue * 100.0;
+		}
+		else if (currentValue > 0.0)
+		{
+			deltaPercent = 100.0;
+		}
+
+		if (deltaPercent > thresholdPercent)
+		{
+			HY_APP_WARN("{:<48} {:>12.4f} -> {:>12.4f} ({:+.1f}%) REGRESSION", name, baselineValue, currentValue, deltaPercent);
+			regressions++;
+		}
+		else
+		{
+			HY_APP_INFO("{:<48} {:>12.4f} -> {:>12.4f} ({:+.1f}%)", name, baselineValue, currentValue, deltaPercent);
+		}
+	}
+
+	for (const auto& [name, value] : currentMetrics)
+	{
+		bool inBaseline = std::any_of(baselineMetrics.begin(), baselineMetrics.end(), [&](const auto& metric) { return metric.first == name; });
+		if (!inBaseline)
+		{
+			HY_APP_INFO("{:<48}    (missing) -> {:>12.4f}", name, value);
+		}
+	}
+
+	return regressions;
+}
@@ -0,0 +1,220 @@
+#include "BindBenchmark.hpp"
+
+#include <Hydrogen/Hydrogen.hpp>
+#include <Hydrogen/Renderer/RenderGraph.hpp>
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+using namespace Hydrogen;
+
+using BenchmarkClock = std::chrono::high_resolution_clock;
+using Nanoseconds = std::chrono::duration<double, std::nano>;
+
+#define BIND_BENCHMARK_REPEATS 5
+
+// stands in for a created pipeline, binding only compares and stores pointers to it
+struct BenchmarkPipeline
+{
+	uint32_t Id = 0;
+};
+
+// how RgCommandList bound pipelines before they were registered, the spec and both shader sources are hashed on every call
+class SpecHashBinder
+{
+public:
+	SpecHashBinder(VkRenderPass renderPass, const std::vector<VkDescriptorSetLayout>& layouts)
+		: m_RenderPass(renderPass), m_DescriptorSetLayouts(layouts) {}
+
+	void BindPipeline(const std::shared_ptr<ShaderAsset>& vertexShader, const std::shared_ptr<ShaderAsset>& fragmentShader, PipelineSpec spec)
+	{
+		spec.DescriptorSetLayouts = m_DescriptorSetLayouts;
+
+		size_t hash = spec.Hash();
+		HashCombine(hash, std::hash<std::string>{}(vertexShader->GetContent()));
+		HashCombine(hash, std::hash<std::string>{}(fragmentShader->GetContent()));
+		HashCombine(hash, reinterpret_cast<size_t>(m_RenderPass));
+
+		if (m_PipelineCache.find(hash) == m_PipelineCache.end())
+		{
+			uint32_t id = (uint32_t)m_PipelineCache.size();
+			m_PipelineCache[hash] = std::make_unique<BenchmarkPipeline>(BenchmarkPipeline{ id });
+		}
+
+		// the layout and the pipeline were each fetched with a lookup of their own
+		m_Fetched += m_PipelineCache[hash]->Id;
+		m_Fetched += m_PipelineCache[hash]->Id;
+
+		m_BoundPipeline = m_PipelineCache.at(hash).get();
+	}
+
+	const BenchmarkPipeline* GetBoundPipeline() const { return m_BoundPipeline; }
+	uint64_t GetFetched() const { return m_Fetched; }
+
+private:
+	VkRenderPass m_RenderPass;
+	std::vector<VkDescriptorSetLayout> m_DescriptorSetLayouts;
+
+	const BenchmarkPipeline* m_BoundPipeline = nullptr;
+	uint64_t m_Fetched = 0;
+
+	std::unordered_map<size_t, std::unique_ptr<BenchmarkPipeline>> m_PipelineCache;
+};
+
+// RgCommandList::BindPipeline without the Vulkan calls, which both paths make alike
+class HandleBinder
+{
+public:
+	HandleBinder(VkRenderPass renderPass, const std::vector<VkDescriptorSetLayout>& layouts)
+		: m_RenderPass(renderPass), m_LayoutHash(RgPipelineLibrary::HashLayouts(layouts)) {}
+
+	void BindPipeline(RgPipelineHandle pipeline)
+	{
+		if (pipeline.Id >= m_ResolvedPipelines.size())
+		{
+			m_ResolvedPipelines.resize(pipeline.Id + 1);
+		}
+
+		auto& resolved = m_ResolvedPipelines[pipeline.Id];
+		if (resolved.RenderPass != m_RenderPass || resolved.LayoutHash != m_LayoutHash || !resolved.PipelinePtr)
+		{
+			resolved.RenderPass = m_RenderPass;
+			resolved.LayoutHash = m_LayoutHash;
+
+			// the pipeline library creates it here, once per handle and pass
+			m_Pipelines.push_back(std::make_unique<BenchmarkPipeline>(BenchmarkPipeline{ pipeline.Id }));
+			resolved.PipelinePtr = m_Pipelines.back().get();
+		}
+
+		if (resolved.PipelinePtr == m_BoundPipeline)
+		{
+			return;
+		}
+
+		m_BoundPipeline = resolved.PipelinePtr;
+	}
+
+	const BenchmarkPipeline* GetBoundPipeline() const { return m_BoundPipeline; }
+
+private:
+	struct ResolvedPipeline
+	{
+		VkRenderPass RenderPass = VK_NULL_HANDLE;
+		size_t LayoutHash = 0;
+		const BenchmarkPipeline* PipelinePtr = nullptr;
+	};
+
+	VkRenderPass m_RenderPass;
+	size_t m_LayoutHash;
+
+	const BenchmarkPipeline* m_BoundPipeline = nullptr;
+
+	std::vector<ResolvedPipeline> m_ResolvedPipelines;
+	std::vector<std::unique_ptr<BenchmarkPipeline>> m_Pipelines;
+};
+
+// best of a few runs in ns per bind, the first run also pays for creating the pipelines
+template<typename Func>
+static double MeasureBest(uint32_t bindCount, Func&& func)
+{
+	double best = 0.0;
+	for (uint32_t i = 0; i < BIND_BENCHMARK_REPEATS; i++)
+	{
+		auto start = BenchmarkClock::now();
+		func();
+		double ns = Nanoseconds(BenchmarkClock::now() - start).count() / bindCount;
+
+		if (i == 0 || ns < best)
+			best = ns;
+	}
+
+	return best;
+}
+
+int RunBindBenchmark(const std::vector<std::string>& args)
+{
+	uint32_t bindCount = args.size() > 1 ? std::max(2u, (uint32_t)std::stoul(args[1])) : 1000000;
+
+	// the geometry pass binds per item and switches between its static and skinned pipelines
+	auto vertexShader = std::make_shared<ShaderAsset>("Assets/Shader/Deferred/GBufferVertexShader.glsl", json::object());
+	auto fragmentShader = std::make_shared<ShaderAsset>("Assets/Shader/Deferred/GBufferFragmentShader.glsl", json::object());
+	if (vertexShader->GetContent().empty() || fragmentShader->GetContent().empty())
+	{
+		HY_APP_WARN("GBuffer shaders not found, run from the editor folder so the spec hash path hashes real sources");
+	}
+
+	PipelineSpec staticSpec = {};
+	staticSpec.VertexBufferLayout = { {VertexElementType::Float3}, {VertexElementType::Float2}, {VertexElementType::Float3}, {VertexElementType::Float3} };
+	staticSpec.PushConstants = { { 128, (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Vertex) } };
+	staticSpec.CullMode = ShaderCullMode::Back;
+	staticSpec.ColorBlending = std::vector<BlendMode>(4, BlendMode::None);
+	staticSpec.DepthSpec = { .DepthTest = true, .DepthWrite = true, .Operator = DepthTestOp::Less };
+
+	PipelineSpec skinnedSpec = staticSpec;
+	skinnedSpec.VertexBufferLayout = { {VertexElementType::Float3}, {VertexElementType::Float2}, {VertexElementType::Float3},
+									{VertexElementType::Float3}, {VertexElementType::Int4}, {VertexElementType::Float4} };
+
+	// only hashed and compared, never handed to Vulkan
+	VkRenderPass renderPass = (VkRenderPass)(uintptr_t)0x10;
+	std::vector<VkDescriptorSetLayout> layouts = { (VkDescriptorSetLayout)(uintptr_t)0x20, (VkDescriptorSetLayout)(uintptr_t)0x30 };
+
+	// registration is what RenderGraph::RegisterPipeline does during setup, it never touches the device
+	RgPipelineLibrary library(nullptr);
+	RgPipelineHandle pipelines[2];
+	const PipelineSpec* specs[2] = { &staticSpec, &skinnedSpec };
+	for (uint32_t i = 0; i < 2; i++)
+	{
+		RgPipelineDesc desc{};
+		desc.VertexShader = vertexShader;
+		desc.FragmentShader = fragmentShader;
+		desc.Spec = *specs[i];
+		desc.Hash = specs[i]->Hash();
+		HashCombine(desc.Hash, vertexShader->GetContentHash());
+		HashCombine(desc.Hash, fragmentShader->GetContentHash());
+
+		pipelines[i] = library.Register(desc);
+	}
+
+	SpecHashBinder specBinder(renderPass, layouts);
+	HandleBinder handleBinder(renderPass, layouts);
+
+	// every bind switches the pipeline, so the handle path cannot skip any of them
+	double specSwitchNs = MeasureBest(bindCount, [&]()
+		{
+			for (uint32_t i = 0; i < bindCount; i++)
+				specBinder.BindPipeline(vertexShader, fragmentShader, *specs[i & 1]);
+		});
+
+	double handleSwitchNs = MeasureBest(bindCount, [&]()
+		{
+			for (uint32_t i = 0; i < bindCount; i++)
+				handleBinder.BindPipeline(pipelines[i & 1]);
+		});
+
+	// a run of items sharing one pipeline, the handle path skips the redundant binds
+	double specRepeatNs = MeasureBest(bindCount, [&]()
+		{
+			for (uint32_t i = 0; i < bindCount; i++)
+				specBinder.BindPipeline(vertexShader, fragmentShader, staticSpec);
+		});
+
+	double handleRepeatNs = MeasureBest(bindCount, [&]()
+		{
+			for (uint32_t i = 0; i < bindCount; i++)
+				handleBinder.BindPipeline(pipelines[0]);
+		});
+
+	// both have to end up on the static pipeline, the first one each of them created
+	bool matching = specBinder.GetBoundPipeline() && handleBinder.GetBoundPipeline()
+		&& specBinder.GetBoundPipeline()->Id == 0 && handleBinder.GetBoundPipeline()->Id == pipelines[0].Id;
+
+	HY_APP_INFO("[{}] Switching binds: spec hash {:.1f} ns, handle {:.1f} ns per bind ({:.1f}x)",
+		bindCount, specSwitchNs, handleSwitchNs, handleSwitchNs > 0.0 ? specSwitchNs / handleSwitchNs : 0.0);
+	HY_APP_INFO("[{}] Repeated binds: spec hash {:.1f} ns, handle {:.1f} ns per bind ({:.1f}x)",
+		bindCount, specRepeatNs, handleRepeatNs, handleRepeatNs > 0.0 ? specRepeatNs / handleRepeatNs : 0.0);
+	HY_APP_INFO("Hashed {} + {} bytes of shader source per spec hash bind", vertexShader->GetContent().size(), fragmentShader->GetContent().size());
+	HY_APP_INFO("Checksum {}", specBinder.GetFetched());
+
+	return matching ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#include "CameraPath.hpp"
+
+#include <glm/gtc/constants.hpp>
+#include <fstream>
+
+using namespace Hydrogen;
+
+static glm::vec3 CatmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t)
+{
+	float t2 = t * t;
+	float t3 = t2 * t;
+
+	return 0.5f * ((2.0f * p1) +
+		(-p0 + p2) * t +
+		(2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+		(-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
+}
+
+static glm::vec3 ReadVec3(const json& value)
+{
+	return { value.at(0).get<float>(), value.at(1).get<float>(), value.at(2).get<float>() };
+}
+
+bool CameraPath::Load(const std::filesystem::path& path, CameraPath& outPath)
+{
+	std::ifstream fin(path);
+	if (!fin.is_open())
+	{
+		HY_APP_ERROR("Failed to open camera path '{}'", path.string());
+		return false;
+	}
+
+	json data = json::parse(fin, nullptr, false);
+	if (data.is_discarded() || !data.contains("keys"))
+	{
+		HY_APP_ERROR("Camera path '{}' is not valid", path.string());
+		return false;
+	}
+
+	std::vector<CameraPathKey> keys;
+	for (const auto& key : data["keys"])
+	{
+		keys.push_back({ ReadVec3(key.at("position")), ReadVec3(key.at("target")) });
+	}
+
+	if (keys.size() < 2)
+	{
+		HY_APP_ERROR("Camera path '{}' needs at least two keys", path.string());
+		return false;
+	}
+
+	outPath = CameraPath(std::move(keys), data.value("loop", false));
+	return true;
+}
+
+CameraPath CameraPath::CreateOrbit(const glm::vec3& center, float radius, float height, uint32_t keyCount)
+{
+	std::vector<CameraPathKey> keys;
+	for (uint32_t i = 0; i < keyCount; i++)
+	{
+		float angle = glm::two_pi<float>() * (float)i / (float)keyCount;
+		glm::vec3 position = center + glm::vec3(glm::cos(angle) * radius, height, glm::sin(angle) * radius);
+		keys.push_back({ position, center });
+	}
+
+	return CameraPath(std::move(keys), true);
+}
+
+void CameraPath::Evaluate(float t, glm::vec3& outPosition, glm::quat& outRotation) const
+{
+	HY_ASSERT(!m_Keys.empty(), "Evaluating an empty camera path");
+
+	int64_t segmentCount = m_Loop ? (int64_t)m_Keys.size() : (int64_t)m_Keys.size() - 1;
+	float scaled = glm::clamp(t, 0.0f, 1.0f) * (float)segmentCount;
+	int64_t segment = std::min((int64_t)scaled, segmentCount - 1);
+	float local = scaled - (float)segment;
+
+	const auto& k0 = GetKey(segment - 1);
+	const auto& k1 = GetKey(segment);
+	const auto& k2 = GetKey(segment + 1);
+	const auto& k3 = GetKey(segment + 2);
+
+	outPosition = CatmullRom(k0.Position, k1.Position, k2.Position, k3.Position, local);
+	glm::vec3 target = CatmullRom(k0.Target, k1.Target, k2.Target, k3.Target, local);
+
+	glm::vec3 forward = target - outPosition;
+	if (glm::length(forward) < 1e-5f)
+	{
+		forward = glm::vec3(0.0f, 0.0f, -1.0f);
+	}
+	outRotation = glm::quatLookAt(glm::normalize(forward), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+const CameraPathKey& CameraPath::GetKey(int64_t index) const
+{
+	int64_t count = (int64_t)m_Keys.size();
+	if (m_Loop)
+	{
+		return m_Keys[((index % count) + count) % count];
+	}
+
+	return m_Keys[std::clamp<int64_t>(index, 0, count - 1)];
+}
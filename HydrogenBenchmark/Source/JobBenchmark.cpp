@@ -0,0 +1,155 @@
+#include "JobBenchmark.hpp"
+
+#include <Hydrogen/Hydrogen.hpp>
+#include <Hydrogen/JobSystem.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+
+using namespace Hydrogen;
+
+using BenchmarkClock = std::chrono::high_resolution_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+#define JOB_BENCHMARK_EMPTY_JOBS 200000
+#define JOB_BENCHMARK_CHAIN_LENGTH 10000
+#define JOB_BENCHMARK_PARALLEL_ITEMS (1u << 22)
+#define JOB_BENCHMARK_REPEATS 5
+
+// best of a few runs, the first one also pays for waking the workers
+template<typename Func>
+static double MeasureBest(Func&& func)
+{
+	double best = 0.0;
+	for (uint32_t i = 0; i < JOB_BENCHMARK_REPEATS; i++)
+	{
+		auto start = BenchmarkClock::now();
+		func();
+		double ms = Milliseconds(BenchmarkClock::now() - start).count();
+
+		if (i == 0 || ms < best)
+			best = ms;
+	}
+
+	return best;
+}
+
+static double MeasureEmptyJobs(JobSystem& jobs)
+{
+	return MeasureBest([&]()
+		{
+			JobCounter counter;
+			for (uint32_t i = 0; i < JOB_BENCHMARK_EMPTY_JOBS; i++)
+			{
+				jobs.Submit([]() {}, &counter);
+			}
+			jobs.Wait(counter);
+		});
+}
+
+static double MeasureContinuationChain(JobSystem& jobs)
+{
+	return MeasureBest([&]()
+		{
+			// every job only becomes runnable once the previous one finished
+			auto counters = std::make_unique<JobCounter[]>(JOB_BENCHMARK_CHAIN_LENGTH);
+
+			jobs.Submit([]() {}, &counters[0]);
+			for (uint32_t i = 1; i < JOB_BENCHMARK_CHAIN_LENGTH; i++)
+			{
+				jobs.SubmitAfter(counters[i - 1], []() {}, &counters[i]);
+			}
+
+			jobs.Wait(counters[JOB_BENCHMARK_CHAIN_LENGTH - 1]);
+		});
+}
+
+static double MeasureParallelFor(JobSystem& jobs, std::vector<float>& output)
+{
+	return MeasureBest([&]()
+		{
+			jobs.ParallelFor((uint32_t)output.size(), 1024, [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; i++)
+					{
+						float x = (float)i * 0.001f;
+						output[i] = std::sin(x) * std::cos(x * 0.5f) + std::sqrt(x);
+					}
+				});
+		});
+}
+
+int RunJobBenchmark(const std::vector<std::string>& args)
+{
+	uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::string reportFile;
+
+	for (size_t i = 1; i < args.size(); i++)
+	{
+		bool hasValue = i + 1 < args.size();
+		if (args[i] == "--max-threads" && hasValue)
+			maxThreads = std::max(1u, (uint32_t)std::stoul(args[++i]));
+		else if (args[i] == "--out" && hasValue)
+			reportFile = args[++i];
+		else
+			HY_APP_WARN("Ignoring unknown command line argument '{}'", args[i]);
+	}
+
+	maxThreads = std::min(maxThreads, (uint32_t)MAX_JOB_THREADS);
+
+	// powers of two up to the limit, plus the limit itself when it is none
+	std::vector<uint32_t> threadCounts;
+	for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+	{
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	std::vector<float> output(JOB_BENCHMARK_PARALLEL_ITEMS);
+	double singleThreadMs = 0.0;
+	json report = json::array();
+
+	for (uint32_t threads : threadCounts)
+	{
+		JobSystem jobs(threads - 1);
+
+		double emptyMs = MeasureEmptyJobs(jobs);
+		double chainMs = MeasureContinuationChain(jobs);
+		double parallelMs = MeasureParallelFor(jobs, output);
+
+		if (threads == 1)
+			singleThreadMs = parallelMs;
+
+		double speedup = parallelMs > 0.0 ? singleThreadMs / parallelMs : 0.0;
+		double emptyNs = emptyMs * 1e6 / JOB_BENCHMARK_EMPTY_JOBS;
+		double chainNs = chainMs * 1e6 / JOB_BENCHMARK_CHAIN_LENGTH;
+
+		HY_APP_INFO("{:>2} threads | {:8.1f} ns per empty job | {:8.1f} ns per continuation | parallel for {:8.2f} ms ({:.2f}x, {:.0f}% efficiency)",
+			threads, emptyNs, chainNs, parallelMs, speedup, 100.0 * speedup / threads);
+
+		report.push_back({
+			{ "threads", threads },
+			{ "empty_job_ns", emptyNs },
+			{ "continuation_ns", chainNs },
+			{ "parallel_for_ms", parallelMs },
+			{ "speedup", speedup }
+		});
+	}
+
+	if (!reportFile.empty())
+	{
+		std::ofstream file(reportFile);
+		if (!file)
+		{
+			HY_APP_ERROR("Failed to write job benchmark report '{}'", reportFile);
+			return 1;
+		}
+
+		file << report.dump(4);
+		HY_APP_INFO("Wrote job benchmark report to '{}'", reportFile);
+	}
+
+	return 0;
+}
@@ -0,0 +1,36 @@
+-- premake5.lua
+
+project "HydrogenBenchmark"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir)
+	objdir ("%{wks.location}/bin-int/" .. outputdir)
+
+	-- benchmark scenes live next to the editor assets
+	debugdir "%{wks.location}/HydrogenEditor"
+
+	includedirs { "%{wks.location}/HydrogenEngine/Include", "%{wks.location}/Extern/spdlog/include", "%{wks.location}/Extern/glm", "%{wks.location}/Extern/imgui-docking",
+	"%{wks.location}/Extern/sol2/include", "%{wks.location}/Extern/bin/lua", "$(VULKAN_SDK)/Include",
+	"%{wks.location}/Extern/json/single_include/nlohmann", "%{wks.location}/Extern/entt/single_include", "%{wks.location}/Extern/bin/reactphysics3d/include", "Include" }
+
+	links { "HydrogenEngine" }
+
+	files { "Include/**.h", "Include/**.hpp", "Source/**.cpp" }
+
+	filter "system:linux"
+		links { "vulkan", "pthread" }
+
+	filter "configurations:Debug"
+		defines { "HY_DEBUG" }
+		optimize "Off"
+		symbols "On"
+
+	filter "configurations:Release"
+		defines { "HY_NDEBUG", "NDEBUG" }
+		optimize "On"
+		symbols "On"
+
+	filter "action:vs*"
+		buildoptions { "/utf-8" }
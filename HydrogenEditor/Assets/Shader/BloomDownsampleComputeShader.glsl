@@ -0,0 +1,76 @@
+#version 450
+
+// 13 tap downsample from "Next Generation Post Processing in Call of Duty: Advanced Warfare"
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0, set = 1) uniform sampler2D sourceTexture;
+layout(binding = 1, set = 1, rgba16f) uniform writeonly image2D targetImage;
+
+layout(push_constant) uniform BloomParams
+{
+    vec2 sourceTexelSize;
+    int karisAverage;
+    float scale;
+} params;
+
+float KarisWeight(vec3 color)
+{
+    float luma = dot(color, vec3(0.2126, 0.7152, 0.0722));
+    return 1.0 / (1.0 + luma);
+}
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 targetSize = imageSize(targetImage);
+    if (texel.x >= targetSize.x || texel.y >= targetSize.y)
+    {
+        return;
+    }
+
+    vec2 uv = (vec2(texel) + 0.5) / vec2(targetSize);
+    vec2 t = params.sourceTexelSize;
+
+    vec3 a = texture(sourceTexture, uv + t * vec2(-2.0,  2.0)).rgb;
+    vec3 b = texture(sourceTexture, uv + t * vec2( 0.0,  2.0)).rgb;
+    vec3 c = texture(sourceTexture, uv + t * vec2( 2.0,  2.0)).rgb;
+    vec3 d = texture(sourceTexture, uv + t * vec2(-2.0,  0.0)).rgb;
+    vec3 e = texture(sourceTexture, uv).rgb;
+    vec3 f = texture(sourceTexture, uv + t * vec2( 2.0,  0.0)).rgb;
+    vec3 g = texture(sourceTexture, uv + t * vec2(-2.0, -2.0)).rgb;
+    vec3 h = texture(sourceTexture, uv + t * vec2( 0.0, -2.0)).rgb;
+    vec3 i = texture(sourceTexture, uv + t * vec2( 2.0, -2.0)).rgb;
+    vec3 j = texture(sourceTexture, uv + t * vec2(-1.0,  1.0)).rgb;
+    vec3 k = texture(sourceTexture, uv + t * vec2( 1.0,  1.0)).rgb;
+    vec3 l = texture(sourceTexture, uv + t * vec2(-1.0, -1.0)).rgb;
+    vec3 m = texture(sourceTexture, uv + t * vec2( 1.0, -1.0)).rgb;
+
+    vec3 result;
+    if (params.karisAverage != 0)
+    {
+        // weighting each box by its luma keeps single bright pixels from flickering through the chain
+        vec3 center = (j + k + l + m) * 0.25;
+        vec3 topLeft = (a + b + d + e) * 0.25;
+        vec3 topRight = (b + c + e + f) * 0.25;
+        vec3 bottomLeft = (d + e + g + h) * 0.25;
+        vec3 bottomRight = (e + f + h + i) * 0.25;
+
+        float wCenter = 0.5 * KarisWeight(center);
+        float wTopLeft = 0.125 * KarisWeight(topLeft);
+        float wTopRight = 0.125 * KarisWeight(topRight);
+        float wBottomLeft = 0.125 * KarisWeight(bottomLeft);
+        float wBottomRight = 0.125 * KarisWeight(bottomRight);
+
+        result = center * wCenter + topLeft * wTopLeft + topRight * wTopRight + bottomLeft * wBottomLeft + bottomRight * wBottomRight;
+        result /= wCenter + wTopLeft + wTopRight + wBottomLeft + wBottomRight;
+    }
+    else
+    {
+        result = e * 0.125;
+        result += (a + c + g + i) * 0.03125;
+        result += (b + d + f + h) * 0.0625;
+        result += (j + k + l + m) * 0.125;
+    }
+
+    imageStore(targetImage, texel, vec4(result * params.scale, 1.0));
+}
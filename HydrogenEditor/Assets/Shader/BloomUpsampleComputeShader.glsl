@@ -0,0 +1,43 @@
+#version 450
+
+// 3x3 tent filter on the smaller mip, added onto the downsampled mip of the same size as the target
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0, set = 1) uniform sampler2D sourceTexture;
+layout(binding = 1, set = 1) uniform sampler2D downsampledTexture;
+layout(binding = 2, set = 1, rgba16f) uniform writeonly image2D targetImage;
+
+layout(push_constant) uniform BloomParams
+{
+    vec2 sourceTexelSize;
+    int karisAverage;
+    float scale;
+} params;
+
+void main()
+{
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 targetSize = imageSize(targetImage);
+    if (texel.x >= targetSize.x || texel.y >= targetSize.y)
+    {
+        return;
+    }
+
+    vec2 uv = (vec2(texel) + 0.5) / vec2(targetSize);
+    vec2 t = params.sourceTexelSize;
+
+    vec3 result = texture(sourceTexture, uv).rgb * 4.0;
+    result += texture(sourceTexture, uv + t * vec2( 0.0,  1.0)).rgb * 2.0;
+    result += texture(sourceTexture, uv + t * vec2(-1.0,  0.0)).rgb * 2.0;
+    result += texture(sourceTexture, uv + t * vec2( 1.0,  0.0)).rgb * 2.0;
+    result += texture(sourceTexture, uv + t * vec2( 0.0, -1.0)).rgb * 2.0;
+    result += texture(sourceTexture, uv + t * vec2(-1.0,  1.0)).rgb;
+    result += texture(sourceTexture, uv + t * vec2( 1.0,  1.0)).rgb;
+    result += texture(sourceTexture, uv + t * vec2(-1.0, -1.0)).rgb;
+    result += texture(sourceTexture, uv + t * vec2( 1.0, -1.0)).rgb;
+    result /= 16.0;
+
+    result += texelFetch(downsampledTexture, texel, 0).rgb;
+
+    imageStore(targetImage, texel, vec4(result * params.scale, 1.0));
+}
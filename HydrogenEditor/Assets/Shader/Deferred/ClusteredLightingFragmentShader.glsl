@@ -0,0 +1,138 @@
+#version 450
+
+#extension GL_KHR_vulkan_glsl : enable
+
+#include "PBR.glslh"
+#include "Clusters.glslh"
+#include "GBufferEncoding.glslh"
+#include "Shadows.glslh"
+
+#ifdef COMPACT_GBUFFER
+layout(binding = 0, set = 1) uniform sampler2D gDepth;
+layout(binding = 1, set = 1) uniform sampler2D gNormal;
+layout(binding = 2, set = 1) uniform sampler2D gAlbedo;
+layout(binding = 3, set = 1) uniform sampler2D gMaterial;
+layout(binding = 4, set = 1) uniform sampler2D gEmissive;
+#else
+layout(binding = 0, set = 1) uniform sampler2D gPosition;
+layout(binding = 1, set = 1) uniform sampler2D gNormal;
+layout(binding = 2, set = 1) uniform sampler2D gAlbedoRough;
+layout(binding = 3, set = 1) uniform sampler2D gMaterial;
+layout(binding = 4, set = 1) uniform sampler2D gEmissive;
+#endif
+
+struct DirectionalLight
+{
+    vec4 color; // a = intensity
+    vec4 direction; // w = casts shadows
+};
+
+layout(std430, binding = 5, set = 1) readonly buffer DirectionalLights
+{
+    DirectionalLight directionalLights[];
+};
+
+layout(std430, binding = 6, set = 1) readonly buffer ClusterLightCounts
+{
+    uint clusterLightCounts[];
+};
+
+layout(std430, binding = 7, set = 1) readonly buffer ClusterLightIndices
+{
+    uint clusterLightIndices[];
+};
+
+layout(binding = 0, set = 0) uniform UniformBufferObject
+{
+    mat4 view;
+    mat4 proj;
+    vec3 viewPos;
+    float pad;
+    mat4 inverseViewProj;
+} ubo;
+
+layout(location = 0) in vec2 inUV;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec4 outBright;
+
+void main()
+{
+#ifdef COMPACT_GBUFFER
+    vec3 fragPos = ReconstructWorldPosition(inUV, texture(gDepth, inUV).r, ubo.inverseViewProj);
+    vec3 N = DecodeNormal(texture(gNormal, inUV).rg);
+    vec3 albedo = texture(gAlbedo, inUV).rgb;
+
+    vec4 material = texture(gMaterial, inUV);
+    float roughness = material.r;
+    float metallic = material.g;
+    float ao = material.b;
+
+    vec3 emissive = texture(gEmissive, inUV).rgb;
+#else
+    vec3 fragPos = texture(gPosition, inUV).rgb;
+    vec3 N = normalize(texture(gNormal, inUV).rgb);
+
+    vec4 albedoRough = texture(gAlbedoRough, inUV);
+    vec3 albedo = albedoRough.rgb;
+    float roughness = albedoRough.a;
+
+    vec4 material = texture(gMaterial, inUV);
+    float metallic = material.r;
+    float ao = material.g;
+
+    vec4 emissiveSample = texture(gEmissive, inUV);
+    vec3 emissive = emissiveSample.rgb * emissiveSample.a;
+#endif
+
+    vec3 V = normalize(ubo.viewPos - fragPos);
+
+    float viewDepth = -(ubo.view * vec4(fragPos, 1.0)).z;
+
+    vec3 lighting = vec3(0.0);
+    for (uint i = 0; i < directionalLights.length(); ++i)
+    {
+        vec3 L = normalize(-directionalLights[i].direction.xyz);
+        vec3 radiance = directionalLights[i].color.rgb * directionalLights[i].color.a;
+
+        if (directionalLights[i].direction.w > 0.5)
+        {
+            radiance *= SampleDirectionalShadow(fragPos, N, L, viewDepth);
+        }
+
+        lighting += EvaluateBRDF(N, V, L, radiance, albedo, roughness, metallic);
+    }
+
+    uint clusterIndex = GetClusterIndex(GetCluster(gl_FragCoord.xy, viewDepth));
+    uint lightCount = clusterLightCounts[clusterIndex];
+
+    for (uint i = 0; i < lightCount; ++i)
+    {
+        PointLight light = pointLights[clusterLightIndices[clusterIndex * MAX_LIGHTS_PER_CLUSTER + i]];
+
+        vec3 L = light.positionRadius.xyz - fragPos;
+        float dist = length(L);
+        float radius = light.positionRadius.w;
+
+        if (dist > radius)
+        {
+            continue;
+        }
+
+        float atten = pow(clamp(1.0 - (dist * dist) / (radius * radius), 0.0, 1.0), 2.0);
+        vec3 radiance = light.colorIntensity.rgb * atten * light.colorIntensity.a;
+
+        lighting += EvaluateBRDF(N, V, normalize(L), radiance, albedo, roughness, metallic);
+    }
+
+    vec3 ambient = vec3(0.03) * albedo * ao;
+    vec3 finalColor = lighting + ambient + emissive;
+
+    outColor = vec4(finalColor, 1.0);
+
+    float brightness = dot(outColor.rgb, vec3(0.2126, 0.7152, 0.0722));
+    if(brightness > 1.0)
+        outBright = vec4(outColor.rgb, 1.0);
+    else
+        outBright = vec4(0.0, 0.0, 0.0, 1.0);
+}
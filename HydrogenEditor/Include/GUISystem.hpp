@@ -27,6 +27,11 @@ struct EntitySelectedEvent
 	uint64_t SelectedEntityUUID;
 };
 
+struct GpuTimingsEvent
+{
+	Hydrogen::RgGpuFrameTimings Timings;
+};
+
 struct HardwareChangeEvent
 {
 	bool RenderDeviceChanged = false;
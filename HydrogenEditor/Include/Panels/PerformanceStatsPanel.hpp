@@ -11,14 +11,23 @@ public:
 	virtual std::string GetTitle() const override { static std::string t = "Performance Statistics"; return t; }
 	virtual DockDirection GetDefaultDockDirection() const override { return DockDirection::Right_Bottom; }
 
+	virtual void OnAttach() override;
 	virtual void OnUpdate(float dt) override;
 	virtual void OnImGuiRender() override;
 
 private:
+	void OnGpuTimings(const Hydrogen::RgGpuFrameTimings& timings);
+	void DrawGpuTimings();
+
 	float m_FPSTimer = 0.0f;
 	float m_CurrentAvgFPS = 0.0f;
 	float m_CurrentMinFPS = 0.0f;
 
 	std::vector<float> m_FrameTimes;
 	const size_t m_MaxSamples = 100;
+
+	// rolling GPU timings of the scene viewport in milliseconds, keyed by pass name
+	std::vector<float> m_GpuFrameTimes;
+	std::unordered_map<std::string, std::vector<float>> m_GpuPassTimes;
+	std::vector<std::string> m_GpuPassOrder;
 };
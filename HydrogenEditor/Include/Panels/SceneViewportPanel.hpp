@@ -29,6 +29,7 @@ private:
 
 	std::unique_ptr<Hydrogen::Renderer> m_Renderer;
 	Hydrogen::FreeCamera m_FreeCam;
+	uint64_t m_LastGpuTimingsFrame = UINT64_MAX;
 
 	Hydrogen::Scene* m_Scene;
 	uint64_t m_SelectedEntityUUID;
@@ -76,6 +76,13 @@ public:
 			if (ImGui::BeginMenu("File"))
 			{
 				if (ImGui::MenuItem("Save Scene")) CurrentScene->Save();
+
+				// cells and manifest go next to the scene, the runtime streams them with --world
+				if (ImGui::MenuItem("Build World Partition"))
+				{
+					std::filesystem::path manifest = std::filesystem::path(CurrentScene->GetPath()).replace_extension(".hyworld");
+					WorldPartition::Build(*CurrentScene->GetScene(), manifest.string(), 64.0f);
+				}
 				ImGui::EndMenu();
 			}
 			if (ImGui::BeginMenu("Game"))
@@ -157,25 +164,24 @@ public:
 private:
 	void ToggleSimulation()
 	{
+		// both directions copy through Scene::Clone, the played scene gets fresh bodies and script instances
 		if (m_IsSimulating)
 		{
 			CurrentScene->GetScene()->ResetPhysics();
 			CurrentScene->ClearScene();
-			CurrentScene->GetScene()->DeserializeScene(SavedScene->SerializeScene());
+			SavedScene->Clone(*CurrentScene->GetScene());
 			m_IsSimulating = false;
 			CurrentScene->GetScene()->IndexScripts();
 		}
 		else
 		{
-			json j = CurrentScene->GetScene()->SerializeScene();
-
 			if (SavedScene) SavedScene->ResetPhysics();
 			SavedScene = std::make_shared<Scene>();
-			SavedScene->DeserializeScene(j);
+			CurrentScene->GetScene()->Clone(*SavedScene);
 
 			CurrentScene->GetScene()->ResetPhysics();
 			CurrentScene->ClearScene();
-			CurrentScene->GetScene()->DeserializeScene(j);
+			SavedScene->Clone(*CurrentScene->GetScene());
 
 			m_IsSimulating = true;
 			ResetPhysicsAccumulator();
@@ -401,6 +401,9 @@ void AssetBrowserPanel::OnImGuiRender()
 			if (ImGui::MenuItem("Scene (.hyscene)"))
 				CreateAndRenameAsset("NewScene.hyscene", "{}");
 
+			if (ImGui::MenuItem("Prefab (.hyprefab)"))
+				CreateAndRenameAsset("NewPrefab.hyprefab", "{}");
+
 			if (ImGui::MenuItem("GLSL Shader (.glsl)"))
 				CreateAndRenameAsset("NewShader.glsl", "// Hydrogen Shader\n#version 450\n\nvoid main()\n{\n}\n");
 
@@ -121,12 +121,73 @@ void GraphicsSettingsPanel::OnImGuiRender()
 
 	ImGui::TextDisabled("RENDERING SETTINGS");
 	ImGui::Checkbox("Wireframe Mode", &m_RenderSettings.Debug.WireframeMode);
+	ImGui::Checkbox("Compact G-Buffer", &m_RenderSettings.Rendering.CompactGBuffer);
 	ImGui::Checkbox("Tone Mapping", &m_RenderSettings.PostProcessing.ToneMapping);
 	ImGui::Checkbox("Bloom", &m_RenderSettings.PostProcessing.BloomEnabled);
 
-	int bloomIterations = (int)m_RenderSettings.PostProcessing.BloomIterations;
-	if (ImGui::InputInt("Bloom Iterations", &bloomIterations))
-		m_RenderSettings.PostProcessing.BloomIterations = (uint8_t)bloomIterations;
+	int bloomMipCount = (int)m_RenderSettings.PostProcessing.BloomMipCount;
+	if (ImGui::SliderInt("Bloom Mips", &bloomMipCount, 1, MAX_BLOOM_MIPS))
+		m_RenderSettings.PostProcessing.BloomMipCount = (uint8_t)bloomMipCount;
+
+	ImGui::Spacing();
+	ImGui::Separator();
+	ImGui::Spacing();
+
+	ImGui::TextDisabled("ANTI-ALIASING");
+	auto& temporal = m_RenderSettings.Temporal;
+	ImGui::Checkbox("Temporal Anti-Aliasing", &temporal.Enabled);
+
+	float renderScalePercent = m_RenderSettings.Display.RenderScale * 100.0f;
+	if (ImGui::SliderFloat("Render Scale", &renderScalePercent, 25.0f, 100.0f, "%.0f%%"))
+		m_RenderSettings.Display.RenderScale = renderScalePercent / 100.0f;
+
+	if (temporal.Enabled)
+	{
+		ImGui::SliderFloat("Feedback Min", &temporal.FeedbackMin, 0.0f, temporal.FeedbackMax);
+		ImGui::SliderFloat("Feedback Max", &temporal.FeedbackMax, temporal.FeedbackMin, 0.99f);
+	}
+
+	ImGui::Spacing();
+	ImGui::Separator();
+	ImGui::Spacing();
+
+	ImGui::TextDisabled("SHADOWS");
+	auto& shadows = m_RenderSettings.Shadows;
+	ImGui::Checkbox("Directional Shadows", &shadows.Enabled);
+
+	int cascadeCount = (int)shadows.CascadeCount;
+	if (ImGui::SliderInt("Cascades", &cascadeCount, 1, MAX_SHADOW_CASCADES))
+		shadows.CascadeCount = (uint32_t)cascadeCount;
+
+	const uint32_t resolutions[] = { 512, 1024, 2048, 4096 };
+	const char* resolutionLabels[] = { "512", "1024", "2048", "4096" };
+	int currentResolution = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (resolutions[i] == shadows.Resolution)
+			currentResolution = i;
+	}
+
+	if (ImGui::Combo("Resolution", &currentResolution, resolutionLabels, 4))
+		shadows.Resolution = resolutions[currentResolution];
+
+	const char* splitSchemeLabels[] = { "Uniform", "Logarithmic", "Practical" };
+	int currentSplitScheme = static_cast<int>(shadows.SplitScheme);
+	if (ImGui::Combo("Split Scheme", &currentSplitScheme, splitSchemeLabels, 3))
+		shadows.SplitScheme = static_cast<ShadowSplitScheme>(currentSplitScheme);
+
+	if (shadows.SplitScheme == ShadowSplitScheme::Practical)
+		ImGui::SliderFloat("Split Lambda", &shadows.SplitLambda, 0.0f, 1.0f);
+
+	ImGui::DragFloat("Shadow Distance", &shadows.MaxDistance, 1.0f, 1.0f, 1000.0f);
+
+	ImGui::Checkbox("Cache Static Casters", &shadows.CacheStaticCasters);
+	if (shadows.CacheStaticCasters)
+	{
+		int firstCachedCascade = (int)shadows.FirstCachedCascade;
+		if (ImGui::SliderInt("First Cached Cascade", &firstCachedCascade, 0, MAX_SHADOW_CASCADES - 1))
+			shadows.FirstCachedCascade = (uint32_t)firstCachedCascade;
+	}
 
 	if (Event.RenderDeviceChanged || Event.SwapChainChanged)
 	{
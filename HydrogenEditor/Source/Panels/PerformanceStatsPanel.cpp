@@ -3,6 +3,80 @@
 
 using namespace Hydrogen;
 
+static void PushSample(std::vector<float>& samples, float value, size_t maxSamples)
+{
+	samples.push_back(value);
+	if (samples.size() > maxSamples) samples.erase(samples.begin());
+}
+
+void PerformanceStatsPanel::OnAttach()
+{
+	Dockspace->GetEventBus().Subscribe<GpuTimingsEvent>([this](const GpuTimingsEvent& e) {
+		OnGpuTimings(e.Timings);
+		});
+}
+
+void PerformanceStatsPanel::OnGpuTimings(const RgGpuFrameTimings& timings)
+{
+	PushSample(m_GpuFrameTimes, static_cast<float>(timings.TotalMs), m_MaxSamples);
+
+	m_GpuPassOrder.clear();
+	for (const auto& pass : timings.Passes)
+	{
+		PushSample(m_GpuPassTimes[pass.Name], static_cast<float>(pass.Ms), m_MaxSamples);
+		m_GpuPassOrder.push_back(pass.Name);
+	}
+}
+
+void PerformanceStatsPanel::DrawGpuTimings()
+{
+	ImGui::Separator();
+	ImGui::Text("GPU Passes (Scene Viewport):");
+
+	if (m_GpuFrameTimes.empty())
+	{
+		ImGui::TextDisabled("  No GPU timings available");
+		return;
+	}
+
+	char overlay[32];
+	snprintf(overlay, sizeof(overlay), "%.2f ms", m_GpuFrameTimes.back());
+	ImGui::PlotLines("##GpuFrameTime", m_GpuFrameTimes.data(), static_cast<int>(m_GpuFrameTimes.size()), 0, overlay, 0.0f, FLT_MAX, ImVec2(-1.0f, 60.0f));
+
+	if (ImGui::BeginTable("GpuPasses", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp))
+	{
+		ImGui::TableSetupColumn("Pass");
+		ImGui::TableSetupColumn("Last (ms)");
+		ImGui::TableSetupColumn("Avg (ms)");
+		ImGui::TableSetupColumn("Max (ms)");
+		ImGui::TableSetupColumn("History");
+		ImGui::TableHeadersRow();
+
+		for (const auto& name : m_GpuPassOrder)
+		{
+			const auto& samples = m_GpuPassTimes[name];
+			float avg = std::accumulate(samples.begin(), samples.end(), 0.0f) / samples.size();
+			float max = *std::max_element(samples.begin(), samples.end());
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", samples.back());
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", avg);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", max);
+			ImGui::TableNextColumn();
+			ImGui::PushID(name.c_str());
+			ImGui::PlotLines("##History", samples.data(), static_cast<int>(samples.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(-1.0f, ImGui::GetTextLineHeight()));
+			ImGui::PopID();
+		}
+
+		ImGui::EndTable();
+	}
+}
+
 void PerformanceStatsPanel::OnUpdate(float dt)
 {
 	m_FrameTimes.push_back(dt);
@@ -39,6 +113,8 @@ void PerformanceStatsPanel::OnImGuiRender()
 	ImGui::Text("  Allocations: %zu", stats.total.statistics.allocationCount);
 	ImGui::Text("  Allocated: %.2f MB", static_cast<double>(stats.total.statistics.allocationBytes) / (1024.0 * 1024.0));
 
+	DrawGpuTimings();
+
 	ImGui::Separator();
 	ImGui::Text("For advanced profiling use Tracy");
 	if (ImGui::Button("Launch Tracy"))
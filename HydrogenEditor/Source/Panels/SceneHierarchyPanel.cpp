@@ -5,21 +5,12 @@ using namespace Hydrogen;
 
 Entity SceneHierarchyPanel::GetSelectedEntity() const
 {
-	Entity selectedEntity;
 	if (!m_Scene)
 	{
-		return selectedEntity;
+		return Entity();
 	}
 
-	m_Scene->IterateComponents<UUIDComponent>([&](Entity entity, const UUIDComponent& uuid)
-		{
-			if (uuid.UUID == m_SelectedEntityUUID)
-			{
-				selectedEntity = entity;
-			}
-		});
-
-	return selectedEntity;
+	return m_Scene->GetEntityByUUID(m_SelectedEntityUUID);
 }
 
 void SceneHierarchyPanel::OnAttach()
@@ -35,32 +26,6 @@ void SceneHierarchyPanel::OnAttach()
 		});
 }
 
-static bool CheckCycle(Hydrogen::Scene* scene, uint64_t entityUUID, uint64_t targetParentUUID)
-{
-	if (entityUUID == targetParentUUID)
-		return true;
-
-	uint64_t currentParentUUID = targetParentUUID;
-
-	while (currentParentUUID != 0)
-	{
-		if (currentParentUUID == entityUUID)
-			return true;
-
-		Hydrogen::Entity parentEntity = scene->GetEntityByUUID(currentParentUUID);
-		if (!parentEntity.IsValid())
-			break;
-
-		auto* rel = parentEntity.TryGetComponent<Hydrogen::RelationshipComponent>();
-		if (!rel)
-			break;
-
-		currentParentUUID = rel->ParentUUID;
-	}
-
-	return false;
-}
-
 void SceneHierarchyPanel::DrawEntityNode(Entity entity)
 {
 	auto& tag = entity.GetComponent<TagComponent>();
@@ -96,12 +61,10 @@ void SceneHierarchyPanel::DrawEntityNode(Entity entity)
 
 			Entity droppedEntity = m_Scene->GetEntityByUUID(droppedEntityUUID);
 
-			if (droppedEntity.IsValid() && droppedEntity.GetUUID() != entity.GetUUID() && !CheckCycle(m_Scene, droppedEntityUUID, entity.GetUUID()))
+			// SetParent refuses drops onto the entity's own descendants
+			if (droppedEntity.IsValid() && droppedEntity != entity)
 			{
-				auto& droppedRel = droppedEntity.GetComponent<RelationshipComponent>();
-				droppedRel.ParentUUID = entity.GetUUID();
-
-				// TODO: If you implement full local-to-world matrix recomputations, trigger them here
+				m_Scene->SetParent(droppedEntity, entity);
 			}
 		}
 		ImGui::EndDragDropTarget();
@@ -109,13 +72,10 @@ void SceneHierarchyPanel::DrawEntityNode(Entity entity)
 
 	if (opened)
 	{
-		m_Scene->IterateComponents<RelationshipComponent>([&](Entity childEntity, const RelationshipComponent& childRel)
-			{
-				if (childRel.ParentUUID == entity.GetUUID())
-				{
-					DrawEntityNode(childEntity);
-				}
-			});
+		for (Entity childEntity : m_Scene->GetChildren(entity))
+		{
+			DrawEntityNode(childEntity);
+		}
 
 		ImGui::TreePop();
 	}
@@ -144,8 +104,7 @@ void SceneHierarchyPanel::DrawSceneHierarchyPanel(Scene* scene)
 
 				if (droppedEntity.IsValid())
 				{
-					auto& droppedRel = droppedEntity.GetComponent<Hydrogen::RelationshipComponent>();
-					droppedRel.ParentUUID = 0;
+					scene->SetParent(droppedEntity, Hydrogen::Entity());
 				}
 			}
 			ImGui::EndDragDropTarget();
@@ -154,7 +113,7 @@ void SceneHierarchyPanel::DrawSceneHierarchyPanel(Scene* scene)
 		scene->IterateComponents<Hydrogen::TagComponent>([&](Hydrogen::Entity entity, const auto& tag)
 			{
 				auto* rel = entity.TryGetComponent<Hydrogen::RelationshipComponent>();
-				bool isRoot = (rel == nullptr || rel->ParentUUID == 0);
+				bool isRoot = (rel == nullptr || rel->Parent == entt::null);
 
 				if (isRoot)
 				{
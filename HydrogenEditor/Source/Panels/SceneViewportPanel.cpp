@@ -88,6 +88,13 @@ void SceneViewportPanel::OnUpdate(float dt)
 		m_RenderedScene = DefaultRenderer::RenderSceneDeferred(
 			m_Renderer.get(), Settings, m_FreeCam, m_FreeCam.GetPosition(), m_Scene
 		).ImageView;
+
+		const RenderGraph* graph = m_Renderer->GetRenderGraph();
+		if (graph->HasGpuTimings() && graph->GetGpuTimings().FrameNumber != m_LastGpuTimingsFrame)
+		{
+			m_LastGpuTimingsFrame = graph->GetGpuTimings().FrameNumber;
+			Dockspace->GetEventBus().Publish<GpuTimingsEvent>({ graph->GetGpuTimings() });
+		}
 	}
 }
 
@@ -133,7 +140,14 @@ void SceneViewportPanel::DrawGizmo()
 		m_ViewportBounds[1].y - m_ViewportBounds[0].y);
 
 	auto& tc = selectedEntity.GetComponent<TransformComponent>();
-	glm::mat4 transform = tc.GetModel();
+
+	// the gizmo works in world space, the result is brought back into the parent's space
+	glm::mat4 parentWorld = glm::mat4(1.0f);
+	Entity parent = m_Scene->GetParent(selectedEntity);
+	if (parent.IsValid())
+		parentWorld = parent.GetComponent<TransformComponent>().GetWorldMatrix();
+
+	glm::mat4 transform = parentWorld * tc.GetModel();
 	glm::mat4 view = m_FreeCam.View;
 	glm::mat4 proj = m_FreeCam.Proj;
 	proj[1][1] *= -1;
@@ -149,7 +163,7 @@ void SceneViewportPanel::DrawGizmo()
 		glm::vec3 skew;
 		glm::vec4 perspective;
 
-		glm::decompose(transform, scale, rotation, translation, skew, perspective);
+		glm::decompose(glm::inverse(parentWorld) * transform, scale, rotation, translation, skew, perspective);
 		tc.SetTranslation(translation);
 		tc.SetRotation(rotation);
 		tc.SetScale(scale);
@@ -41,6 +41,8 @@ namespace Hydrogen
 		void ResetPhysicsAccumulator() { accumulator = 0.0f; }
 
 		RenderDevice* GetRenderDevice() const { return ActiveRenderDevice.get(); }
+		uint64_t GetFrameCount() const { return m_FrameCount; }
+		bool IsHeadless() const { return ApplicationSpec.Headless; }
 
 		virtual void OnSetup() = 0;
 
@@ -63,9 +65,17 @@ namespace Hydrogen
 			glm::vec2 ViewportPos{ 0 };
 
 			bool UseDebugGUI = false;
+
+			std::string StartupScene = "Scene.hyscene";
+
+			// Renders offscreen without a window or swapchain, frames advance with a fixed time step
+			bool Headless = false;
+			// Closes the main viewport after this many frames, 0 runs until it is closed
+			uint64_t FrameLimit = 0;
 		};
 
 		ApplicationSpecification ApplicationSpec;
+		std::vector<std::string> CommandLineArgs;
 		AssetManager MainAssetManager;
 		std::shared_ptr<Viewport> MainViewport;
 		std::shared_ptr<SceneAsset> CurrentScene;
@@ -81,6 +91,8 @@ namespace Hydrogen
 		const float timeStep = 1.0f / 60.0f;
 		float accumulator = 0.0f;
 
+		uint64_t m_FrameCount = 0;
+
 		SwapChainSpec m_CurrentSwapChainSpec;
 
 		static Application* s_Instance;
@@ -18,6 +18,9 @@
 #include <chrono>
 #include <string>
 #include <variant>
+#include <map>
+
+namespace shaderc { class Compiler; }
 
 using json = nlohmann::json;
 
@@ -61,6 +64,14 @@ namespace Hydrogen
 			buffer << fin.rdbuf();
 			m_Content = std::move(buffer.str());
 			fin.close();
+
+			if (m_Config["preferences"].contains("defines"))
+			{
+				for (const auto& [name, value] : m_Config["preferences"]["defines"].items())
+				{
+					m_Defines[name] = value.is_string() ? value.get<std::string>() : value.dump();
+				}
+			}
 		}
 
 		~ShaderAsset() = default;
@@ -82,27 +93,54 @@ namespace Hydrogen
 
 			HY_ASSERT(fin, "Error reading file '{}'", cachePath);
 			fin.close();
+
+			UpdateContentHash();
 		}
 
 		void Cache() override
 		{
 			HY_ENGINE_INFO("Caching version for {}", m_Filepath);
 
-			std::string cachePath = "Caches/" + m_Filepath + ".hycache";
+			std::string cachePath = GetCachePath();
 			std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path());
 
 			std::ofstream fout(cachePath, std::ios::binary);
 			fout.write((char*)m_ByteCode.data(), m_ByteCode.size() * sizeof(uint32_t));
 			fout.close();
+
+			std::ofstream depsOut(cachePath + ".deps");
+			for (const auto& dependency : m_Dependencies)
+			{
+				depsOut << dependency << "\n";
+			}
+			depsOut.close();
 		}
 
 		void Compile();
+		void Compile(shaderc::Compiler& compiler);
+
+		// Cache files are keyed by the define set, so every permutation of a source file has its own
+		std::string GetCachePath() const;
+		bool IsCacheValid() const;
+
 		const std::vector<uint32_t>& GetByteCode() const { return m_ByteCode; }
 
 		std::string GetContent() const { return m_Content; }
+		const std::map<std::string, std::string>& GetDefines() const { return m_Defines; }
+
+		// Hash of the compiled byte code, covers includes and defines
+		size_t GetContentHash() const { return m_ContentHash; }
 
 	private:
+		void UpdateContentHash()
+		{
+			m_ContentHash = std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(m_ByteCode.data()), m_ByteCode.size() * sizeof(uint32_t)));
+		}
+
 		std::string m_Content;
+		std::map<std::string, std::string> m_Defines;
+		std::vector<std::string> m_Dependencies;
+		size_t m_ContentHash = 0;
 		std::vector<uint32_t> m_ByteCode;
 	};
 
@@ -208,6 +246,12 @@ namespace Hydrogen
 	};
 #pragma pack(pop)
 
+	struct MeshBounds
+	{
+		glm::vec3 Min = glm::vec3(0.0f);
+		glm::vec3 Max = glm::vec3(0.0f);
+	};
+
 	class SkeletonAsset : public Asset
 	{
 	public:
@@ -251,6 +295,7 @@ namespace Hydrogen
 		void Cache() override {}
 
 		uint32_t GetIndexCount() const { return static_cast<uint32_t>(m_Indices.size()); }
+		const MeshBounds& GetBounds() const { return m_Bounds; }
 
 		RenderBuffer* GetVertexBuffer();
 		RenderBuffer* GetIndexBuffer();
@@ -261,6 +306,7 @@ namespace Hydrogen
 	private:
 		std::vector<StaticVertex> m_Vertices;
 		std::vector<uint32_t> m_Indices;
+		MeshBounds m_Bounds;
 
 		std::unique_ptr<RenderBuffer> m_VertexBuffer;
 		std::unique_ptr<RenderBuffer> m_IndexBuffer;
@@ -283,6 +329,7 @@ namespace Hydrogen
 		void Cache() override {}
 
 		uint32_t GetIndexCount() const { return static_cast<uint32_t>(m_Indices.size()); }
+		const MeshBounds& GetBounds() const { return m_Bounds; }
 
 		RenderBuffer* GetVertexBuffer();
 		RenderBuffer* GetIndexBuffer();
@@ -293,6 +340,7 @@ namespace Hydrogen
 	private:
 		std::vector<SkinnedVertex> m_Vertices;
 		std::vector<uint32_t> m_Indices;
+		MeshBounds m_Bounds;
 
 		std::unique_ptr<RenderBuffer> m_VertexBuffer;
 		std::unique_ptr<RenderBuffer> m_IndexBuffer;
@@ -361,13 +409,13 @@ namespace Hydrogen
 		SceneAsset(std::string path, json config)
 			: Asset(path, config)
 		{
-			std::ifstream fin(path);
+			std::ifstream fin(path, std::ios::binary);
 			std::stringstream buffer;
 			buffer << fin.rdbuf();
 			m_Content = std::move(buffer.str());
 			fin.close();
 
-			if (m_Content.empty())
+			if (m_Content.empty() && !IsBinary())
 			{
 				m_Content = "{}";
 			}
@@ -385,11 +433,43 @@ namespace Hydrogen
 
 		class Scene* GetScene() { return m_Scene.get(); }
 
+		// .hyscenebin files hold the binary form of a scene, .hyscene files the json one
+		bool IsBinary() const { return std::filesystem::path(m_Filepath).extension() == ".hyscenebin"; }
+
 	private:
 		std::string m_Content;
 		std::shared_ptr<class Scene> m_Scene;
 	};
 
+	// an entity hierarchy in the .hyscene json format, spawned into other scenes through Scene::Instantiate
+	class PrefabAsset : public Asset
+	{
+	public:
+		static constexpr const char* GetStaticName() { return "Prefab"; }
+
+		PrefabAsset(std::string path, json config)
+			: Asset(path, config)
+		{
+			Read();
+		}
+
+		~PrefabAsset() = default;
+
+		void LoadCache(std::string cachePath) override {}
+		void Cache() override {}
+
+		virtual void Reload() override { Read(); }
+
+		// built on first use, in Prefab.cpp
+		const struct PrefabTemplate& GetTemplate();
+
+	private:
+		void Read();
+
+		std::string m_Content;
+		std::shared_ptr<struct PrefabTemplate> m_Template;
+	};
+
 	enum class ParameterType { Float, Int, Bool, Trigger };
 
 	struct AnimParameter
@@ -626,8 +706,11 @@ namespace Hydrogen
 
 	private:
 		void LoadAsset(const std::filesystem::path& path);
+		void LoadShader(const std::string& filePath, const std::string& name, const json& config);
+		void CompilePendingShaders();
 
 		std::string m_Directory;
 		std::unordered_map<std::string, std::shared_ptr<Asset>> m_Assets;
+		std::vector<std::shared_ptr<ShaderAsset>> m_PendingShaders;
 	};
 }
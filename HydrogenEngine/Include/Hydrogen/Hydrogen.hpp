@@ -8,4 +8,6 @@
 #include <Hydrogen/Scene/Scene.hpp>
 #include <Hydrogen/Scene/Physics.hpp>
 #include <Hydrogen/Scene/Camera.hpp>
+#include <Hydrogen/Scene/WorldPartition.hpp>
+#include <Hydrogen/Scene/Prefab.hpp>
 #include "Hydrogen/Input.hpp"
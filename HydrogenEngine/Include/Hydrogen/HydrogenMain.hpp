@@ -4,13 +4,14 @@
 
 extern std::shared_ptr<Hydrogen::Application> GetApplication();
 
-int main()
+int main(int argc, char** argv)
 {
 	Hydrogen::EngineLogger::Init();
 	Hydrogen::AppLogger::Init();
 
 	{
 		auto app = GetApplication();
+		app->CommandLineArgs.assign(argv + 1, argv + argc);
 		app->Run();
 	}
 
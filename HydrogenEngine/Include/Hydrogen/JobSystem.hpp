@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Core.hpp"
+
+#include <entt/entt.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Hydrogen
+{
+	#define MAX_JOB_THREADS 64
+
+	enum class JobAffinity
+	{
+		Any,
+		MainThread // for work that has to stay on the thread owning the queues and the window, like Vulkan submission
+	};
+
+	class JobCounter;
+
+	struct Job
+	{
+		std::function<void()> Func;
+		JobCounter* Counter = nullptr;
+		JobAffinity Affinity = JobAffinity::Any;
+	};
+
+	// counts unfinished jobs, continuations queued on it start once it drops to zero
+	// only destroy a counter after JobSystem::Wait returned for it
+	class JobCounter
+	{
+	public:
+		bool IsDone() const { return m_Count.load() == 0; }
+
+	private:
+		std::atomic<uint32_t> m_Count = 0;
+		std::mutex m_Mutex;
+		std::vector<Job> m_Continuations;
+
+		friend class JobSystem;
+	};
+
+	class JobSystem
+	{
+	public:
+		// the constructing thread becomes the main thread of this job system
+		JobSystem(uint32_t workerCount);
+		~JobSystem();
+
+		// a worker count of zero uses every hardware thread next to the main thread
+		static void Init(uint32_t workerCount = 0);
+		static void Shutdown();
+		static JobSystem& Get();
+
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+		uint32_t GetThreadCount() const { return GetWorkerCount() + 1; }
+
+		// workers report 0 to worker count - 1, every other thread reports the worker count
+		uint32_t GetCurrentThreadIndex() const;
+		bool IsMainThread() const { return std::this_thread::get_id() == m_MainThread; }
+
+		void Submit(std::function<void()> func, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::Any);
+
+		// queues the job without blocking a thread, it starts once dependency finished
+		void SubmitAfter(JobCounter& dependency, std::function<void()> func, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::Any);
+
+		// the waiting thread runs other jobs until the counter reaches zero, on the main thread including main thread jobs
+		void Wait(JobCounter& counter);
+
+		// called by the application every frame, runs the main thread jobs queued so far
+		void RunMainThreadJobs();
+
+		// splits [0, count) into chunks, the calling thread takes part until the whole range is done
+		void ParallelFor(uint32_t count, uint32_t minChunkSize, const std::function<void(uint32_t begin, uint32_t end)>& func);
+
+		template<typename View, typename Func>
+		void ParallelForEach(const View& view, uint32_t minChunkSize, Func&& func)
+		{
+			std::vector<entt::entity> entities(view.begin(), view.end());
+
+			ParallelFor(static_cast<uint32_t>(entities.size()), minChunkSize, [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = begin; i < end; i++)
+					{
+						func(entities[i]);
+					}
+				});
+		}
+
+	private:
+		struct WorkerQueue
+		{
+			std::mutex Mutex;
+			std::deque<Job> Jobs;
+		};
+
+		void Enqueue(Job job);
+		bool TryRunJob();
+		bool PopJob(Job& outJob);
+		void Execute(Job& job);
+		void Signal(JobCounter* counter);
+		void WorkerLoop(uint32_t workerIndex);
+
+		// one deque per worker, owners take from the back and idle threads steal from the front
+		std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+		std::vector<std::thread> m_Workers;
+		std::thread::id m_MainThread;
+
+		std::mutex m_MainThreadMutex;
+		std::deque<Job> m_MainThreadJobs;
+
+		std::mutex m_SleepMutex;
+		std::condition_variable m_WakeCondition;
+		std::atomic<uint32_t> m_QueuedJobs = 0;
+		std::atomic<uint32_t> m_NextQueue = 0;
+		bool m_Stop = false;
+
+		static std::unique_ptr<JobSystem> s_Instance;
+	};
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Hydrogen/Viewport.hpp"
+
+namespace Hydrogen
+{
+	class HeadlessViewport : public Viewport
+	{
+	public:
+		HeadlessViewport(int width, int height);
+		~HeadlessViewport();
+
+		void Open() override;
+		void Close() override;
+
+		int GetWidth() const override { return m_Width; }
+		int GetHeight() const override { return m_Height; }
+		int IsOpen() const override { return m_IsOpen; }
+		bool IsHeadless() const override { return true; }
+
+		const std::vector<const char*> GetVulkanExtensions() const override;
+		VkSurfaceKHR GetVulkanSurface() override { return VK_NULL_HANDLE; }
+		void ImGuiNewFrame() const override;
+		void InitImGui() const override;
+		void ImGuiShutdown() const override;
+
+		void LockCursor() override {}
+		void UnlockCursor() override {}
+
+	private:
+		int m_Width, m_Height;
+		bool m_IsOpen;
+	};
+}
@@ -55,6 +55,7 @@ namespace Hydrogen
 	{
 		Vertex = 0x1,
 		Fragment = 0x2,
+		Compute = 0x4,
 		All = 0x7
 	};
 
@@ -81,7 +82,8 @@ namespace Hydrogen
 	{
 		UniformBuffer,
 		StorageBuffer,
-		CombinedImageSampler
+		CombinedImageSampler,
+		StorageImage
 	};
 
 	enum class DescriptorBindingFlags : uint32_t
@@ -105,12 +107,14 @@ namespace Hydrogen
 
 		std::vector<const Texture*> Textures;
 		std::vector<struct RgResourceHandle> Resources;
+		std::vector<struct RgResourceHandle> Buffers;
 	};
 
 	struct PipelineSpec
 	{
 		std::string VertexMain = "main";
 		std::string FragmentMain = "main";
+		std::string ComputeMain = "main";
 		VkExtent2D ViewportExtent = { 800, 600 };
 		VertexLayout VertexBufferLayout = {};
 		PrimitiveStyle Primitive = PrimitiveStyle::Triangles;
@@ -121,11 +125,12 @@ namespace Hydrogen
 		std::vector<PushConstantsRange> PushConstants = {};
 		std::vector<VkDescriptorSetLayout> DescriptorSetLayouts = {};
 
-		size_t Hash()
+		size_t Hash() const
 		{
 			size_t seed = 0;
 			HashCombine(seed, std::hash<std::string>{}(VertexMain));
 			HashCombine(seed, std::hash<std::string>{}(FragmentMain));
+			HashCombine(seed, std::hash<std::string>{}(ComputeMain));
 			HashCombine(seed, static_cast<size_t>(ViewportExtent.width));
 			HashCombine(seed, static_cast<size_t>(ViewportExtent.height));
 			HashCombine(seed, VertexBufferLayout.size());
@@ -164,14 +169,19 @@ namespace Hydrogen
 	{
 	public:
 		Pipeline(RenderDevice* device, VkRenderPass renderPass, const std::shared_ptr<ShaderAsset>& vertexShader, const std::shared_ptr<ShaderAsset>& fragmentShader, PipelineSpec spec);
+		Pipeline(RenderDevice* device, const std::shared_ptr<ShaderAsset>& computeShader, PipelineSpec spec);
 		~Pipeline();
 
 		VkPipelineLayout GetPipelineLayout() const { return m_Layout; }
 		VkPipeline GetPipeline() const { return m_Pipeline; }
+		VkPipelineBindPoint GetBindPoint() const { return m_BindPoint; }
+
+		static VkShaderStageFlags GetVkShaderStageFlags(ShaderStage stageFlags);
 		static VkDescriptorSetLayout CreateDescriptorSetLayout(RenderDevice* device, const std::vector<DescriptorBinding>& bindings);
 
 	private:
 		VkShaderModule CreateShaderModule(const std::vector<uint32_t>& byteCode);
+		void CreatePipelineLayout();
 
 		RenderDevice* m_Device;
 		PipelineSpec m_Spec;
@@ -179,5 +189,6 @@ namespace Hydrogen
 		std::vector<VkPushConstantRange> m_VkPushConstantsRanges;
 		VkPipelineLayout m_Layout;
 		VkPipeline m_Pipeline;
+		VkPipelineBindPoint m_BindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 	};
 }
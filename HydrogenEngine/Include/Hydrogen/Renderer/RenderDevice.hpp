@@ -8,6 +8,8 @@
 
 namespace Hydrogen
 {
+	#define PIPELINE_CACHE_PATH "Caches/PipelineCache.hycache"
+
 	class RenderDevice
 	{
 	public:
@@ -26,9 +28,13 @@ namespace Hydrogen
 
 		VkQueue GetGraphicsQueue() const { return m_GraphicsQueue; }
 		VkQueue GetPresentQueue() const { return m_PresentQueue; }
+		bool IsHeadless() const { return m_Headless; }
 
 		VkCommandPool GetCommandPool() const { return m_CommandPool; }
 		VmaAllocator GetAllocator() const { return m_Allocator; }
+		VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+
+		void SavePipelineCache() const;
 
 		static bool CheckDeviceSuitability(VkPhysicalDevice device, const std::shared_ptr<Viewport>& viewport);
 
@@ -46,12 +52,15 @@ namespace Hydrogen
 
 		static bool CheckDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char*>& extensions);
 		static QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, const std::shared_ptr<Viewport>& viewport);
-		static const std::vector<const char*> GetRequiredDeviceExtensions();
+		static const std::vector<const char*> GetRequiredDeviceExtensions(bool headless);
 		void CreateLogicalDevice();
+		void CreatePipelineCache();
+		bool IsPipelineCacheCompatible(const std::vector<char>& data) const;
 
 		VkPhysicalDevice m_PhysicalDevice;
 		VkDevice m_Device;
 		RenderDeviceDescriptor m_Descriptor;
+		bool m_Headless = false;
 
 		QueueFamilyIndices m_QueueFamilyIndices;
 
@@ -60,5 +69,6 @@ namespace Hydrogen
 
 		VkCommandPool m_CommandPool = VK_NULL_HANDLE;
 		VmaAllocator m_Allocator = VK_NULL_HANDLE;
+		VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
 	};
 }
@@ -5,9 +5,12 @@
 #include "Hydrogen/Renderer/Texture.hpp"
 #include "Hydrogen/AssetManager.hpp"
 #include "Hydrogen/Core.hpp"
+#include "Hydrogen/JobSystem.hpp"
 
 #include <vma/vk_mem_alloc.h>
 
+#include <mutex>
+
 namespace Hydrogen
 {
 	struct RgResourceHandle { size_t Id = uint64_t(-1); bool IsValid() const { return Id != uint64_t(-1); } };
@@ -22,7 +25,8 @@ namespace Hydrogen
 	enum class RgBufferType
 	{
 		Uniform,
-		Storage
+		Storage,
+		DeviceStorage
 	};
 	
 	struct RgBufferDesc
@@ -37,20 +41,114 @@ namespace Hydrogen
 		VkImageView ImageView = VK_NULL_HANDLE;
 		VkImageUsageFlags UsageFlags = 0;
 		bool IsImported = false;
+		bool IsPersistent = false;
 		bool IsOutput = false;
 	};
 
-	class RgCommandList
+	struct RgPipelineHandle { uint32_t Id = UINT32_MAX; bool IsValid() const { return Id != UINT32_MAX; } };
+
+	struct RgPipelineDesc
+	{
+		std::shared_ptr<ShaderAsset> VertexShader;
+		std::shared_ptr<ShaderAsset> FragmentShader;
+		std::shared_ptr<ShaderAsset> ComputeShader;
+		PipelineSpec Spec;
+		size_t Hash = 0;
+	};
+
+	class RgPipelineLibrary
 	{
 	public:
-		RgCommandList(RenderDevice* device)
+		RgPipelineLibrary(RenderDevice* device)
 			: m_Device(device) {}
 
-		void InitFrame(VkCommandBuffer cmdBuf, const std::vector<RgTextureView>* physicalViews, VkDescriptorSet frameDescriptorSet)
+		RgPipelineHandle Register(const RgPipelineDesc& desc);
+
+		// Thread safe, pipelines are created outside the lock so multiple threads can compile at once
+		Pipeline* GetOrCreate(RgPipelineHandle pipeline, VkRenderPass renderPass, const std::vector<VkDescriptorSetLayout>& layouts, size_t layoutHash);
+		bool Contains(RgPipelineHandle pipeline, VkRenderPass renderPass, size_t layoutHash);
+
+		static size_t HashLayouts(const std::vector<VkDescriptorSetLayout>& layouts);
+
+	private:
+		size_t GetPipelineKey(RgPipelineHandle pipeline, VkRenderPass renderPass, size_t layoutHash) const;
+
+		RenderDevice* m_Device;
+
+		std::vector<RgPipelineDesc> m_Descs;
+		std::unordered_map<size_t, RgPipelineHandle> m_DescLookup;
+
+		std::mutex m_Mutex;
+		std::unordered_map<size_t, std::unique_ptr<Pipeline>> m_Pipelines;
+	};
+
+	struct RgCommandStats
+	{
+		uint32_t DrawCount = 0;
+		uint32_t DispatchCount = 0;
+		uint32_t PipelineBindCount = 0;
+		uint32_t DescriptorSetBindCount = 0;
+		uint32_t VertexBufferBindCount = 0;
+		uint32_t IndexBufferBindCount = 0;
+
+		void Add(const RgCommandStats& other)
+		{
+			DrawCount += other.DrawCount;
+			DispatchCount += other.DispatchCount;
+			PipelineBindCount += other.PipelineBindCount;
+			DescriptorSetBindCount += other.DescriptorSetBindCount;
+			VertexBufferBindCount += other.VertexBufferBindCount;
+			IndexBufferBindCount += other.IndexBufferBindCount;
+		}
+	};
+
+	struct RgPassStats
+	{
+		std::string Name;
+		double RecordMs = 0.0; // summed over all recording threads for parallel passes
+		RgCommandStats Commands;
+	};
+
+	struct RgFrameStats
+	{
+		double CompileResourcesMs = 0.0;
+		double CompilePassesMs = 0.0;
+		double PrewarmMs = 0.0;
+		double DescriptorUpdateMs = 0.0;
+		double ParallelRecordMs = 0.0;
+		double RecordMs = 0.0;
+
+		std::vector<RgPassStats> Passes;
+		RgCommandStats Commands;
+	};
+
+	struct RgGpuPassTiming
+	{
+		std::string Name;
+		double Ms = 0.0;
+	};
+
+	struct RgGpuFrameTimings
+	{
+		// Execute call the timings belong to, they trail the current frame by up to maxFIF frames
+		uint64_t FrameNumber = 0;
+		double TotalMs = 0.0;
+		std::vector<RgGpuPassTiming> Passes;
+	};
+
+	class RgCommandList
+	{
+	public:
+		RgCommandList(RenderDevice* device, RgPipelineLibrary* pipelineLibrary)
+			: m_Device(device), m_PipelineLibrary(pipelineLibrary) {}
+
+		void InitFrame(VkCommandBuffer cmdBuf, const std::vector<RgTextureView>* physicalViews, const std::vector<VkBuffer>* physicalBuffers, VkDescriptorSet frameDescriptorSet)
 		{
 			m_CmdBuf = cmdBuf;
 			m_PhysicalViews = physicalViews;
+			m_PhysicalBuffers = physicalBuffers;
 			m_FrameDescriptorSet = frameDescriptorSet;
+			m_BoundPipeline = nullptr;
 		}
 
 		void InitPass(VkRenderPass renderPass, const std::vector<VkDescriptorSetLayout>& descriptorSetLayouts, VkDescriptorSet passDescriptorSet)
@@ -58,52 +156,91 @@ namespace Hydrogen
 			m_RenderPass = renderPass;
 			m_DescriptorSetLayouts = descriptorSetLayouts;
 			m_PassDescriptorSet = passDescriptorSet;
+			m_BoundPipeline = nullptr;
+
+			m_LayoutHash = RgPipelineLibrary::HashLayouts(m_DescriptorSetLayouts);
 		}
 
 		VkCommandBuffer GetCommandBuffer() const { return m_CmdBuf; }
 
+		const RgCommandStats& GetStats() const { return m_Stats; }
+		void ResetStats() { m_Stats = {}; }
+
 		RgTextureView GetTextureView(RgResourceHandle handle) const
 		{
 			return (*m_PhysicalViews)[handle.Id];
 		}
 
+		VkBuffer GetBuffer(RgResourceHandle handle) const
+		{
+			return (*m_PhysicalBuffers)[handle.Id];
+		}
+
 		void PushConstants(const void* data, uint32_t size, uint32_t offset, ShaderStage stageFlags);
-		void BindPipeline(const std::shared_ptr<ShaderAsset>& vertexShader, const std::shared_ptr<ShaderAsset>& fragmentShader, PipelineSpec spec);
+		void BindPipeline(RgPipelineHandle pipeline);
 		void BindVertexBuffer(const RenderBuffer* vertexBuffer);
 		void BindIndexBuffer(const RenderBuffer* indexBuffer);
 		void Draw(uint32_t vertexCount, uint32_t instanceCount=1);
 		void DrawIndexed(uint32_t indexCount);
+		void Dispatch(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
 
 	private:
+		void BindDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout);
+
 		RenderDevice* m_Device;
+		RgPipelineLibrary* m_PipelineLibrary;
 
 		VkCommandBuffer m_CmdBuf = VK_NULL_HANDLE;
 		const std::vector<RgTextureView>* m_PhysicalViews = nullptr;
+		const std::vector<VkBuffer>* m_PhysicalBuffers = nullptr;
 		VkRenderPass m_RenderPass = VK_NULL_HANDLE;
 		std::vector<VkDescriptorSetLayout> m_DescriptorSetLayouts;
 		VkDescriptorSet m_FrameDescriptorSet = VK_NULL_HANDLE;
 		VkDescriptorSet m_PassDescriptorSet = VK_NULL_HANDLE;
 
 		Pipeline* m_BoundPipeline = nullptr;
+		size_t m_LayoutHash = 0;
 
-		std::unordered_map<size_t, std::unique_ptr<Pipeline>> m_PipelineCache;
+		RgCommandStats m_Stats;
+
+		struct ResolvedPipeline
+		{
+			VkRenderPass RenderPass = VK_NULL_HANDLE;
+			size_t LayoutHash = 0;
+			Pipeline* PipelinePtr = nullptr;
+		};
+
+		std::vector<ResolvedPipeline> m_ResolvedPipelines;
 	};
 
 	struct RgResourceUsage
 	{
-		enum class Type { ColorWrite, DepthWrite, ShaderRead };
+		enum class Type { ColorWrite, DepthWrite, ShaderRead, StorageRead, StorageWrite, BufferRead, BufferWrite };
 
 		Type UsageType;
 		RgResourceHandle Handle;
+
+		bool IsBufferUsage() const { return UsageType == Type::BufferRead || UsageType == Type::BufferWrite; }
+	};
+
+	enum class RgPassType
+	{
+		Graphics,
+		Compute
 	};
 
 	struct RgPassNode
 	{
 		std::string Name;
+		RgPassType Type = RgPassType::Graphics;
 		std::vector<RgResourceUsage> Usages;
 		std::vector<DescriptorBinding> DescriptorBindings;
 		std::vector<DescriptorBindingValue> DescriptorBindingValues;
+		std::vector<RgPipelineHandle> Pipelines;
 		std::function<void(RgCommandList&)> ExecuteCallback;
+
+		uint32_t ParallelItemCount = 0;
+		std::function<void(RgCommandList&, uint32_t, uint32_t)> ParallelExecuteCallback;
 	};
 
 	class RgPassBuilder
@@ -116,6 +253,13 @@ namespace Hydrogen
 		RgResourceHandle WriteColor(RgResourceHandle texture);
 		RgResourceHandle WriteDepth(RgResourceHandle texture);
 		RgResourceHandle ReadTexture(RgResourceHandle texture);
+		RgResourceHandle ReadStorageImage(RgResourceHandle texture);
+		RgResourceHandle WriteStorageImage(RgResourceHandle texture);
+		RgResourceHandle ReadBuffer(RgResourceHandle buffer);
+		RgResourceHandle WriteBuffer(RgResourceHandle buffer);
+
+		// Declares a pipeline the pass binds so it can be created ahead of recording
+		void UsePipeline(RgPipelineHandle pipeline);
 
 		RgPassNode GetNode() const { return m_PassNode; }
 
@@ -137,12 +281,27 @@ namespace Hydrogen
 		VkPipelineStageFlags DstStage;
 	};
 
+	struct VkBufferBarrierCommand
+	{
+		size_t BufferId;
+		VkBufferMemoryBarrier Barrier;
+		VkPipelineStageFlags SrcStage;
+		VkPipelineStageFlags DstStage;
+	};
+
 	struct CompiledPass
 	{
 		std::string Name;
+		RgPassType Type = RgPassType::Graphics;
 		std::vector<VkBarrierCommand> PrePassBarriers;
+		std::vector<VkBufferBarrierCommand> PrePassBufferBarriers;
+		std::vector<RgPipelineHandle> Pipelines;
 		std::function<void(RgCommandList&)> ExecuteCallback;
 
+		uint32_t ParallelItemCount = 0;
+		std::function<void(RgCommandList&, uint32_t, uint32_t)> ParallelExecuteCallback;
+		std::vector<VkCommandBuffer> SecondaryCommandBuffers;
+
 		std::vector<VkFormat> ColorFormats;
 		std::optional<VkFormat> DepthFormat;
 
@@ -150,8 +309,8 @@ namespace Hydrogen
 		VkImageView DepthAttachment = VK_NULL_HANDLE;
 		VkExtent2D RenderExtent;
 
-		VkRenderPass RenderPass;
-		VkFramebuffer Framebuffer;
+		VkRenderPass RenderPass = VK_NULL_HANDLE;
+		VkFramebuffer Framebuffer = VK_NULL_HANDLE;
 
 		VkDescriptorSetLayout DescriptorSetLayout = VK_NULL_HANDLE;
 		VkDescriptorSet DescriptorSet = VK_NULL_HANDLE;
@@ -161,11 +320,13 @@ namespace Hydrogen
 
 	#define FREE_AFTER_UNUSED_FRAMES 500
 	#define CLEAR_INACTIVE_THREASHHOLD 50
+	#define MIN_ITEMS_PER_RECORDING_CHUNK 128
+	#define MAX_TIMESTAMPED_PASSES 64
 
 	class RenderGraph
 	{
 	public:
-		RenderGraph(RenderDevice* device);
+		RenderGraph(RenderDevice* device, uint32_t maxFIF = 3);
 		~RenderGraph();
 
 		void Reset(uint32_t frameIndex);
@@ -174,6 +335,11 @@ namespace Hydrogen
 
 		RgResourceHandle CreateTexture(const RgTextureDesc& desc);
 		RgResourceHandle ImportTexture(VkImage image, VkImageView imageView, const RgTextureDesc& desc);
+		RgResourceHandle CreateBuffer(const RgBufferDesc& desc);
+
+		// Keeps its contents and layout between frames. upToDate is true when the texture was last written
+		// in a frame that passed the same contentHash, a changed desc recreates it empty
+		RgResourceHandle CreatePersistentTexture(const std::string& name, const RgTextureDesc& desc, size_t contentHash, bool& upToDate);
 
 		void AddPass(const std::string& name,
 			const std::vector<DescriptorBinding>& bindings, // set 1
@@ -181,12 +347,35 @@ namespace Hydrogen
 			std::function<void(RgPassBuilder&)> setup,
 			std::function<void(RgCommandList&)> execute);
 
+		void AddParallelPass(const std::string& name,
+			const std::vector<DescriptorBinding>& bindings, // set 1
+			const std::vector<DescriptorBindingValue>& bindingValues,
+			std::function<void(RgPassBuilder&)> setup,
+			uint32_t itemCount,
+			std::function<void(RgCommandList&, uint32_t first, uint32_t count)> execute);
+
+		void AddComputePass(const std::string& name,
+			const std::vector<DescriptorBinding>& bindings, // set 1
+			const std::vector<DescriptorBindingValue>& bindingValues,
+			std::function<void(RgPassBuilder&)> setup,
+			std::function<void(RgCommandList&)> execute);
+
+		RgPipelineHandle RegisterPipeline(const std::shared_ptr<ShaderAsset>& vertexShader, const std::shared_ptr<ShaderAsset>& fragmentShader, const PipelineSpec& spec);
+		RgPipelineHandle RegisterComputePipeline(const std::shared_ptr<ShaderAsset>& computeShader, const PipelineSpec& spec);
+
 		void AddOutput(const RgResourceHandle& handle);
 		std::vector<RgTextureView> GetOutputs();
 
 		void Compile(const std::vector<DescriptorBinding>& frameBindings); // set 0
 		void Execute(VkCommandBuffer cmdBuffer, const std::vector<DescriptorBindingValue>& bindingValues);
 
+		// Timings and command counts of the last Compile and Execute
+		const RgFrameStats& GetFrameStats() const { return m_FrameStats; }
+
+		// GPU time of each pass, read back once the frame's fence was waited on
+		const RgGpuFrameTimings& GetGpuTimings() const { return m_GpuTimings; }
+		bool HasGpuTimings() const { return m_HasGpuTimings; }
+
 		VkRenderPass GetRenderPass(std::string passName)
 		{
 			for (const auto& pass : m_CompiledPasses)
@@ -205,6 +394,22 @@ namespace Hydrogen
 
 		void CreateDescriptorPool();
 		void CreateSampler();
+		void CreateRecordingContexts();
+		void CreateTimestampQueries();
+
+		struct RecordingContext
+		{
+			std::vector<VkCommandPool> CommandPools;
+			std::vector<std::vector<VkCommandBuffer>> CommandBuffers;
+			uint32_t UsedCommandBuffers = 0;
+
+			std::unique_ptr<RgCommandList> CommandList;
+		};
+		VkCommandBuffer AcquireSecondaryCommandBuffer(RecordingContext& context);
+		void RecordParallelPasses();
+		void RecordPass(VkCommandBuffer cmdBuffer, const CompiledPass& pass, RgPassStats& passStats);
+		void PrewarmPipelines();
+		std::vector<VkDescriptorSetLayout> GetPassDescriptorSetLayouts(const CompiledPass& pass) const;
 
 		struct RenderPassAttachment
 		{
@@ -227,8 +432,12 @@ namespace Hydrogen
 		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
 		RenderDevice* m_Device;
+		RgPipelineLibrary m_PipelineLibrary;
 		RgCommandList m_CommandList;
 
+		uint32_t m_MaxFIF;
+		std::vector<RecordingContext> m_RecordingContexts;
+
 		VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
 		VkSampler m_Sampler = VK_NULL_HANDLE;
 
@@ -237,11 +446,36 @@ namespace Hydrogen
 
 		std::vector<RgTextureDesc> m_TextureDescs;
 		std::vector<RgTextureView> m_PhysicalTextureViews;
+		std::vector<RgBufferDesc> m_BufferDescs;
+		std::vector<VkBuffer> m_PhysicalBuffers;
 		std::vector<RgPassNode> m_PassNodes;
 
+		void BeginTimestamps(VkCommandBuffer cmdBuffer);
+		void WritePassTimestamp(VkCommandBuffer cmdBuffer, size_t passIndex, bool end);
+		void ResolveTimestamps();
+
+		struct TimestampFrame
+		{
+			VkQueryPool QueryPool = VK_NULL_HANDLE;
+			std::vector<std::string> PassNames;
+			uint64_t FrameNumber = 0;
+			bool Pending = false;
+		};
+
+		std::vector<TimestampFrame> m_TimestampFrames;
+		bool m_TimestampsSupported = false;
+		double m_TimestampPeriodNs = 0.0;
+		uint64_t m_TimestampMask = UINT64_MAX;
+		uint64_t m_ExecutedFrames = 0;
+
+		RgGpuFrameTimings m_GpuTimings;
+		bool m_HasGpuTimings = false;
+
 		std::vector<CompiledPass> m_CompiledPasses;
 		std::vector<VkBarrierCommand> m_PostRenderBarriers;
 
+		RgFrameStats m_FrameStats;
+
 		std::unordered_map<size_t, VkRenderPass> m_RenderPassCache;
 		std::unordered_map<size_t, VkFramebuffer> m_FramebufferCache;
 
@@ -271,6 +505,37 @@ namespace Hydrogen
 
 		std::vector<PooledTexture> m_PhysicalTexturePool;
 
+		struct PersistentTexture
+		{
+			RgTextureDesc Desc;
+			VkImage Image = VK_NULL_HANDLE;
+			VkImageView View = VK_NULL_HANDLE;
+			VmaAllocation Allocation = VK_NULL_HANDLE;
+			VkImageUsageFlags UsageFlags = 0;
+
+			VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkPipelineStageFlags AccessStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			VkAccessFlags AccessMask = 0;
+
+			bool HasContents = false;
+			size_t ContentHash = 0;
+
+			size_t FramesUnsued = 0;
+			bool UsedThisFrame = false;
+		};
+
+		struct FramePersistentTexture
+		{
+			uint32_t TextureId;
+			PersistentTexture* Texture;
+			size_t ContentHash;
+		};
+
+		void DestroyPersistentTexture(PersistentTexture& texture);
+
+		std::unordered_map<std::string, PersistentTexture> m_PersistentTextures;
+		std::vector<FramePersistentTexture> m_FramePersistentTextures;
+
 		struct PooledBuffer
 		{
 			VkBuffer Buffer = VK_NULL_HANDLE;
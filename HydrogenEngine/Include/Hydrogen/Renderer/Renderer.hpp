@@ -8,6 +8,17 @@
 
 namespace Hydrogen
 {
+	// state a view carries from one frame to the next for temporal passes
+	struct TemporalViewState
+	{
+		glm::mat4 PrevViewProj = glm::mat4(1.0f); // unjittered
+		uint64_t FrameIndex = 0;
+
+		// last frame's transforms by entity id, for the velocity target
+		std::unordered_map<uint32_t, glm::mat4> PrevModels;
+		std::unordered_map<uint32_t, std::vector<glm::mat4>> PrevBones;
+	};
+
 	class Renderer
 	{
 	public:
@@ -19,6 +30,9 @@ namespace Hydrogen
 
 		std::vector<RgTextureView> Render(const std::function<const std::vector<DescriptorBindingValue>(RenderGraph* graph)>& setupPasses, bool present);
 
+		// Copies a render graph output back to the host as tightly packed RGBA8 (sRGB encoded for float formats)
+		std::vector<uint8_t> ReadbackTexture(const RgTextureView& view, uint32_t width, uint32_t height, TextureFormat format);
+
 		void UpdateSwapChain(SwapChain* swapChain);
 		void ClearCache();
 
@@ -28,6 +42,8 @@ namespace Hydrogen
 		RenderGraph* GetRenderGraph() { return m_RenderGraph.get(); }
 		SwapChain* GetSwapChain() { return m_SwapChain; }
 
+		TemporalViewState& GetTemporalState() { return m_TemporalState; }
+
 	private:
 		void CreateCommandBuffer();
 		void CreateSyncObjects();
@@ -47,6 +63,7 @@ namespace Hydrogen
 		std::vector<VkFence> m_WaitFences;
 
 		std::unique_ptr<RenderGraph> m_RenderGraph;
+		TemporalViewState m_TemporalState;
 
 		VkDescriptorPool m_ImGuiDescriptorPool = VK_NULL_HANDLE;
 		VkSampler m_ImguiSampler;
@@ -56,6 +73,7 @@ namespace Hydrogen
 	{
 		uint64_t Width = 1920;
 		uint64_t Height = 1080;
+		float RenderScale = 1.0f; // the scene is rendered at this fraction of Width x Height and resolved up to it
 
 		bool RenderToSwapChain = true;
 	};
@@ -93,16 +111,52 @@ namespace Hydrogen
 		std::vector<Gizmo> Gizmos;
 	};
 
+	#define MAX_BLOOM_MIPS 8
+
 	struct PostProcessingSettings
 	{
-		uint8_t BloomIterations = 3;
+		uint8_t BloomMipCount = 6;
 		bool BloomEnabled = true;
 		bool ToneMapping = true;
 	};
 
+	#define TEMPORAL_JITTER_PHASES 8 // at native resolution, grows with the square of the upscale factor
+
+	struct TemporalSettings
+	{
+		bool Enabled = true;
+		float FeedbackMin = 0.88f; // history weight where it disagrees with the current frame
+		float FeedbackMax = 0.97f;
+	};
+
 	struct RenderingSettings
 	{
 		std::shared_ptr<CubeMapAsset> Skybox = nullptr;
+		bool CompactGBuffer = false;
+	};
+
+	#define MAX_SHADOW_CASCADES 4
+	#define SHADOW_CACHE_SNAP_FRACTION 0.25f // cached cascades only move in steps of this fraction of their radius
+
+	enum class ShadowSplitScheme
+	{
+		Uniform,
+		Logarithmic,
+		Practical
+	};
+
+	struct ShadowSettings
+	{
+		bool Enabled = true;
+		uint32_t CascadeCount = 4;
+		uint32_t Resolution = 2048;
+		ShadowSplitScheme SplitScheme = ShadowSplitScheme::Practical;
+		float SplitLambda = 0.75f; // blend between uniform (0) and logarithmic (1) splits for the practical scheme
+		float MaxDistance = 150.0f;
+
+		// static casters of the distant cascades are drawn once into a cached layer, only dynamic ones every frame
+		bool CacheStaticCasters = true;
+		uint32_t FirstCachedCascade = 1;
 	};
 
 	struct RenderSettings
@@ -111,6 +165,8 @@ namespace Hydrogen
 		DebugSettings Debug;
 		PostProcessingSettings PostProcessing;
 		RenderingSettings Rendering;
+		ShadowSettings Shadows;
+		TemporalSettings Temporal;
 	};
 
 	struct DirectionalLight
@@ -118,6 +174,32 @@ namespace Hydrogen
 		glm::vec3 Color;
 		float Intensity;
 		glm::vec3 Direction;
+		float CastsShadows;
+	};
+
+	struct ShadowCascadeData
+	{
+		glm::mat4 LightViewProj[MAX_SHADOW_CASCADES];
+		glm::vec4 SplitDepths; // far view depth of each cascade
+		glm::vec4 TexelSizes; // world space size of one shadow map texel per cascade
+		uint32_t CascadeCount;
+		float Resolution;
+		uint32_t StaticLayerMask; // cascades whose static casters live in a separate cached layer
+		float Padding;
+	};
+
+	#define CLUSTER_GRID_X 16
+	#define CLUSTER_GRID_Y 9
+	#define CLUSTER_GRID_Z 24
+	#define MAX_LIGHTS_PER_CLUSTER 256
+
+	struct PointLight
+	{
+		glm::vec3 Position;
+		float Radius;
+		glm::vec3 Color;
+		float Intensity;
+		glm::vec3 ViewPosition;
 		float Padding;
 	};
 
@@ -155,8 +237,6 @@ namespace Hydrogen
 		static void Reset()
 		{
 			s_GizmoMeshCache.reset();
-			s_SphereVertexBuffer.reset();
-			s_SphereIndexBuffer.reset();
 		}
 
 	private:
@@ -167,7 +247,9 @@ namespace Hydrogen
 			std::vector<const Texture*>& ORMTextures,
 			std::vector<const Texture*>& emissiveTextures);
 		static void UploadBones(Scene* scene, std::vector<glm::mat4>& bones, std::vector<uint32_t>& boneBaseIndices);
+		// both read the scene's world transform stream, which is only current after Scene::UpdateTransforms
 		static std::vector<DirectionalLight> GetDirectionalLights(Scene* scene);
+		static std::vector<PointLight> GetPointLights(Scene* scene, const glm::mat4& view);
 
 		static void CollectGizmoRenderData(const std::vector<Gizmo>& gizmos, std::vector<BillboardInstanceData>& instanceData, std::vector<const Texture*>& textures);
 
@@ -181,9 +263,6 @@ namespace Hydrogen
 		static std::vector<GizmoDrawData> CollectGizmoDrawData(const std::vector<Gizmo>& gizmos);
 
 		static std::unique_ptr<GizmoMeshCache> s_GizmoMeshCache;
-
-		static std::unique_ptr<RenderBuffer> s_SphereVertexBuffer;
-		static std::unique_ptr<RenderBuffer> s_SphereIndexBuffer;
 	};
 
 	class ImGuiTextureCache
@@ -10,7 +10,10 @@ namespace Hydrogen
 		RGBA8_SRGB,
 		RGBA16_SFLOAT,
 		D32_SFLOAT,
-		BGRA8_SRGB
+		BGRA8_SRGB,
+		RGBA8_UNORM,
+		RG16_SFLOAT,
+		B10G11R11_UFLOAT
 	};
 
 	enum class TextureUsage : uint32_t
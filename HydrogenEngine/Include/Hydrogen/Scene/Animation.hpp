@@ -8,13 +8,8 @@ using json = nlohmann::json;
 
 namespace Hydrogen
 {
-	struct SkeletalMeshRendererComponent : public GenericComponent
+	struct SkeletalMeshRendererComponent
 	{
-		SkeletalMeshRendererComponent(Entity entity)
-			: GenericComponent(entity)
-		{
-		}
-
 		std::shared_ptr<SkeletonAsset> Skeleton;
 		std::shared_ptr<SkeletalMeshAsset> SkeletalMesh;
 		std::shared_ptr<MaterialAsset> Material;
@@ -37,16 +32,16 @@ namespace Hydrogen
 		std::vector<glm::mat4> LocalTransforms;
 	};
 
-	struct AnimatorComponent : public GenericComponent
+	// reaches the skeletal mesh renderer on its own entity, so it keeps the back reference
+	struct AnimatorComponent : public EntityBoundComponent
 	{
 		AnimatorComponent(Entity entity)
-			: GenericComponent(entity)
+			: EntityBoundComponent(entity)
 		{
 		}
 
-		virtual void Deserialize(const json& j) override
+		void ApplyFields()
 		{
-			GenericComponent::Deserialize(j);
 			UpdateGraph();
 		}
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
 #include "Hydrogen/Scene/Components.hpp"
@@ -8,23 +9,16 @@
 
 namespace Hydrogen
 {
-	struct CameraComponent : GenericComponent
+	struct CameraComponent
 	{
-		CameraComponent(Entity entity)
-			: GenericComponent(entity)
-		{
-			Active = false;
-			NearPlane = 0.1f;
-			FarPlane = 1000.0f;
-			FOV = 60.0f;
-		}
-
 		glm::mat4 View, Proj;
+		glm::mat4 UnjitteredProj;
 		uint32_t ViewportWidth, ViewportHeight;
+		glm::vec2 Jitter = glm::vec2(0.0f); // subpixel offset in NDC, applied on top of the projection
 
-		bool Active;
-		float NearPlane, FarPlane;
-		float FOV;
+		bool Active = false;
+		float NearPlane = 0.1f, FarPlane = 1000.0f;
+		float FOV = 60.0f;
 
 		bool GetActive() const { return Active; }
 		void SetActive(bool active) { Active = active; }
@@ -38,15 +32,19 @@ namespace Hydrogen
 		float GetFarPlane() const { return FarPlane; }
 		void SetFarPlane(float farPlane) { FarPlane = farPlane; }
 
-		virtual void CalculateView(Entity entity)
+		void CalculateView(Entity entity)
 		{
 			auto& transform = entity.GetComponent<TransformComponent>();
 
-			glm::vec3 translation = transform.GetTranslation();
-			glm::quat rotation = transform.GetRotation();
+			// the camera's own transform may have moved since the last hierarchy pass, so only the parent's cached world matrix is used
+			glm::mat4 world = transform.GetModel();
+			Entity parent = entity.GetScene()->GetParent(entity);
+			if (parent.IsValid())
+				world = parent.GetComponent<TransformComponent>().GetWorldMatrix() * world;
 
-			glm::vec3 front = rotation * glm::vec3(0.0f, 0.0f, -1.0f);
-			glm::vec3 up = rotation * glm::vec3(0.0f, 1.0f, 0.0f);
+			glm::vec3 translation = glm::vec3(world[3]);
+			glm::vec3 front = glm::normalize(glm::vec3(world * glm::vec4(0.0f, 0.0f, -1.0f, 0.0f)));
+			glm::vec3 up = glm::normalize(glm::vec3(world * glm::vec4(0.0f, 1.0f, 0.0f, 0.0f)));
 
 			View = glm::lookAt(
 				translation,
@@ -55,7 +53,7 @@ namespace Hydrogen
 			);
 		}
 
-		virtual void CalculateProj()
+		void CalculateProj()
 		{
 			Proj = glm::perspective(
 				glm::radians(FOV),
@@ -64,6 +62,9 @@ namespace Hydrogen
 			);
 
 			Proj[1][1] *= -1;
+
+			UnjitteredProj = Proj;
+			Proj = glm::translate(glm::mat4(1.0f), glm::vec3(Jitter, 0.0f)) * UnjitteredProj;
 		}
 
 		BEGIN_COMPONENT_REFLECTION(CameraComponent)
@@ -79,13 +80,7 @@ namespace Hydrogen
 	{
 	public:
 		FreeCamera()
-			: CameraComponent(Entity())
 		{
-			Active = false;
-			NearPlane = 0.1f;
-			FarPlane = 1000.0f;
-			FOV = 60.0f;
-
 			m_CameraPos = glm::vec3(0.0f, 0.0f, 3.0f);
 			m_CameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
 			m_CameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
@@ -141,9 +136,6 @@ namespace Hydrogen
 		glm::vec3 GetPosition() const { return m_CameraPos; }
 		void SetPosition(glm::vec3 position) { m_CameraPos = position; }
 
-		virtual void Serialize(json&) const override {}
-		virtual void Deserialize(const json&) override {}
-
 	private:
 		glm::vec3 m_CameraPos;
 		glm::vec3 m_CameraFront;
@@ -6,7 +6,7 @@
 #include "Hydrogen/AssetManager.hpp"
 
 #define BEGIN_COMPONENT_REFLECTION(ClassName) \
-	const std::vector<FieldInfo>& GetReflectionFields() const override { \
+	static const std::vector<FieldInfo>& GetReflectionFields() { \
 		using TClass = ClassName; \
 		static const std::vector<FieldInfo> fields = {
 
@@ -52,23 +52,22 @@ namespace Hydrogen
 		size_t Offset;
 	};
 
-	class GenericComponent
+	// reflection driven (de)serialization, components without their own Serialize/Deserialize go through these
+	void SerializeFields(const void* component, const std::vector<FieldInfo>& fields, json& j);
+	void DeserializeFields(void* component, const std::vector<FieldInfo>& fields, const json& j);
+	void CopyFields(const void* source, void* target, const std::vector<FieldInfo>& fields); // asset fields share the pointer
+
+	// optional base for components that have to reach their own entity, plain data components stay without it
+	class EntityBoundComponent
 	{
 	public:
-		GenericComponent(Entity entity)
+		EntityBoundComponent(Entity entity)
 			: m_Entity(entity)
 		{
 		}
 
 		Entity& GetEntity() { return m_Entity; }
 
-		virtual const std::vector<FieldInfo>& GetReflectionFields() const = 0;
-
-		virtual void Serialize(json& j) const;
-		virtual void Deserialize(const json& j);
-
-		virtual void PostDeserialize(const json& j) {}
-
 	private:
 		Entity m_Entity;
 	};
@@ -81,6 +80,20 @@ namespace Hydrogen
 			std::function<void(json& j, Entity entity)> Serialize;
 			std::function<void(const json& j, Entity entity)> Deserialize;
 			std::function<void(const json& j, Entity entity)> PostDeserialize;
+			// points entity references in the json at other entities, old UUID to new, empty for types without any
+			std::function<void(json& j, const std::unordered_map<uint64_t, uint64_t>& uuids)> RemapEntities;
+
+			// bulk paths of the binary scene format, which accesses the reflected fields straight through their offsets
+			std::function<void(Scene& scene, std::vector<entt::entity>& entities, std::vector<void*>& components)> GetAll;
+			std::function<void(Scene& scene, const std::vector<entt::entity>& entities, std::vector<void*>& components)> AddAll;
+			std::function<void(void* component)> ApplyFields; // empty when writing the fields is all there is to it
+			// prefabs copy one template component into many entities at once, empty for types bound to their entity
+			std::function<void(Scene& scene, const void* component, const std::vector<entt::entity>& entities)> InsertCopies;
+
+			const std::vector<FieldInfo>* Fields = nullptr;
+			bool CustomSerialized = false; // has its own Serialize, stored as json in the binary format as well
+			bool BindsEntity = false; // its constructor takes the entity and may look at other components
+			entt::id_type Type = 0; // entt type hash, lets code that lists component types check them against the registry
 		};
 
 		static ComponentRegistry& Get()
@@ -103,41 +116,96 @@ namespace Hydrogen
 		std::unordered_map<std::string, ComponentHandlers> m_Registry;
 	};
 
+	// the registry only holds per type function pointers and field tables, components carry no vtable
+	// components may define Serialize/Deserialize/PostDeserialize to replace the reflected path,
+	// and ApplyFields for work that has to follow once the reflected fields were written
 	template <typename T>
 	struct ComponentRegistrar
 	{
 		ComponentRegistrar(const char* componentName)
 		{
 			ComponentRegistry::Get().Register(componentName, {
-				[componentName](json& j, Entity entity) {
+				[](json& j, Entity entity) {
 					if (!entity.HasComponent<T>())
 						return;
-					auto& comp = entity.GetComponent<T>();
-					comp.Serialize(j);
+
+					const auto& comp = entity.GetComponent<T>();
+					if constexpr (requires(const T& c, json& out) { c.Serialize(out); })
+						comp.Serialize(j);
+					else
+						SerializeFields(&comp, T::GetReflectionFields(), j);
 				},
-				[componentName](const json& j, Entity entity) {
+				[](const json& j, Entity entity) {
 					auto& comp = entity.GetOrAddComponent<T>();
-					comp.Deserialize(j);
+					if constexpr (requires(T& c, const json& in) { c.Deserialize(in); })
+					{
+						comp.Deserialize(j);
+					}
+					else
+					{
+						DeserializeFields(&comp, T::GetReflectionFields(), j);
+						if constexpr (requires(T& c) { c.ApplyFields(); })
+							comp.ApplyFields();
+					}
+				},
+				[](const json& j, Entity entity) {
+					if constexpr (requires(T& c, const json& in, Entity e) { c.PostDeserialize(in, e); })
+					{
+						if (auto* comp = entity.TryGetComponent<T>())
+							comp->PostDeserialize(j, entity);
+					}
+				},
+				[]() -> std::function<void(json&, const std::unordered_map<uint64_t, uint64_t>&)> {
+					if constexpr (requires(json& j, const std::unordered_map<uint64_t, uint64_t>& uuids) { T::RemapEntities(j, uuids); })
+						return &T::RemapEntities;
+					else
+						return nullptr;
+				}(),
+				[](Scene& scene, std::vector<entt::entity>& entities, std::vector<void*>& components) {
+					for (auto [entity, comp] : scene.GetRegistry().view<T>().each())
+					{
+						entities.push_back(entity);
+						components.push_back(&comp);
+					}
 				},
-				[componentName](const json& j, Entity entity) {
-					if (entity.HasComponent<T>())
+				[](Scene& scene, const std::vector<entt::entity>& entities, std::vector<void*>& components) {
+					auto& registry = scene.GetRegistry();
+					if constexpr (!std::is_constructible_v<T, Entity> && std::is_copy_constructible_v<T>)
+						registry.insert<T>(entities.begin(), entities.end());
+
+					components.resize(entities.size());
+					for (size_t i = 0; i < entities.size(); i++)
 					{
-						auto& comp = entity.GetComponent<T>();
-						comp.PostDeserialize(j);
+						if constexpr (!std::is_constructible_v<T, Entity> && std::is_copy_constructible_v<T>)
+							components[i] = &registry.get<T>(entities[i]);
+						else
+							components[i] = &Entity(entities[i], &scene).GetOrAddComponent<T>();
 					}
-				}
+				},
+				[]() -> std::function<void(void*)> {
+					if constexpr (requires(T& c) { c.ApplyFields(); })
+						return [](void* component) { static_cast<T*>(component)->ApplyFields(); };
+					else
+						return nullptr;
+				}(),
+				[]() -> std::function<void(Scene&, const void*, const std::vector<entt::entity>&)> {
+					if constexpr (!std::is_constructible_v<T, Entity> && std::is_copy_constructible_v<T>)
+						return [](Scene& scene, const void* component, const std::vector<entt::entity>& entities) {
+							scene.GetRegistry().insert<T>(entities.begin(), entities.end(), *static_cast<const T*>(component));
+						};
+					else
+						return nullptr;
+				}(),
+				&T::GetReflectionFields(),
+				requires(const T& c, json& out) { c.Serialize(out); },
+				std::is_constructible_v<T, Entity>,
+				entt::type_hash<T>::value()
 				});
 		}
 	};
 
-	struct TagComponent : public GenericComponent
+	struct TagComponent
 	{
-		TagComponent(Entity entity)
-			: GenericComponent(entity)
-		{
-			Name = "";
-		}
-
 		std::string Name;
 
 		BEGIN_COMPONENT_REFLECTION(TagComponent)
@@ -146,15 +214,17 @@ namespace Hydrogen
 	};
 	REGISTER_COMPONENT(TagComponent, "TagComponent")
 
-	struct RelationshipComponent : public GenericComponent
+	struct RelationshipComponent
 	{
-		RelationshipComponent(Entity entity)
-			: GenericComponent(entity)
-		{
-			ParentUUID = 0;
-		}
+		uint64_t ParentUUID = 0;
 
-		uint64_t ParentUUID;
+		// runtime links resolved from ParentUUID by the scene, only change them through Scene::SetParent
+		entt::entity Parent = entt::null;
+		entt::entity FirstChild = entt::null;
+		entt::entity PrevSibling = entt::null;
+		entt::entity NextSibling = entt::null;
+		uint32_t ChildCount = 0;
+		uint32_t Depth = 0;
 
 		static void ToJson(json& j, const RelationshipComponent& t)
 		{
@@ -170,21 +240,12 @@ namespace Hydrogen
 			REFLECT_MEMBER(ParentUUID)
 		END_COMPONENT_REFLECTION()
 	};
+	static_assert(std::is_trivially_copyable_v<RelationshipComponent>);
 	REGISTER_COMPONENT(RelationshipComponent, "RelationshipComponent")
 
-	struct TransformComponent : public GenericComponent
+	struct TransformComponent
 	{
-		TransformComponent(Entity entity)
-			: GenericComponent(entity)
-		{
-			Translation = glm::vec3(0.0f, 0.0f, 0.0f);
-			Rotation = glm::quat(0.0f, 0.0f, 0.0f, 0.0f);
-			Scale = glm::vec3(1.0f, 1.0f, 1.0f);
-
-			ModelCache = glm::mat4(1.0f);
-			Dirty = true;
-		}
-
+		// local to parent, the scene combines it into the world matrix
 		const glm::mat4& GetModel()
 		{
 			if (Dirty)
@@ -200,6 +261,23 @@ namespace Hydrogen
 			return ModelCache;
 		}
 
+		// valid after Scene::UpdateTransforms
+		const glm::mat4& GetWorldMatrix() const
+		{
+			return WorldCache;
+		}
+
+		glm::vec3 GetWorldPosition() const
+		{
+			return glm::vec3(WorldCache[3]);
+		}
+
+		// changes whenever the world matrix is rebuilt, lets caches notice moves of the entity or any of its parents
+		uint32_t GetRevision() const
+		{
+			return Revision;
+		}
+
 		const glm::vec3& GetTranslation() const
 		{
 			return Translation;
@@ -209,6 +287,7 @@ namespace Hydrogen
 		{
 			Translation = newTranslation;
 			Dirty = true;
+			WorldDirty = true;
 		}
 
 		const glm::quat& GetRotation() const
@@ -220,6 +299,7 @@ namespace Hydrogen
 		{
 			Rotation = newRotation;
 			Dirty = true;
+			WorldDirty = true;
 		}
 
 		const glm::vec3& GetScale() const
@@ -231,11 +311,12 @@ namespace Hydrogen
 		{
 			Scale = newScale;
 			Dirty = true;
+			WorldDirty = true;
 		}
 
-		glm::vec3 Translation;
-		glm::quat Rotation;
-		glm::vec3 Scale;
+		glm::vec3 Translation = glm::vec3(0.0f, 0.0f, 0.0f);
+		glm::quat Rotation = glm::quat(0.0f, 0.0f, 0.0f, 0.0f);
+		glm::vec3 Scale = glm::vec3(1.0f, 1.0f, 1.0f);
 
 		BEGIN_COMPONENT_REFLECTION(TransformComponent)
 			REFLECT_MEMBER(Translation)
@@ -245,21 +326,21 @@ namespace Hydrogen
 
 	private:
 		bool Dirty = true;
-		glm::mat4 ModelCache;
+		bool WorldDirty = true;
+		bool WorldChanged = false; // rebuilt during the current hierarchy pass, forces the children to follow
+		uint32_t Revision = 0;
+		glm::mat4 ModelCache = glm::mat4(1.0f);
+		glm::mat4 WorldCache = glm::mat4(1.0f);
+
+		friend class Scene;
 	};
+	static_assert(std::is_trivially_copyable_v<TransformComponent>);
 	REGISTER_COMPONENT(TransformComponent, "TransformComponent")
 
-	struct MeshRendererComponent : public GenericComponent
+	struct MeshRendererComponent
 	{
-		MeshRendererComponent(Entity entity)
-			: GenericComponent(entity)
-		{
-			Mesh = nullptr;
-			Material = nullptr;
-		}
-
-		std::shared_ptr<StaticMeshAsset> Mesh;
-		std::shared_ptr<MaterialAsset> Material;
+		std::shared_ptr<StaticMeshAsset> Mesh = nullptr;
+		std::shared_ptr<MaterialAsset> Material = nullptr;
 
 		BEGIN_COMPONENT_REFLECTION(MeshRendererComponent)
 			REFLECT_MEMBER(Mesh)
@@ -268,38 +349,26 @@ namespace Hydrogen
 	};
 	REGISTER_COMPONENT(MeshRendererComponent, "MeshRendererComponent")
 
-	struct DirectionalLightComponent : public GenericComponent
+	struct DirectionalLightComponent
 	{
-		DirectionalLightComponent(Entity entity)
-			: GenericComponent(entity)
-		{
-			Color = glm::vec3(1.0f);
-			Intensity = 10.0f;
-		}
-
-		glm::vec3 Color;
-		float Intensity;
+		glm::vec3 Color = glm::vec3(1.0f);
+		float Intensity = 10.0f;
+		bool CastShadows = true;
 
 		BEGIN_COMPONENT_REFLECTION(DirectionalLightComponent)
 			REFLECT_MEMBER(Color)
 			REFLECT_MEMBER(Intensity)
+			REFLECT_MEMBER(CastShadows)
 		END_COMPONENT_REFLECTION()
 	};
+	static_assert(std::is_trivially_copyable_v<DirectionalLightComponent>);
 	REGISTER_COMPONENT(DirectionalLightComponent, "DirectionalLightComponent")
 
-	struct PointLightComponent : public GenericComponent
+	struct PointLightComponent
 	{
-		PointLightComponent(Entity entity)
-			: GenericComponent(entity)
-		{
-			Color = glm::vec3(1.0f);
-			Intensity = 10.0f;
-			Radius = 10.0f;
-		}
-
-		glm::vec3 Color;
-		float Intensity;
-		float Radius;
+		glm::vec3 Color = glm::vec3(1.0f);
+		float Intensity = 10.0f;
+		float Radius = 10.0f;
 
 		BEGIN_COMPONENT_REFLECTION(PointLightComponent)
 			REFLECT_MEMBER(Color)
@@ -307,6 +376,7 @@ namespace Hydrogen
 			REFLECT_MEMBER(Radius)
 		END_COMPONENT_REFLECTION()
 	};
+	static_assert(std::is_trivially_copyable_v<PointLightComponent>);
 	REGISTER_COMPONENT(PointLightComponent, "PointLightComponent")
 
 	struct ScriptContainer
@@ -320,11 +390,9 @@ namespace Hydrogen
 		bool ExposedFieldsDirty = false;
 	};
 
-	struct ScriptsComponent : public GenericComponent
+	struct ScriptsComponent
 	{
-		ScriptsComponent(Entity entity) : GenericComponent(entity)
-		{
-		}
+		ScriptsComponent() = default;
 
 		ScriptsComponent(const ScriptsComponent&) = delete;
 		ScriptsComponent& operator=(const ScriptsComponent&) = delete;
@@ -332,17 +400,23 @@ namespace Hydrogen
 		std::vector<std::unique_ptr<ScriptContainer>> Scripts;
 
 		// empty because of custom serializer
-		BEGIN_COMPONENT_REFLECTION(GenericComponent)
+		BEGIN_COMPONENT_REFLECTION(ScriptsComponent)
 		END_COMPONENT_REFLECTION()
 
-		virtual void Serialize(json& j) const override;
-		virtual void Deserialize(const json& j) override;
-		virtual void PostDeserialize(const json& j) override;
+		void Serialize(json& j) const;
+		void Deserialize(const json& j);
+		void PostDeserialize(const json& j, Entity entity);
+
+		// entity fields of the scripts, for copies of entities such as prefab instances
+		static void RemapEntities(json& j, const std::unordered_map<uint64_t, uint64_t>& uuids);
 	};
 	REGISTER_COMPONENT(ScriptsComponent, "ScriptsComponent")
 
-	struct RigidbodyComponent : public GenericComponent
+	struct RigidbodyComponent
 	{
+		// colliders point at the rigidbody of their entity, so it must not move when others are removed
+		static constexpr auto in_place_delete = true;
+
 		reactphysics3d::RigidBody* Rigidbody = nullptr;
 
 		int Type = (int)reactphysics3d::BodyType::STATIC; // reactphysics3d::BodyType
@@ -359,10 +433,12 @@ namespace Hydrogen
 		bool LockAngularY = false;
 		bool LockAngularZ = false;
 
-		// in Physics.cpp
+		// in Physics.cpp, the body is created with the next physics step, see PhysicsWorld::RequestPendingBodies
 		RigidbodyComponent(Entity entity);
+		RigidbodyComponent() = default;
 
 		void ApplyRotationLock();
+		void ApplyFields(); // pushes the settings into the body, bodies created later get them on creation
 
 		void SetType(reactphysics3d::BodyType type);
 		void SetMass(float mass);
@@ -373,8 +449,6 @@ namespace Hydrogen
 		void SetLinearVelocity(glm::vec3 velocity);
 		void SetAngularVelocity(glm::vec3 velocity);
 
-		virtual void Deserialize(const json& j) override;
-
 		BEGIN_COMPONENT_REFLECTION(RigidbodyComponent)
 			REFLECT_MEMBER(Type)
 			REFLECT_MEMBER(Mass)
@@ -391,7 +465,7 @@ namespace Hydrogen
 	};
 	REGISTER_COMPONENT(RigidbodyComponent, "RigidbodyComponent")
 
-	struct ColliderComponent : public GenericComponent
+	struct ColliderComponent
 	{
 		enum class Type
 		{
@@ -414,11 +488,12 @@ namespace Hydrogen
 
 		// in Physics.cpp
 		ColliderComponent(Entity entity);
+		ColliderComponent() = default;
 
 		void DestroyCollider();
 		void CreateCollider();
 
-		virtual void Deserialize(const json& j) override;
+		void ApplyFields() { CreateCollider(); }
 
 		BEGIN_COMPONENT_REFLECTION(ColliderComponent)
 			REFLECT_MEMBER(ColliderType)
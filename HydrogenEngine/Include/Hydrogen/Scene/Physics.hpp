@@ -22,16 +22,23 @@ namespace Hydrogen
 
 		reactphysics3d::PhysicsWorld* GetPhysicsWorld() const { return m_PhysicsWorld; }
 
-		reactphysics3d::RigidBody* CreateRigidbody(const struct TransformComponent& transform) const;
+		reactphysics3d::RigidBody* CreateRigidbody(const glm::mat4& world) const;
 		void DestroyRigidbody(reactphysics3d::RigidBody* body);
 
 		void UpdatePhysics(float timestep);
 		void SyncTransforms();
 
+		// rigidbodies and colliders without a body get one before the next step, from their world matrix
+		// new rigidbodies and scene clones go through here, so bodies only appear once the hierarchy is linked
+		void RequestPendingBodies() { m_HasPendingBodies = true; }
+
 		static reactphysics3d::PhysicsCommon PhysicsCommon;
 
 	private:
+		void CreatePendingBodies();
+
 		class Scene* m_Scene = nullptr;
 		reactphysics3d::PhysicsWorld* m_PhysicsWorld = nullptr;
+		bool m_HasPendingBodies = false;
 	};
 }
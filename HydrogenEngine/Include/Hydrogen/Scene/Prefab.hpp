@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Scene.hpp"
+#include "Components.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace Hydrogen
+{
+	// a prefab parsed once into a scene of its own, instances copy their components from there
+	// so asset references are resolved a single time however many copies are spawned
+	struct PrefabTemplate
+	{
+		struct Component
+		{
+			const ComponentRegistry::ComponentHandlers* Handlers;
+			const void* Data; // lives in the source scene
+			json Value; // types with their own Serialize are instanced from json
+		};
+
+		struct Node
+		{
+			uint64_t UUID = 0; // in the source scene, copies get new ones
+			int32_t Parent = -1; // index of the parent node, roots have none
+			std::vector<Component> Components; // plain types first, like the binary scene blocks
+		};
+
+		std::shared_ptr<Scene> Source;
+		std::vector<Node> Nodes;
+
+		glm::vec3 Origin = glm::vec3(0.0f); // translation of the first root, spawn positions are measured from it
+	};
+}
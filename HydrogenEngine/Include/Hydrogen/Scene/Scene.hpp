@@ -14,6 +14,9 @@
 
 #include <random>
 #include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace Hydrogen
 {
@@ -21,8 +24,8 @@ namespace Hydrogen
 
 	struct UUIDComponent
 	{
-		UUIDComponent(class Entity);
-		UUIDComponent(class Entity, uint64_t uuid);
+		UUIDComponent();
+		UUIDComponent(uint64_t uuid);
 
 		uint64_t UUID;
 
@@ -35,11 +38,31 @@ namespace Hydrogen
 		}
 	};
 
+	#define INVALID_WORLD_SLOT UINT32_MAX
+
+	// world matrices of every transform packed in hierarchy order, parents before children
+	// filled by Scene::UpdateTransforms, slots stay valid until entities or transforms are added or removed
+	struct WorldTransformStream
+	{
+		std::vector<glm::mat4> Matrices;
+		std::vector<uint32_t> Revisions;
+		std::vector<entt::entity> Entities; // slot to entity
+		std::vector<uint32_t> Slots; // entity index to slot
+
+		uint32_t GetCount() const { return static_cast<uint32_t>(Matrices.size()); }
+
+		uint32_t GetSlot(entt::entity entity) const
+		{
+			uint32_t index = static_cast<uint32_t>(entt::to_entity(entity));
+			return index < Slots.size() ? Slots[index] : INVALID_WORLD_SLOT;
+		}
+	};
+
 	class Scene
 	{
 	public:
 		Scene();
-		~Scene() = default;
+		~Scene();
 
 		template<typename... Ts, typename Func>
 		void IterateComponents(Func&& func)
@@ -78,6 +101,20 @@ namespace Hydrogen
 		Entity GetEntityByEntityID(uint32_t id);
 		Entity GetEntityByUUID(uint64_t uuid);
 
+		// an invalid parent makes the entity a root, the local transform is kept as is
+		void SetParent(Entity child, Entity parent);
+		Entity GetParent(Entity entity);
+		std::vector<Entity> GetChildren(Entity entity);
+
+		// links entities added after the scene was loaded to their parents, their links have to be unset
+		void LinkHierarchy(const std::vector<entt::entity>& entities);
+
+		// rebuilds the world matrices of dirty subtrees in one pass over the depth sorted hierarchy
+		void UpdateTransforms();
+		// restores the depth order of the hierarchy pools after entities or parents changed, moves whole pools
+		void SortHierarchy();
+		const WorldTransformStream& GetWorldTransforms() const { return m_WorldTransforms; }
+
 		void UpdatePhysics(float timestep);
 		void IndexScripts();
 		void InitScripts();
@@ -88,18 +125,50 @@ namespace Hydrogen
 		json SerializeScene();
 		void DeserializeScene(const json& j);
 
+		// compact form for loading, the json form stays the one to diff and merge, in SceneBinary.cpp
+		// the overload only writes the given entities, see SceneBinaryLoader for loading over several frames
+		std::vector<uint8_t> SerializeSceneBinary();
+		std::vector<uint8_t> SerializeSceneBinary(const std::vector<entt::entity>& entities);
+		bool DeserializeSceneBinary(const uint8_t* data, size_t size);
+
 		PhysicsWorld& GetPhysicsWorld() { return m_PhysicsWorld; }
+		class SystemScheduler& GetSystems() { return *m_Systems; }
 
-		void Clone(Scene& clone)
-		{
-		}
+		// copies every entity into an empty scene through a binary snapshot, in SceneSnapshot.cpp
+		// physics bodies and script instances are not copied, the clone recreates them when it first runs
+		void Clone(Scene& clone);
+
+		// spawns count copies of a prefab in bulk, the roots of copy i are moved by offsets[i] when given, in Prefab.cpp
+		// returns the root entities of all copies, copy by copy
+		std::vector<Entity> Instantiate(class PrefabAsset& prefab, uint32_t count, const std::vector<glm::vec3>& offsets = {});
 
 		entt::registry& GetRegistry() { return m_Registry; }
 		
 	private:
+		void OnUUIDConstruct(entt::registry& registry, entt::entity entity);
+		void OnUUIDDestroy(entt::registry& registry, entt::entity entity);
+		void RemapUUID(entt::entity entity, uint64_t oldUUID, uint64_t newUUID);
+		void OnWorldLayoutChange(entt::registry& registry, entt::entity entity) { m_WorldLayoutDirty = true; }
+
+		void LinkChild(entt::entity child, entt::entity parent);
+		void UnlinkChild(entt::entity child);
+		void UpdateDepths(entt::entity root);
+		void RebuildHierarchy();
+		// the pass of UpdateTransforms, expects SortHierarchy to have run since the last change
+		void UpdateWorldTransforms();
+		void DestroyEntity(entt::entity entity);
+
+		// declared before the registry so it outlives the destroy signals
+		std::unordered_map<uint64_t, entt::entity> m_EntitiesByUUID;
+		bool m_HierarchyOrderDirty = true;
+
+		WorldTransformStream m_WorldTransforms;
+		bool m_WorldLayoutDirty = true;
+
 		entt::registry m_Registry;
 		PhysicsWorld m_PhysicsWorld;
 		std::unique_ptr<class ScriptSystem> m_ScriptSystem;
+		std::unique_ptr<class SystemScheduler> m_Systems;
 
 		friend class Entity;
 	};
@@ -136,10 +205,14 @@ namespace Hydrogen
 
 		void Delete();
 
+		// only components that ask for their entity in the constructor get it, plain data components stay free of it
 		template <typename T, typename... Args>
 		void AddComponent(Args&&... args)
 		{
-			m_Scene->m_Registry.emplace<T>(m_Entity, *this, std::forward<Args>(args)...);
+			if constexpr (std::is_constructible_v<T, Entity, Args...>)
+				m_Scene->m_Registry.emplace<T>(m_Entity, *this, std::forward<Args>(args)...);
+			else
+				m_Scene->m_Registry.emplace<T>(m_Entity, std::forward<Args>(args)...);
 		}
 
 		template <typename T>
@@ -175,7 +248,10 @@ namespace Hydrogen
 		template <typename T, typename... Args>
 		T& GetOrAddComponent(Args&&... args)
 		{
-			return m_Scene->m_Registry.get_or_emplace<T>(m_Entity, *this, std::forward<Args>(args)...);
+			if constexpr (std::is_constructible_v<T, Entity, Args...>)
+				return m_Scene->m_Registry.get_or_emplace<T>(m_Entity, *this, std::forward<Args>(args)...);
+			else
+				return m_Scene->m_Registry.get_or_emplace<T>(m_Entity, std::forward<Args>(args)...);
 		}
 
 	private:
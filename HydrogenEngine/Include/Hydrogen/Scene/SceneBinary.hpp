@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Scene.hpp"
+#include "Components.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Hydrogen
+{
+	// reflected types are stored as packed field columns, types with their own Serialize as json strings
+	enum class SceneBlockKind : uint8_t { Fields, Json };
+
+	// a binary scene parsed and checked without touching any scene, so it can be prepared on a worker thread
+	class SceneBinaryData
+	{
+	public:
+		bool Parse(std::vector<uint8_t> bytes);
+
+		uint32_t GetEntityCount() const { return static_cast<uint32_t>(m_UUIDs.size()); }
+
+		// distinct asset files the reflected fields refer to
+		std::vector<std::string> GetAssetNames() const;
+
+	private:
+		struct Column
+		{
+			uint32_t Name; // string index
+			FieldType Type;
+			size_t Offset; // of the first value in the bytes
+		};
+
+		struct Block
+		{
+			uint32_t Name;
+			SceneBlockKind Kind;
+			uint32_t Count;
+			size_t IndicesOffset;
+			size_t JsonOffset; // Json blocks, one string index per component
+			std::vector<Column> Columns; // Fields blocks
+		};
+
+		uint32_t ReadIndex(size_t offset, uint32_t i) const;
+
+		std::vector<uint8_t> m_Bytes;
+		std::vector<uint64_t> m_UUIDs;
+		std::vector<std::string> m_Strings;
+		std::vector<Block> m_Blocks;
+
+		friend class SceneBinaryLoader;
+	};
+
+	// instantiates parsed data into a scene a slice at a time, so the work can be spread over frames
+	// budgets are counted in components, entities are created all at once in the first step
+	class SceneBinaryLoader
+	{
+	public:
+		SceneBinaryLoader(Scene& scene, std::shared_ptr<const SceneBinaryData> data);
+
+		// returns the work done, at least one unit so every call makes progress
+		uint32_t Step(uint32_t budget);
+		bool IsDone() const { return m_Stage == Stage::Done; }
+
+		// valid after the first step, entities stay in the scene when the loader is dropped half way
+		const std::vector<entt::entity>& GetEntities() const { return m_Entities; }
+
+	private:
+		enum class Stage { Entities, Components, Hierarchy, Scripts, Done };
+
+		struct PendingPost
+		{
+			const ComponentRegistry::ComponentHandlers* Handlers;
+			entt::entity Entity;
+			json Value;
+		};
+
+		uint32_t LoadComponents(const SceneBinaryData::Block& block, uint32_t blockIndex, uint32_t begin, uint32_t count);
+		std::shared_ptr<Asset> ResolveAsset(uint32_t stringIndex);
+
+		Scene& m_Scene;
+		std::shared_ptr<const SceneBinaryData> m_Data;
+
+		Stage m_Stage = Stage::Entities;
+		uint32_t m_Block = 0;
+		size_t m_Next = 0;
+
+		std::vector<entt::entity> m_Entities;
+		std::vector<const ComponentRegistry::ComponentHandlers*> m_Handlers; // per block, null for unknown types
+		std::vector<std::vector<const FieldInfo*>> m_Targets; // per block and column, null for fields gone from the type
+		std::vector<PendingPost> m_PendingPost;
+
+		// assets are looked up once per distinct file name
+		std::vector<std::shared_ptr<Asset>> m_Assets;
+		std::vector<uint8_t> m_AssetResolved;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Scene.hpp"
+#include "Hydrogen/JobSystem.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Hydrogen
+{
+	#define MIN_ENTITIES_PER_SYSTEM_CHUNK 64
+
+	// components a system touches, systems whose access does not overlap may run at the same time
+	struct SystemAccess
+	{
+		std::vector<entt::id_type> Reads;
+		std::vector<entt::id_type> Writes;
+		bool Exclusive = false; // may touch any component or change the registry, ordered against every other system
+		bool MainThread = false; // runs on the thread that calls SystemScheduler::Run
+
+		template<typename... Ts>
+		SystemAccess& Read()
+		{
+			(Reads.push_back(entt::type_hash<Ts>::value()), ...);
+			return *this;
+		}
+
+		template<typename... Ts>
+		SystemAccess& Write()
+		{
+			(Writes.push_back(entt::type_hash<Ts>::value()), ...);
+			return *this;
+		}
+
+		bool ConflictsWith(const SystemAccess& other) const;
+	};
+
+	class SystemScheduler
+	{
+	public:
+		using SystemFunc = std::function<void(float dt)>;
+
+		// a system depends on every system added before it that it conflicts with
+		void AddSystem(std::string name, SystemAccess access, SystemFunc func);
+
+		// runs every system once, blocks until all of them finished
+		void Run(float dt);
+
+		// also usable from inside a system, chunks of the view run on the job system
+		template<typename... Ts, typename Func>
+		static void ParallelForEach(Scene* scene, Func&& func)
+		{
+			auto view = scene->GetRegistry().view<Ts...>();
+
+			JobSystem::Get().ParallelForEach(view, MIN_ENTITIES_PER_SYSTEM_CHUNK, [&](entt::entity entity)
+				{
+					func(Entity(entity, scene), view.template get<Ts>(entity)...);
+				});
+		}
+
+	private:
+		struct System
+		{
+			std::string Name;
+			SystemAccess Access;
+			SystemFunc Func;
+
+			std::vector<uint32_t> Dependents;
+			uint32_t DependencyCount = 0;
+		};
+
+		std::vector<System> m_Systems;
+	};
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Scene.hpp"
+#include "SceneBinary.hpp"
+#include "Hydrogen/JobSystem.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Hydrogen
+{
+	class Asset;
+
+	struct WorldCellCoord
+	{
+		int32_t X = 0;
+		int32_t Z = 0;
+
+		bool operator==(const WorldCellCoord& other) const { return X == other.X && Z == other.Z; }
+	};
+
+	enum class WorldCellState
+	{
+		Unloaded,
+		Reading, // the cell file is read and parsed on a worker
+		Preloading, // GPU resources of the cell's assets are created, a few per frame
+		Activating, // entities are in the scene, their components come in a slice per frame
+		Active,
+		Deactivating, // entities leave the scene a slice per frame
+		Failed
+	};
+
+	struct WorldPartitionSettings
+	{
+		// in cells, measured from the focus to the cell center
+		float LoadRadius = 1.5f;
+		float UnloadRadius = 2.5f; // beyond the load radius, so cells on the border do not flip every frame
+
+		uint32_t ActivationBudget = 4096; // components activated or entities removed per frame over all cells
+		uint32_t PreloadBudget = 4; // assets made resident per frame
+		uint32_t MaxPendingReads = 4;
+	};
+
+	// splits a large scene into square cells on the XZ plane, each stored as its own binary sub-scene
+	// cells around a focus are read on worker threads and moved into the scene over several frames
+	//
+	// a .hyworld manifest lists the cell size, the cells with their files and asset preload sets,
+	// and a persistent cell for entities that are always loaded, such as cameras and directional lights
+	class WorldPartition
+	{
+	public:
+		// loads the persistent cell right away, the rest follows the focus passed to Update
+		WorldPartition(Scene& scene, const std::string& manifestPath, WorldPartitionSettings settings = {});
+		~WorldPartition();
+
+		WorldPartition(const WorldPartition&) = delete;
+		WorldPartition& operator=(const WorldPartition&) = delete;
+
+		// sorts every root hierarchy of the scene into the cell under its root's world position
+		// and writes the cell files next to the manifest
+		static bool Build(Scene& source, const std::string& manifestPath, float cellSize);
+
+		// once per frame on the main thread, before the scene update
+		void Update(glm::vec3 focus);
+
+		float GetCellSize() const { return m_CellSize; }
+		WorldCellCoord GetCell(glm::vec3 position) const;
+		WorldCellState GetCellState(WorldCellCoord coord) const;
+		uint32_t GetActiveCellCount() const;
+
+	private:
+		struct Cell
+		{
+			WorldCellCoord Coord;
+			std::string File;
+			std::vector<std::string> AssetNames;
+
+			WorldCellState State = WorldCellState::Unloaded;
+			bool Wanted = false;
+			float Distance = 0.0f;
+
+			// filled by the read job, only touched on the main thread once the counter is done
+			std::unique_ptr<JobCounter> ReadCounter;
+			std::shared_ptr<SceneBinaryData> Data;
+			bool ReadFailed = false;
+
+			std::vector<std::shared_ptr<Asset>> Assets; // held while the cell is loaded
+			size_t NextAsset = 0;
+
+			std::unique_ptr<SceneBinaryLoader> Loader;
+			std::vector<entt::entity> Entities;
+			size_t NextEntity = 0;
+		};
+
+		void StartRead(Cell& cell);
+		bool Preload(Cell& cell, uint32_t& budget);
+		void Unload(Cell& cell, uint32_t& budget);
+
+		Scene& m_Scene;
+		WorldPartitionSettings m_Settings;
+		std::filesystem::path m_Directory;
+		float m_CellSize = 64.0f;
+
+		std::vector<std::unique_ptr<Cell>> m_Cells;
+		std::unordered_map<uint64_t, Cell*> m_CellsByCoord;
+	};
+}
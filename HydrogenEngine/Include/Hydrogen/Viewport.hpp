@@ -20,6 +20,7 @@ namespace Hydrogen
 		virtual int GetWidth() const = 0;
 		virtual int GetHeight() const = 0;
 		virtual int IsOpen() const = 0;
+		virtual bool IsHeadless() const { return false; }
 
 		virtual const std::vector<const char*> GetVulkanExtensions() const = 0;
 		virtual VkSurfaceKHR GetVulkanSurface() = 0;
@@ -31,6 +32,7 @@ namespace Hydrogen
 		Event<int, int>& GetResizeEvent() { return m_ResizeEvent; }
 
 		static std::shared_ptr<Viewport> Create(std::string name, int width = 0, int height = 0, int x = 0, int y = 0);
+		static std::shared_ptr<Viewport> CreateHeadless(int width, int height);
 		
 		virtual void LockCursor() = 0;
 		virtual void UnlockCursor() = 0;
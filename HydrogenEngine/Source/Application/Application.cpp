@@ -1,7 +1,9 @@
 #include "Hydrogen/Application.hpp"
 #include "Hydrogen/Logger.hpp"
+#include "Hydrogen/Core.hpp"
 #include "Hydrogen/Scene/Camera.hpp"
 #include "Hydrogen/Input.hpp"
+#include "Hydrogen/JobSystem.hpp"
 #include "Hydrogen/Scripting/ScriptEngine.hpp"
 
 #include <ImGuizmo.h>
@@ -34,10 +36,18 @@ void Application::Run()
 {
 	OnSetup();
 
+	JobSystem::Init();
 	ScriptEngine::Init();
 
 	HY_APP_INFO("Initializing app '{}' - Version {}.{}", ApplicationSpec.Name, ApplicationSpec.Version.x, ApplicationSpec.Version.y);
-	MainViewport = Viewport::Create(ApplicationSpec.ViewportTitle, (int)ApplicationSpec.ViewportSize.x, (int)ApplicationSpec.ViewportSize.y, (int)ApplicationSpec.ViewportPos.x, (int)ApplicationSpec.ViewportPos.y);
+	if (ApplicationSpec.Headless)
+	{
+		MainViewport = Viewport::CreateHeadless((int)ApplicationSpec.ViewportSize.x, (int)ApplicationSpec.ViewportSize.y);
+	}
+	else
+	{
+		MainViewport = Viewport::Create(ApplicationSpec.ViewportTitle, (int)ApplicationSpec.ViewportSize.x, (int)ApplicationSpec.ViewportSize.y, (int)ApplicationSpec.ViewportPos.x, (int)ApplicationSpec.ViewportPos.y);
+	}
 	MainViewport->GetResizeEvent().AddListener(std::bind(&Application::OnResize, this, std::placeholders::_1, std::placeholders::_2));
 	MainViewport->Open();
 
@@ -45,7 +55,8 @@ void Application::Run()
 
 	MainAssetManager.LoadAssets("Assets");
 
-	CurrentScene = MainAssetManager.GetAsset<SceneAsset>("Scene.hyscene");
+	CurrentScene = MainAssetManager.GetAsset<SceneAsset>(ApplicationSpec.StartupScene);
+	HY_ASSERT(CurrentScene, "Startup scene '{}' was not found", ApplicationSpec.StartupScene);
 	CurrentScene->Load(&MainAssetManager);
 
 	CurrentScene->GetScene()->IndexScripts();
@@ -63,7 +74,10 @@ void Application::Run()
 
 	m_CurrentSwapChainSpec.ColorPreference = ColorFormat::RGBA8_SRGB;
 	m_CurrentSwapChainSpec.VsyncPreference = PresentMode::Mailbox;
-	ActiveSwapChain = std::make_unique<SwapChain>(ActiveRenderDevice.get(), MainViewport->GetVulkanSurface(), m_CurrentSwapChainSpec);
+	if (!MainViewport->IsHeadless())
+	{
+		ActiveSwapChain = std::make_unique<SwapChain>(ActiveRenderDevice.get(), MainViewport->GetVulkanSurface(), m_CurrentSwapChainSpec);
+	}
 
 	OnStartup();
 
@@ -71,6 +85,7 @@ void Application::Run()
 	auto lastTime = clock::now();
 
 	accumulator = 0.0f;
+	m_FrameCount = 0;
 
 	while (MainViewport->IsOpen())
 	{
@@ -78,10 +93,11 @@ void Application::Run()
 
 		auto currentTime = clock::now();
 		std::chrono::duration<float> elapsed = currentTime - lastTime;
-		float deltaTime = elapsed.count();
+		float deltaTime = MainViewport->IsHeadless() ? timeStep : elapsed.count();
 		lastTime = currentTime;
 
 		Viewport::PumpMessages();
+		JobSystem::Get().RunMainThreadJobs();
 
 		if (MainViewport->GetWidth() == 0 || MainViewport->GetHeight() == 0)
 		{
@@ -103,6 +119,12 @@ void Application::Run()
 		}
 
 		Input::EndFrame();
+
+		m_FrameCount++;
+		if (ApplicationSpec.FrameLimit != 0 && m_FrameCount >= ApplicationSpec.FrameLimit)
+		{
+			MainViewport->Close();
+		}
 	}
 
 	ActiveRenderDevice->WaitForIdle();
@@ -116,6 +138,8 @@ void Application::Run()
 	ActiveSwapChain.reset();
 	ActiveRenderDevice.reset();
 	MainViewport.reset();
+
+	JobSystem::Shutdown();
 }
 
 void Application::PhysicsUpdate(float deltaTime)
@@ -156,7 +180,10 @@ void Application::ChangeRenderDevice(const RenderDeviceDescriptor& desc)
 
 	ActiveRenderDevice = std::make_unique<RenderDevice>(desc, MainViewport);
 
-	ActiveSwapChain = std::make_unique<SwapChain>(ActiveRenderDevice.get(), MainViewport->GetVulkanSurface(), m_CurrentSwapChainSpec);
+	if (!MainViewport->IsHeadless())
+	{
+		ActiveSwapChain = std::make_unique<SwapChain>(ActiveRenderDevice.get(), MainViewport->GetVulkanSurface(), m_CurrentSwapChainSpec);
+	}
 
 	OnRenderDeviceChangeFinish();
 }
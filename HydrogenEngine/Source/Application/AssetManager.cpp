@@ -8,25 +8,83 @@
 #include "stb_image_write.h"
 
 #include <shaderc/shaderc.hpp>
+#include "Tracy/Tracy.hpp"
+
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 using namespace Hydrogen;
 
-static const std::vector<uint32_t> CompileShader(const std::string& source, shaderc_shader_kind kind)
+// Quoted includes resolve next to the including file, angled includes from the asset directory
+class ShaderIncluder : public shaderc::CompileOptions::IncluderInterface
 {
-	shaderc::Compiler compiler;
-	shaderc::CompileOptions options;
+public:
+	ShaderIncluder(std::string rootDirectory, std::vector<std::string>* dependencies)
+		: m_RootDirectory(std::move(rootDirectory)), m_Dependencies(dependencies) {}
 
-	options.SetOptimizationLevel(shaderc_optimization_level_performance);
-	shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(
-		source, kind, "shader", options
-	);
+	shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t includeDepth) override
+	{
+		fs::path resolved = (type == shaderc_include_type_relative)
+			? fs::path(requestingSource).parent_path() / requestedSource
+			: fs::path(m_RootDirectory) / requestedSource;
 
-	HY_ASSERT(module.GetCompilationStatus() == shaderc_compilation_status_success, "Vulkan shader compilation failed: {}", module.GetErrorMessage());
-	return { module.cbegin(), module.cend() };
-}
+		auto* include = new IncludeData();
+
+		std::ifstream fin(resolved);
+		if (fin)
+		{
+			std::stringstream buffer;
+			buffer << fin.rdbuf();
+			fin.close();
+
+			include->SourceName = resolved.lexically_normal().string();
+			include->Content = buffer.str();
+
+			m_Dependencies->push_back(include->SourceName);
+		}
+		else
+		{
+			// an empty source name reports the content as the error message
+			include->Content = "Failed to open include '" + std::string(requestedSource) + "'";
+		}
+
+		include->Result.source_name = include->SourceName.c_str();
+		include->Result.source_name_length = include->SourceName.size();
+		include->Result.content = include->Content.c_str();
+		include->Result.content_length = include->Content.size();
+		include->Result.user_data = include;
+
+		return &include->Result;
+	}
+
+	void ReleaseInclude(shaderc_include_result* data) override
+	{
+		delete static_cast<IncludeData*>(data->user_data);
+	}
+
+private:
+	struct IncludeData
+	{
+		shaderc_include_result Result{};
+		std::string SourceName;
+		std::string Content;
+	};
+
+	std::string m_RootDirectory;
+	std::vector<std::string>* m_Dependencies;
+};
 
 void ShaderAsset::Compile()
 {
+	shaderc::Compiler compiler;
+	Compile(compiler);
+}
+
+void ShaderAsset::Compile(shaderc::Compiler& compiler)
+{
+	ZoneScoped;
+
 	std::string shaderStage = m_Config["preferences"]["stage"];
 
 	shaderc_shader_kind shaderKind = shaderc_vertex_shader;
@@ -38,13 +96,75 @@ void ShaderAsset::Compile()
 	{
 		shaderKind = shaderc_fragment_shader;
 	}
+	else if (shaderStage == "compute")
+	{
+		shaderKind = shaderc_compute_shader;
+	}
 	else
 	{
 		HY_ENGINE_ERROR("Unknown shader stage '{}' for '{}' -> Defaulting to vertex", shaderStage, m_Filepath);
 	}
 
-	HY_ENGINE_INFO("Compiling shader '{}'", m_Filepath);
-	m_ByteCode = CompileShader(m_Content, shaderKind);
+	HY_ENGINE_INFO("Compiling shader '{}' ({} defines)", m_Filepath, m_Defines.size());
+
+	m_Dependencies.clear();
+
+	shaderc::CompileOptions options;
+	options.SetOptimizationLevel(shaderc_optimization_level_performance);
+	options.SetIncluder(std::make_unique<ShaderIncluder>(Application::Get()->MainAssetManager.GetAssetDirectory(), &m_Dependencies));
+
+	for (const auto& [name, value] : m_Defines)
+	{
+		options.AddMacroDefinition(name, value);
+	}
+
+	shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(m_Content, shaderKind, m_Filepath.c_str(), options);
+
+	HY_ASSERT(module.GetCompilationStatus() == shaderc_compilation_status_success, "Vulkan shader compilation failed for '{}': {}", m_Filepath, module.GetErrorMessage());
+	m_ByteCode = { module.cbegin(), module.cend() };
+
+	UpdateContentHash();
+}
+
+std::string ShaderAsset::GetCachePath() const
+{
+	if (m_Defines.empty())
+	{
+		return "Caches/" + m_Filepath + ".hycache";
+	}
+
+	size_t hash = 0;
+	for (const auto& [name, value] : m_Defines)
+	{
+		HashCombine(hash, std::hash<std::string>{}(name));
+		HashCombine(hash, std::hash<std::string>{}(value));
+	}
+
+	return "Caches/" + m_Filepath + "." + std::to_string(hash) + ".hycache";
+}
+
+bool ShaderAsset::IsCacheValid() const
+{
+	std::string cachePath = GetCachePath();
+	if (!fs::exists(cachePath) || fs::last_write_time(cachePath) <= fs::last_write_time(m_Filepath))
+	{
+		return false;
+	}
+
+	std::ifstream depsIn(cachePath + ".deps");
+	std::string dependency;
+	while (std::getline(depsIn, dependency))
+	{
+		if (dependency.empty())
+			continue;
+
+		if (!fs::exists(dependency) || fs::last_write_time(cachePath) <= fs::last_write_time(dependency))
+		{
+			return false;
+		}
+	}
+
+	return true;
 }
 
 void AssetManager::LoadAssets(const std::string& directory)
@@ -56,10 +176,15 @@ void AssetManager::LoadAssets(const std::string& directory)
 
 	for (const auto& entry : fs::recursive_directory_iterator(directory))
 	{
-		if (!entry.is_regular_file() || entry.path().extension() == ".hyasset")
+		// .glslh files are shader headers, only reachable through #include
+		// .hyworld manifests and their .hycell files are streamed by WorldPartition instead of loaded up front
+		std::string ext = entry.path().extension().string();
+		if (!entry.is_regular_file() || ext == ".hyasset" || ext == ".glslh" || ext == ".hyworld" || ext == ".hycell")
 			continue;
 		LoadAsset(entry.path());
 	}
+
+	CompilePendingShaders();
 }
 
 void AssetManager::ReloadAsset(const std::string& path)
@@ -70,13 +195,13 @@ void AssetManager::ReloadAsset(const std::string& path)
 		return;
 	}
 	LoadAsset(std::filesystem::path(path));
+	CompilePendingShaders();
 }
 
 void AssetManager::LoadAsset(const std::filesystem::path& path)
 {
 	std::string ext = path.extension().string();
 	std::string filePath = path.string();
-	std::string cachePath = "Caches/" + filePath + ".hycache";
 
 	std::string assetFilePath = filePath + ".hyasset";
 
@@ -121,10 +246,14 @@ void AssetManager::LoadAsset(const std::filesystem::path& path)
 		{
 			assetType = "Script";
 		}
-		else if (ext == ".hyscene")
+		else if (ext == ".hyscene" || ext == ".hyscenebin")
 		{
 			assetType = "Scene";
 		}
+		else if (ext == ".hyprefab")
+		{
+			assetType = "Prefab";
+		}
 		else if (ext == ".hymat")
 		{
 			assetType = "Material";
@@ -153,18 +282,27 @@ void AssetManager::LoadAsset(const std::filesystem::path& path)
 
 	if (assetConfig["type"] == "Shader")
 	{
-		if (fs::exists(cachePath) && fs::last_write_time(cachePath) > fs::last_write_time(filePath))
-		{
-			auto shader = std::make_shared<ShaderAsset>(filePath, assetConfig);
-			shader->LoadCache(cachePath);
-			m_Assets[path.filename().string()] = std::move(shader);
-		}
-		else
+		LoadShader(filePath, path.filename().string(), assetConfig);
+
+		const auto& preferences = assetConfig["preferences"];
+		if (preferences.contains("permutations"))
 		{
-			auto shader = std::make_shared<ShaderAsset>(filePath, assetConfig);
-			shader->Compile();
-			shader->Cache();
-			m_Assets[path.filename().string()] = std::move(shader);
+			for (const auto& permutation : preferences["permutations"])
+			{
+				json permutationConfig = assetConfig;
+				permutationConfig["name"] = permutation.at("name");
+				permutationConfig["preferences"].erase("permutations");
+
+				if (permutation.contains("defines"))
+				{
+					for (const auto& [name, value] : permutation["defines"].items())
+					{
+						permutationConfig["preferences"]["defines"][name] = value;
+					}
+				}
+
+				LoadShader(filePath, permutation.at("name").get<std::string>(), permutationConfig);
+			}
 		}
 	}
 	else if (assetConfig["type"] == "Texture")
@@ -202,6 +340,11 @@ void AssetManager::LoadAsset(const std::filesystem::path& path)
 		auto scene = std::make_shared<SceneAsset>(filePath, assetConfig);
 		m_Assets[path.filename().string()] = std::move(scene);
 	}
+	else if (assetConfig["type"] == "Prefab")
+	{
+		auto prefab = std::make_shared<PrefabAsset>(filePath, assetConfig);
+		m_Assets[path.filename().string()] = std::move(prefab);
+	}
 	else if (assetConfig["type"] == "Material")
 	{
 		auto material = std::make_shared<MaterialAsset>(filePath, assetConfig);
@@ -223,6 +366,61 @@ void AssetManager::LoadAsset(const std::filesystem::path& path)
 	}
 }
 
+void AssetManager::LoadShader(const std::string& filePath, const std::string& name, const json& config)
+{
+	auto shader = std::make_shared<ShaderAsset>(filePath, config);
+
+	if (shader->IsCacheValid())
+	{
+		shader->LoadCache(shader->GetCachePath());
+	}
+	else
+	{
+		m_PendingShaders.push_back(shader);
+	}
+
+	m_Assets[name] = std::move(shader);
+}
+
+void AssetManager::CompilePendingShaders()
+{
+	if (m_PendingShaders.empty())
+	{
+		return;
+	}
+
+	ZoneScoped;
+
+	uint32_t threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, static_cast<uint32_t>(m_PendingShaders.size()));
+	std::atomic<size_t> nextShader = 0;
+
+	// shaderc::Compiler is not thread safe, every thread gets its own
+	auto compileWorker = [this, &nextShader]()
+	{
+		shaderc::Compiler compiler;
+		for (size_t i = nextShader++; i < m_PendingShaders.size(); i = nextShader++)
+		{
+			m_PendingShaders[i]->Compile(compiler);
+			m_PendingShaders[i]->Cache();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (uint32_t i = 1; i < threadCount; i++)
+	{
+		workers.emplace_back(compileWorker);
+	}
+
+	compileWorker();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	m_PendingShaders.clear();
+}
+
 const Texture* TextureAsset::GetTexture(RenderDevice* device)
 {
 	if (!m_Texture)
@@ -319,6 +517,26 @@ void SkeletonAsset::ReadAssetFile(const std::string& path)
 	fin.close();
 }
 
+template <typename VertexType>
+static MeshBounds ComputeBounds(const std::vector<VertexType>& vertices)
+{
+	MeshBounds bounds;
+	if (vertices.empty())
+	{
+		return bounds;
+	}
+
+	bounds.Min = bounds.Max = vertices[0].Position;
+	for (const auto& vertex : vertices)
+	{
+		glm::vec3 position = vertex.Position;
+		bounds.Min = glm::min(bounds.Min, position);
+		bounds.Max = glm::max(bounds.Max, position);
+	}
+
+	return bounds;
+}
+
 RenderBuffer* StaticMeshAsset::GetVertexBuffer()
 {
 	if (!m_VertexBuffer)
@@ -394,6 +612,8 @@ void StaticMeshAsset::ReadAssetFile(const std::string& path)
 	fin.read(reinterpret_cast<char*>(m_Indices.data()), indexCount * sizeof(uint32_t));
 
 	fin.close();
+
+	m_Bounds = ComputeBounds(m_Vertices);
 }
 
 RenderBuffer* SkeletalMeshAsset::GetVertexBuffer()
@@ -470,6 +690,8 @@ void SkeletalMeshAsset::ReadAssetFile(const std::string& path)
 	fin.read(reinterpret_cast<char*>(m_Indices.data()), indexCount * sizeof(uint32_t));
 
 	fin.close();
+
+	m_Bounds = ComputeBounds(m_Vertices);
 }
 
 void AnimationAsset::WriteAssetFile(const std::string& path)
@@ -554,11 +776,32 @@ void AnimationAsset::ReadAssetFile(const std::string& path)
 void SceneAsset::Load(AssetManager* assetManager)
 {
 	m_Scene = std::make_shared<Scene>();
+
+	if (IsBinary())
+	{
+		if (!m_Content.empty() && !m_Scene->DeserializeSceneBinary(reinterpret_cast<const uint8_t*>(m_Content.data()), m_Content.size()))
+		{
+			HY_ENGINE_ERROR("Failed to load binary scene '{}'", m_Filepath);
+			m_Scene = std::make_shared<Scene>();
+		}
+		return;
+	}
+
 	m_Scene->DeserializeScene(json::parse(m_Content));
 }
 
 void SceneAsset::Save() const
 {
+	if (IsBinary())
+	{
+		std::vector<uint8_t> content = m_Scene->SerializeSceneBinary();
+
+		std::ofstream fout(m_Filepath, std::ios::binary);
+		fout.write(reinterpret_cast<const char*>(content.data()), content.size());
+		fout.close();
+		return;
+	}
+
 	std::string content = m_Scene->SerializeScene().dump(4);
 
 	std::ofstream fout(m_Filepath);
@@ -0,0 +1,323 @@
+#include "Hydrogen/JobSystem.hpp"
+#include "Tracy/Tracy.hpp"
+
+#include <algorithm>
+
+using namespace Hydrogen;
+
+std::unique_ptr<JobSystem> JobSystem::s_Instance;
+
+// several job systems may exist at once (benchmarks), so a worker remembers which one it belongs to
+static thread_local const JobSystem* s_WorkerOwner = nullptr;
+static thread_local uint32_t s_WorkerIndex = 0;
+
+JobSystem::JobSystem(uint32_t workerCount)
+	: m_MainThread(std::this_thread::get_id())
+{
+	workerCount = std::min(workerCount, (uint32_t)MAX_JOB_THREADS - 1);
+
+	m_Queues.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; i++)
+	{
+		m_Queues.push_back(std::make_unique<WorkerQueue>());
+	}
+
+	m_Workers.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; i++)
+	{
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_Stop = true;
+	}
+	m_WakeCondition.notify_all();
+
+	for (auto& worker : m_Workers)
+	{
+		worker.join();
+	}
+}
+
+void JobSystem::Init(uint32_t workerCount)
+{
+	HY_ASSERT(!s_Instance, "The job system was already initialized");
+
+	if (workerCount == 0)
+	{
+		workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+	}
+
+	s_Instance = std::make_unique<JobSystem>(workerCount);
+	HY_ENGINE_INFO("Job system started with {} workers", s_Instance->GetWorkerCount());
+}
+
+void JobSystem::Shutdown()
+{
+	s_Instance.reset();
+}
+
+JobSystem& JobSystem::Get()
+{
+	HY_ASSERT(s_Instance, "The job system is used before JobSystem::Init");
+	return *s_Instance;
+}
+
+uint32_t JobSystem::GetCurrentThreadIndex() const
+{
+	return s_WorkerOwner == this ? s_WorkerIndex : GetWorkerCount();
+}
+
+void JobSystem::Submit(std::function<void()> func, JobCounter* counter, JobAffinity affinity)
+{
+	if (counter)
+	{
+		counter->m_Count++;
+	}
+
+	Enqueue({ std::move(func), counter, affinity });
+}
+
+void JobSystem::SubmitAfter(JobCounter& dependency, std::function<void()> func, JobCounter* counter, JobAffinity affinity)
+{
+	// counted right away, so waiting on counter also covers the time spent waiting for the dependency
+	if (counter)
+	{
+		counter->m_Count++;
+	}
+
+	Job job = { std::move(func), counter, affinity };
+	{
+		std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+		if (dependency.m_Count.load() != 0)
+		{
+			dependency.m_Continuations.push_back(std::move(job));
+			return;
+		}
+	}
+
+	Enqueue(std::move(job));
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	ZoneScoped;
+
+	bool mainThread = IsMainThread();
+	while (counter.m_Count.load() != 0)
+	{
+		if (mainThread)
+		{
+			Job job;
+			bool hasJob = false;
+			{
+				std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+				if (!m_MainThreadJobs.empty())
+				{
+					job = std::move(m_MainThreadJobs.front());
+					m_MainThreadJobs.pop_front();
+					hasJob = true;
+				}
+			}
+
+			if (hasJob)
+			{
+				Execute(job);
+				continue;
+			}
+		}
+
+		if (!TryRunJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// the last Signal may still hold the counter's lock, the caller is free to destroy it once this returns
+	std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+	ZoneScoped;
+	HY_ASSERT(IsMainThread(), "Main thread jobs have to run on the main thread");
+
+	std::deque<Job> jobs;
+	{
+		std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+		jobs.swap(m_MainThreadJobs);
+	}
+
+	for (auto& job : jobs)
+	{
+		Execute(job);
+	}
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t minChunkSize, const std::function<void(uint32_t begin, uint32_t end)>& func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// a few chunks per thread leave room for stealing when items differ in cost
+	uint32_t chunkCount = std::min(std::max(1u, count / std::max(1u, minChunkSize)), GetThreadCount() * 4);
+	if (chunkCount == 1)
+	{
+		func(0, count);
+		return;
+	}
+
+	uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+	chunkCount = (count + chunkSize - 1) / chunkSize;
+
+	JobCounter counter;
+	for (uint32_t chunk = 1; chunk < chunkCount; chunk++)
+	{
+		uint32_t begin = chunk * chunkSize;
+		uint32_t end = std::min(begin + chunkSize, count);
+
+		Submit([&func, begin, end]() { func(begin, end); }, &counter);
+	}
+
+	func(0, std::min(chunkSize, count));
+	Wait(counter);
+}
+
+void JobSystem::Enqueue(Job job)
+{
+	if (job.Affinity == JobAffinity::MainThread)
+	{
+		std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+		m_MainThreadJobs.push_back(std::move(job));
+		return;
+	}
+
+	if (m_Queues.empty())
+	{
+		Execute(job);
+		return;
+	}
+
+	// threads outside the pool spread their jobs, workers keep theirs local
+	uint32_t queueIndex = s_WorkerOwner == this ? s_WorkerIndex : m_NextQueue.fetch_add(1) % static_cast<uint32_t>(m_Queues.size());
+	{
+		// counted before the push, a thief that pops the job right away must not take the count below zero
+		std::lock_guard<std::mutex> lock(m_Queues[queueIndex]->Mutex);
+		m_QueuedJobs++;
+		m_Queues[queueIndex]->Jobs.push_back(std::move(job));
+	}
+
+	// taking the lock orders this against a worker that is about to sleep
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+	}
+	m_WakeCondition.notify_one();
+}
+
+bool JobSystem::TryRunJob()
+{
+	Job job;
+	if (!PopJob(job))
+	{
+		return false;
+	}
+
+	Execute(job);
+	return true;
+}
+
+bool JobSystem::PopJob(Job& outJob)
+{
+	uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+	if (queueCount == 0 || m_QueuedJobs.load() == 0)
+	{
+		return false;
+	}
+
+	bool isWorker = s_WorkerOwner == this;
+	if (isWorker)
+	{
+		WorkerQueue& own = *m_Queues[s_WorkerIndex];
+		std::lock_guard<std::mutex> lock(own.Mutex);
+		if (!own.Jobs.empty())
+		{
+			outJob = std::move(own.Jobs.back());
+			own.Jobs.pop_back();
+			m_QueuedJobs--;
+			return true;
+		}
+	}
+
+	uint32_t start = isWorker ? s_WorkerIndex + 1 : 0;
+	for (uint32_t i = 0; i < queueCount; i++)
+	{
+		WorkerQueue& victim = *m_Queues[(start + i) % queueCount];
+		std::lock_guard<std::mutex> lock(victim.Mutex);
+		if (!victim.Jobs.empty())
+		{
+			outJob = std::move(victim.Jobs.front());
+			victim.Jobs.pop_front();
+			m_QueuedJobs--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::Execute(Job& job)
+{
+	job.Func();
+
+	if (job.Counter)
+	{
+		Signal(job.Counter);
+	}
+}
+
+void JobSystem::Signal(JobCounter* counter)
+{
+	std::vector<Job> continuations;
+	{
+		std::lock_guard<std::mutex> lock(counter->m_Mutex);
+		if (--counter->m_Count != 0)
+		{
+			return;
+		}
+
+		continuations.swap(counter->m_Continuations);
+	}
+
+	for (auto& continuation : continuations)
+	{
+		Enqueue(std::move(continuation));
+	}
+}
+
+void JobSystem::WorkerLoop(uint32_t workerIndex)
+{
+	tracy::SetThreadName("Job Worker");
+	s_WorkerOwner = this;
+	s_WorkerIndex = workerIndex;
+
+	while (true)
+	{
+		if (TryRunJob())
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_WakeCondition.wait(lock, [this]() { return m_Stop || m_QueuedJobs.load() > 0; });
+		if (m_Stop)
+		{
+			return;
+		}
+	}
+}
@@ -1,8 +1,14 @@
 #include "Hydrogen/Viewport.hpp"
+#include "Hydrogen/Platform/Headless/HeadlessViewport.hpp"
+#include "Hydrogen/Logger.hpp"
+
+#ifdef HY_SYSTEM_WINDOWS
 #include "Hydrogen/Platform/Windows/WindowsViewport.hpp"
+#endif
 
 using namespace Hydrogen;
 
+#ifdef HY_SYSTEM_WINDOWS
 void Viewport::PumpMessages()
 {
 	return WindowsViewport::PumpMessages();
@@ -12,3 +18,40 @@ std::shared_ptr<Viewport> Viewport::Create(std::string name, int width, int heig
 {
 	return std::make_shared<WindowsViewport>(name, width, height, x, y);
 }
+#else
+void Viewport::PumpMessages()
+{
+}
+
+std::shared_ptr<Viewport> Viewport::Create(std::string name, int width, int height, int x, int y)
+{
+	HY_ENGINE_WARN("No windowing backend on this platform, creating headless viewport for '{}'", name);
+	return std::make_shared<HeadlessViewport>(width, height);
+}
+
+void Viewport::ConfineCursor(float left, float right, float top, float bottom)
+{
+}
+
+void Viewport::ReleaseCursor()
+{
+}
+
+void Viewport::ViewportShowCursor()
+{
+}
+
+void Viewport::ViewportHideCursor()
+{
+}
+
+std::string Viewport::OpenFolderDialog()
+{
+	return "";
+}
+#endif
+
+std::shared_ptr<Viewport> Viewport::CreateHeadless(int width, int height)
+{
+	return std::make_shared<HeadlessViewport>(width, height);
+}
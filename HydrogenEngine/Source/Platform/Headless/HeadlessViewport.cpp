@@ -0,0 +1,50 @@
+#include "Hydrogen/Platform/Headless/HeadlessViewport.hpp"
+#include "Hydrogen/Core.hpp"
+
+#include "imgui.h"
+
+using namespace Hydrogen;
+
+HeadlessViewport::HeadlessViewport(int width, int height)
+	: m_Width(width), m_Height(height), m_IsOpen(false)
+{
+	HY_ASSERT(width > 0 && height > 0, "Headless viewport requires a non-zero size, got {}x{}", width, height);
+}
+
+HeadlessViewport::~HeadlessViewport()
+{
+	Close();
+}
+
+void HeadlessViewport::Open()
+{
+	m_IsOpen = true;
+}
+
+void HeadlessViewport::Close()
+{
+	m_IsOpen = false;
+}
+
+const std::vector<const char*> HeadlessViewport::GetVulkanExtensions() const
+{
+	// No surface, so no WSI instance extensions are required
+	return {};
+}
+
+void HeadlessViewport::ImGuiNewFrame() const
+{
+	ImGuiIO& io = ImGui::GetIO();
+	io.DisplaySize = ImVec2((float)m_Width, (float)m_Height);
+}
+
+void HeadlessViewport::InitImGui() const
+{
+	ImGuiIO& io = ImGui::GetIO();
+	io.DisplaySize = ImVec2((float)m_Width, (float)m_Height);
+	io.ConfigFlags &= ~ImGuiConfigFlags_ViewportsEnable;
+}
+
+void HeadlessViewport::ImGuiShutdown() const
+{
+}
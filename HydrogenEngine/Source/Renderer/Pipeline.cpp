@@ -221,38 +221,7 @@ Pipeline::Pipeline(RenderDevice* device, VkRenderPass renderPass, const std::sha
 	colorBlending.blendConstants[2] = 0.0f;
 	colorBlending.blendConstants[3] = 0.0f;
 
-	m_VkPushConstantsRanges.resize(spec.PushConstants.size());
-	uint32_t pushConstantRangeOffset = 0;
-	for (size_t i = 0; i < spec.PushConstants.size(); i++)
-	{
-		m_VkPushConstantsRanges[i].offset = pushConstantRangeOffset;
-		m_VkPushConstantsRanges[i].size = (uint32_t)spec.PushConstants[i].Size;
-		m_VkPushConstantsRanges[i].stageFlags = 0;
-
-		if (((uint32_t)spec.PushConstants[i].StageFlags & (uint32_t)ShaderStage::Vertex) == (uint32_t)ShaderStage::Vertex)
-		{
-			m_VkPushConstantsRanges[i].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
-		}
-		if (((uint32_t)spec.PushConstants[i].StageFlags & (uint32_t)ShaderStage::Fragment) == (uint32_t)ShaderStage::Fragment)
-		{
-			m_VkPushConstantsRanges[i].stageFlags |= VK_SHADER_STAGE_FRAGMENT_BIT;
-		}
-
-		pushConstantRangeOffset += (uint32_t)spec.PushConstants[i].Size;
-	}
-
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(spec.DescriptorSetLayouts.size());
-	pipelineLayoutInfo.pSetLayouts = spec.DescriptorSetLayouts.data();
-	pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(spec.PushConstants.size());
-	pipelineLayoutInfo.pPushConstantRanges = m_VkPushConstantsRanges.data();
-
-	VkResult result = vkCreatePipelineLayout(m_Device->GetVulkanDevice(), &pipelineLayoutInfo, nullptr, &m_Layout);
-	if (result != VK_SUCCESS)
-	{
-		HY_ENGINE_FATAL("Failed to create Vulkan pipeline layout... vkCreatePipelineLayout returned {}", (uint16_t)result);
-	}
+	CreatePipelineLayout();
 
 	VkPipelineDepthStencilStateCreateInfo depthStencil{};
 	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
@@ -298,7 +267,7 @@ Pipeline::Pipeline(RenderDevice* device, VkRenderPass renderPass, const std::sha
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 	pipelineInfo.basePipelineIndex = -1;
 
-	result = vkCreateGraphicsPipelines(m_Device->GetVulkanDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline);
+	VkResult result = vkCreateGraphicsPipelines(m_Device->GetVulkanDevice(), m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
 	if (result != VK_SUCCESS)
 	{
 		HY_ENGINE_FATAL("Failed to create Vulkan pipeline... vkCreateGraphicsPipelines returned {}", (uint16_t)result);
@@ -308,6 +277,35 @@ Pipeline::Pipeline(RenderDevice* device, VkRenderPass renderPass, const std::sha
 	vkDestroyShaderModule(m_Device->GetVulkanDevice(), fragmentShaderModule, nullptr);
 }
 
+Pipeline::Pipeline(RenderDevice* device, const std::shared_ptr<ShaderAsset>& computeShader, PipelineSpec spec)
+	: m_Device(device), m_Spec(spec), m_BindPoint(VK_PIPELINE_BIND_POINT_COMPUTE)
+{
+	VkShaderModule computeShaderModule = CreateShaderModule(computeShader->GetByteCode());
+
+	VkPipelineShaderStageCreateInfo compShaderStageInfo{};
+	compShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	compShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	compShaderStageInfo.module = computeShaderModule;
+	compShaderStageInfo.pName = m_Spec.ComputeMain.c_str();
+
+	CreatePipelineLayout();
+
+	VkComputePipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage = compShaderStageInfo;
+	pipelineInfo.layout = m_Layout;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+	pipelineInfo.basePipelineIndex = -1;
+
+	VkResult result = vkCreateComputePipelines(m_Device->GetVulkanDevice(), m_Device->GetPipelineCache(), 1, &pipelineInfo, nullptr, &m_Pipeline);
+	if (result != VK_SUCCESS)
+	{
+		HY_ENGINE_FATAL("Failed to create Vulkan compute pipeline... vkCreateComputePipelines returned {}", (uint16_t)result);
+	}
+
+	vkDestroyShaderModule(m_Device->GetVulkanDevice(), computeShaderModule, nullptr);
+}
+
 Pipeline::~Pipeline()
 {
 	vkDestroyPipeline(m_Device->GetVulkanDevice(), m_Pipeline, nullptr);
@@ -331,6 +329,51 @@ VkShaderModule Pipeline::CreateShaderModule(const std::vector<uint32_t>& byteCod
 	return shaderModule;
 }
 
+void Pipeline::CreatePipelineLayout()
+{
+	m_VkPushConstantsRanges.resize(m_Spec.PushConstants.size());
+	uint32_t pushConstantRangeOffset = 0;
+	for (size_t i = 0; i < m_Spec.PushConstants.size(); i++)
+	{
+		m_VkPushConstantsRanges[i].offset = pushConstantRangeOffset;
+		m_VkPushConstantsRanges[i].size = (uint32_t)m_Spec.PushConstants[i].Size;
+		m_VkPushConstantsRanges[i].stageFlags = GetVkShaderStageFlags(m_Spec.PushConstants[i].StageFlags);
+
+		pushConstantRangeOffset += (uint32_t)m_Spec.PushConstants[i].Size;
+	}
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(m_Spec.DescriptorSetLayouts.size());
+	pipelineLayoutInfo.pSetLayouts = m_Spec.DescriptorSetLayouts.data();
+	pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(m_Spec.PushConstants.size());
+	pipelineLayoutInfo.pPushConstantRanges = m_VkPushConstantsRanges.data();
+
+	VkResult result = vkCreatePipelineLayout(m_Device->GetVulkanDevice(), &pipelineLayoutInfo, nullptr, &m_Layout);
+	if (result != VK_SUCCESS)
+	{
+		HY_ENGINE_FATAL("Failed to create Vulkan pipeline layout... vkCreatePipelineLayout returned {}", (uint16_t)result);
+	}
+}
+
+VkShaderStageFlags Pipeline::GetVkShaderStageFlags(ShaderStage stageFlags)
+{
+	VkShaderStageFlags vkStageFlags = 0;
+	if (((uint32_t)stageFlags & (uint32_t)ShaderStage::Vertex) == (uint32_t)ShaderStage::Vertex)
+	{
+		vkStageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
+	}
+	if (((uint32_t)stageFlags & (uint32_t)ShaderStage::Fragment) == (uint32_t)ShaderStage::Fragment)
+	{
+		vkStageFlags |= VK_SHADER_STAGE_FRAGMENT_BIT;
+	}
+	if (((uint32_t)stageFlags & (uint32_t)ShaderStage::Compute) == (uint32_t)ShaderStage::Compute)
+	{
+		vkStageFlags |= VK_SHADER_STAGE_COMPUTE_BIT;
+	}
+	return vkStageFlags;
+}
+
 VkDescriptorSetLayout Pipeline::CreateDescriptorSetLayout(RenderDevice* device, const std::vector<DescriptorBinding>& bindings)
 {
 	std::vector<VkDescriptorSetLayoutBinding> uboLayoutBindings(bindings.size());
@@ -360,18 +403,14 @@ VkDescriptorSetLayout Pipeline::CreateDescriptorSetLayout(RenderDevice* device,
 		case DescriptorType::CombinedImageSampler:
 			uboLayoutBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 			break;
+		case DescriptorType::StorageImage:
+			uboLayoutBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			break;
 		default:
 			HY_ASSERT(false, "Invalid Descriptor Type");
 		}
 
-		if (((uint32_t)bindings[i].StageFlags & (uint32_t)ShaderStage::Vertex) == (uint32_t)ShaderStage::Vertex)
-		{
-			uboLayoutBindings[i].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
-		}
-		if (((uint32_t)bindings[i].StageFlags & (uint32_t)ShaderStage::Fragment) == (uint32_t)ShaderStage::Fragment)
-		{
-			uboLayoutBindings[i].stageFlags |= VK_SHADER_STAGE_FRAGMENT_BIT;
-		}
+		uboLayoutBindings[i].stageFlags = GetVkShaderStageFlags(bindings[i].StageFlags);
 
 		uboLayoutBindings[i].descriptorCount = bindings[i].Count;
 	}
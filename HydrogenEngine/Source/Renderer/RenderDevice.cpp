@@ -3,11 +3,14 @@
 #include "Hydrogen/Core.hpp"
 
 #include <set>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
 
 using namespace Hydrogen;
 
 RenderDevice::RenderDevice(const RenderDeviceDescriptor& deviceDesc, const std::shared_ptr<Viewport>& viewport)
-	: m_Descriptor(deviceDesc)
+	: m_Descriptor(deviceDesc), m_Headless(viewport->IsHeadless())
 {
 	HY_ENGINE_INFO("Creating render device {} (type: {}, VRAM: {} bytes)", deviceDesc.Name, (uint16_t)deviceDesc.Type, deviceDesc.VramBytes);
 
@@ -15,7 +18,7 @@ RenderDevice::RenderDevice(const RenderDeviceDescriptor& deviceDesc, const std::
 	m_QueueFamilyIndices = FindQueueFamilies(m_PhysicalDevice, viewport);
 
 	HY_ASSERT(m_QueueFamilyIndices.IsComplete(), "Failed to find required queue families for render device {}", deviceDesc.Name);
-	HY_ASSERT(CheckDeviceExtensionSupport(m_PhysicalDevice, GetRequiredDeviceExtensions()), "Render device {} does not support required extensions", deviceDesc.Name);
+	HY_ASSERT(CheckDeviceExtensionSupport(m_PhysicalDevice, GetRequiredDeviceExtensions(m_Headless)), "Render device {} does not support required extensions", deviceDesc.Name);
 
 	CreateLogicalDevice();
 
@@ -50,10 +53,15 @@ RenderDevice::RenderDevice(const RenderDeviceDescriptor& deviceDesc, const std::
 	{
 		HY_ENGINE_FATAL("Failed to create Vulkan command pool... vkCreateCommandPool returned {}", (uint16_t)result);
 	}
+
+	CreatePipelineCache();
 }
 
 RenderDevice::~RenderDevice()
 {
+	SavePipelineCache();
+	vkDestroyPipelineCache(m_Device, m_PipelineCache, nullptr);
+
 	vmaDestroyAllocator(m_Allocator);
 	vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
 	vkDestroyDevice(m_Device, nullptr);
@@ -64,10 +72,36 @@ void RenderDevice::WaitForIdle() const
 	vkDeviceWaitIdle(m_Device);
 }
 
+void RenderDevice::SavePipelineCache() const
+{
+	size_t size = 0;
+	VkResult result = vkGetPipelineCacheData(m_Device, m_PipelineCache, &size, nullptr);
+	if (result != VK_SUCCESS || size == 0)
+	{
+		return;
+	}
+
+	std::vector<char> data(size);
+	result = vkGetPipelineCacheData(m_Device, m_PipelineCache, &size, data.data());
+	if (result != VK_SUCCESS)
+	{
+		HY_ENGINE_WARN("Failed to read Vulkan pipeline cache... vkGetPipelineCacheData returned {}", (uint16_t)result);
+		return;
+	}
+
+	std::filesystem::create_directories(std::filesystem::path(PIPELINE_CACHE_PATH).parent_path());
+
+	std::ofstream fout(PIPELINE_CACHE_PATH, std::ios::binary);
+	fout.write(data.data(), size);
+	fout.close();
+
+	HY_ENGINE_INFO("Saved pipeline cache ({} bytes)", size);
+}
+
 bool RenderDevice::CheckDeviceSuitability(VkPhysicalDevice device, const std::shared_ptr<Viewport>& viewport)
 {
 	QueueFamilyIndices indices = FindQueueFamilies(device, viewport);
-	return indices.IsComplete() && CheckDeviceExtensionSupport(device, GetRequiredDeviceExtensions());
+	return indices.IsComplete() && CheckDeviceExtensionSupport(device, GetRequiredDeviceExtensions(viewport->IsHeadless()));
 }
 
 bool RenderDevice::CheckDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char*>& extensions)
@@ -101,8 +135,12 @@ RenderDevice::QueueFamilyIndices RenderDevice::FindQueueFamilies(VkPhysicalDevic
 	int i = 0;
 	for (const auto& queueFamily : queueFamilies)
 	{
-		VkBool32 presentSupport = false;
-		vkGetPhysicalDeviceSurfaceSupportKHR(device, i, viewport->GetVulkanSurface(), &presentSupport);
+		// Without a surface nothing is presented, the graphics queue stands in for the present queue
+		VkBool32 presentSupport = viewport->IsHeadless();
+		if (!viewport->IsHeadless())
+		{
+			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, viewport->GetVulkanSurface(), &presentSupport);
+		}
 
 		if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
 		{
@@ -120,8 +158,13 @@ RenderDevice::QueueFamilyIndices RenderDevice::FindQueueFamilies(VkPhysicalDevic
 	return indices;
 }
 
-const std::vector<const char*> RenderDevice::GetRequiredDeviceExtensions()
+const std::vector<const char*> RenderDevice::GetRequiredDeviceExtensions(bool headless)
 {
+	if (headless)
+	{
+		return {};
+	}
+
 	return { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 }
 
@@ -141,7 +184,7 @@ void RenderDevice::CreateLogicalDevice()
 		queueCreateInfos.push_back(queueCreateInfo);
 	}
 
-	const std::vector<const char*> deviceExtensions = GetRequiredDeviceExtensions();
+	const std::vector<const char*> deviceExtensions = GetRequiredDeviceExtensions(m_Headless);
 
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.fillModeNonSolid = VK_TRUE;
@@ -170,3 +213,59 @@ void RenderDevice::CreateLogicalDevice()
 		HY_ENGINE_FATAL("Failed to create Vulkan device... vkCreateDevice returned {}", (uint16_t)result);
 	}
 }
+
+void RenderDevice::CreatePipelineCache()
+{
+	std::vector<char> data;
+
+	std::ifstream fin(PIPELINE_CACHE_PATH, std::ios::binary | std::ios::ate);
+	if (fin)
+	{
+		std::streamsize fileSize = fin.tellg();
+		fin.seekg(0, std::ios::beg);
+
+		data.resize(fileSize);
+		fin.read(data.data(), fileSize);
+		fin.close();
+
+		if (!IsPipelineCacheCompatible(data))
+		{
+			HY_ENGINE_WARN("Discarding pipeline cache '{}', it was created by a different device or driver", PIPELINE_CACHE_PATH);
+			data.clear();
+		}
+		else
+		{
+			HY_ENGINE_INFO("Using cached pipelines from '{}' ({} bytes)", PIPELINE_CACHE_PATH, data.size());
+		}
+	}
+
+	VkPipelineCacheCreateInfo cacheInfo{};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cacheInfo.initialDataSize = data.size();
+	cacheInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+	VkResult result = vkCreatePipelineCache(m_Device, &cacheInfo, nullptr, &m_PipelineCache);
+	if (result != VK_SUCCESS)
+	{
+		HY_ENGINE_FATAL("Failed to create Vulkan pipeline cache... vkCreatePipelineCache returned {}", (uint16_t)result);
+	}
+}
+
+bool RenderDevice::IsPipelineCacheCompatible(const std::vector<char>& data) const
+{
+	if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+	{
+		return false;
+	}
+
+	VkPipelineCacheHeaderVersionOne header{};
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+
+	return header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+		&& header.vendorID == properties.vendorID
+		&& header.deviceID == properties.deviceID
+		&& std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
@@ -3,9 +3,18 @@
 #include "Tracy/Tracy.hpp"
 
 #include <deque>
+#include <algorithm>
+#include <chrono>
 
 using namespace Hydrogen;
 
+using RgClock = std::chrono::high_resolution_clock;
+
+static double MillisecondsSince(RgClock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(RgClock::now() - start).count();
+}
+
 static size_t HashTextureDesc(const RgTextureDesc& desc)
 {
 	size_t seed = 0;
@@ -87,51 +96,133 @@ void RgCommandList::PushConstants(const void* data, uint32_t size, uint32_t offs
 {
 	HY_ASSERT(m_BoundPipeline, "No pipeline bound in PushConstants");
 
-	VkShaderStageFlags vkStageFlags = 0;
-	if (((uint32_t)stageFlags & (uint32_t)ShaderStage::Vertex) == (uint32_t)ShaderStage::Vertex)
+	VkShaderStageFlags vkStageFlags = Pipeline::GetVkShaderStageFlags(stageFlags);
+	vkCmdPushConstants(m_CmdBuf, m_BoundPipeline->GetPipelineLayout(), vkStageFlags, offset, size, data);
+}
+
+void RgCommandList::BindDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout)
+{
+	std::vector<VkDescriptorSet> sets;
+	if (m_FrameDescriptorSet != VK_NULL_HANDLE)
 	{
-		vkStageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
+		sets.push_back(m_FrameDescriptorSet);
 	}
-	if (((uint32_t)stageFlags & (uint32_t)ShaderStage::Fragment) == (uint32_t)ShaderStage::Fragment)
+	if (m_PassDescriptorSet != VK_NULL_HANDLE)
 	{
-		vkStageFlags |= VK_SHADER_STAGE_FRAGMENT_BIT;
+		sets.push_back(m_PassDescriptorSet);
 	}
 
-	vkCmdPushConstants(m_CmdBuf, m_BoundPipeline->GetPipelineLayout(), vkStageFlags, offset, size, data);
+	if (sets.size() > 0)
+	{
+		vkCmdBindDescriptorSets(m_CmdBuf, bindPoint, layout, 0, static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+		m_Stats.DescriptorSetBindCount++;
+	}
 }
 
-void RgCommandList::BindPipeline(const std::shared_ptr<ShaderAsset>& vertexShader, const std::shared_ptr<ShaderAsset>& fragmentShader, PipelineSpec spec)
+RgPipelineHandle RgPipelineLibrary::Register(const RgPipelineDesc& desc)
 {
-	spec.DescriptorSetLayouts = m_DescriptorSetLayouts;
+	auto it = m_DescLookup.find(desc.Hash);
+	if (it != m_DescLookup.end())
+	{
+		return it->second;
+	}
 
-	size_t hash = spec.Hash();
-	HashCombine(hash, std::hash<std::string>{}(vertexShader->GetContent()));
-	HashCombine(hash, std::hash<std::string>{}(fragmentShader->GetContent()));
-	HashCombine(hash, reinterpret_cast<size_t>(m_RenderPass));
+	RgPipelineHandle handle{ static_cast<uint32_t>(m_Descs.size()) };
+	m_Descs.push_back(desc);
+	m_DescLookup[desc.Hash] = handle;
+
+	return handle;
+}
+
+Pipeline* RgPipelineLibrary::GetOrCreate(RgPipelineHandle pipeline, VkRenderPass renderPass, const std::vector<VkDescriptorSetLayout>& layouts, size_t layoutHash)
+{
+	HY_ASSERT(pipeline.IsValid() && pipeline.Id < m_Descs.size(), "Invalid pipeline handle in BindPipeline");
+	size_t key = GetPipelineKey(pipeline, renderPass, layoutHash);
 
-	if (m_PipelineCache.find(hash) == m_PipelineCache.end())
 	{
-		m_PipelineCache[hash] = std::make_unique<Pipeline>(m_Device, m_RenderPass, vertexShader, fragmentShader, spec);
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Pipelines.find(key);
+		if (it != m_Pipelines.end())
+		{
+			return it->second.get();
+		}
 	}
-	
-	std::vector<VkDescriptorSet> sets;
-	if (m_FrameDescriptorSet != VK_NULL_HANDLE)
+
+	ZoneScopedN("Create Pipeline");
+
+	const auto& desc = m_Descs[pipeline.Id];
+
+	PipelineSpec spec = desc.Spec;
+	spec.DescriptorSetLayouts = layouts;
+
+	std::unique_ptr<Pipeline> newPipeline;
+	if (desc.ComputeShader)
 	{
-		sets.push_back(m_FrameDescriptorSet);
+		newPipeline = std::make_unique<Pipeline>(m_Device, desc.ComputeShader, spec);
 	}
-	if (m_PassDescriptorSet != VK_NULL_HANDLE)
+	else
 	{
-		sets.push_back(m_PassDescriptorSet);
+		newPipeline = std::make_unique<Pipeline>(m_Device, renderPass, desc.VertexShader, desc.FragmentShader, spec);
 	}
 
-	if (sets.size() > 0)
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	// another thread may have created the same pipeline in the meantime, keep the first one
+	auto [it, inserted] = m_Pipelines.try_emplace(key, std::move(newPipeline));
+	return it->second.get();
+}
+
+bool RgPipelineLibrary::Contains(RgPipelineHandle pipeline, VkRenderPass renderPass, size_t layoutHash)
+{
+	size_t key = GetPipelineKey(pipeline, renderPass, layoutHash);
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Pipelines.find(key) != m_Pipelines.end();
+}
+
+size_t RgPipelineLibrary::HashLayouts(const std::vector<VkDescriptorSetLayout>& layouts)
+{
+	size_t hash = 0;
+	for (auto layout : layouts)
 	{
-		vkCmdBindDescriptorSets(m_CmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineCache[hash]->GetPipelineLayout(), 0, static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+		HashCombine(hash, reinterpret_cast<size_t>(layout));
 	}
-	
-	vkCmdBindPipeline(m_CmdBuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineCache[hash]->GetPipeline());
+	return hash;
+}
 
-	m_BoundPipeline = m_PipelineCache.at(hash).get();
+size_t RgPipelineLibrary::GetPipelineKey(RgPipelineHandle pipeline, VkRenderPass renderPass, size_t layoutHash) const
+{
+	size_t key = m_Descs[pipeline.Id].Hash;
+	HashCombine(key, layoutHash);
+	HashCombine(key, reinterpret_cast<size_t>(renderPass));
+	return key;
+}
+
+void RgCommandList::BindPipeline(RgPipelineHandle pipeline)
+{
+	if (pipeline.Id >= m_ResolvedPipelines.size())
+	{
+		m_ResolvedPipelines.resize(pipeline.Id + 1);
+	}
+
+	auto& resolved = m_ResolvedPipelines[pipeline.Id];
+	if (resolved.RenderPass != m_RenderPass || resolved.LayoutHash != m_LayoutHash || !resolved.PipelinePtr)
+	{
+		resolved.RenderPass = m_RenderPass;
+		resolved.LayoutHash = m_LayoutHash;
+		resolved.PipelinePtr = m_PipelineLibrary->GetOrCreate(pipeline, m_RenderPass, m_DescriptorSetLayouts, m_LayoutHash);
+	}
+
+	if (resolved.PipelinePtr == m_BoundPipeline)
+	{
+		return;
+	}
+
+	m_BoundPipeline = resolved.PipelinePtr;
+
+	BindDescriptorSets(m_BoundPipeline->GetBindPoint(), m_BoundPipeline->GetPipelineLayout());
+	vkCmdBindPipeline(m_CmdBuf, m_BoundPipeline->GetBindPoint(), m_BoundPipeline->GetPipeline());
+	m_Stats.PipelineBindCount++;
 }
 
 void RgCommandList::BindVertexBuffer(const RenderBuffer* vertexBuffer)
@@ -139,21 +230,32 @@ void RgCommandList::BindVertexBuffer(const RenderBuffer* vertexBuffer)
 	VkBuffer vertexBuffers[] = { vertexBuffer->GetBuffer() };
 	VkDeviceSize offsets[] = { 0 };
 	vkCmdBindVertexBuffers(m_CmdBuf, 0, 1, vertexBuffers, offsets);
+	m_Stats.VertexBufferBindCount++;
 }
 
 void RgCommandList::BindIndexBuffer(const RenderBuffer* indexBuffer)
 {
 	vkCmdBindIndexBuffer(m_CmdBuf, indexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+	m_Stats.IndexBufferBindCount++;
 }
 
 void RgCommandList::Draw(uint32_t vertexCount, uint32_t instanceCount)
 {
 	vkCmdDraw(m_CmdBuf, vertexCount, instanceCount, 0, 0);
+	m_Stats.DrawCount++;
 }
 
 void Hydrogen::RgCommandList::DrawIndexed(uint32_t indexCount)
 {
 	vkCmdDrawIndexed(m_CmdBuf, indexCount, 1, 0, 0, 0);
+	m_Stats.DrawCount++;
+}
+
+void RgCommandList::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+{
+	HY_ASSERT(m_BoundPipeline && m_BoundPipeline->GetBindPoint() == VK_PIPELINE_BIND_POINT_COMPUTE, "No compute pipeline bound in Dispatch");
+	vkCmdDispatch(m_CmdBuf, groupCountX, groupCountY, groupCountZ);
+	m_Stats.DispatchCount++;
 }
 
 RgResourceHandle RgPassBuilder::WriteColor(RgResourceHandle texture)
@@ -183,8 +285,52 @@ RgResourceHandle RgPassBuilder::ReadTexture(RgResourceHandle texture)
 	return texture;
 }
 
-RenderGraph::RenderGraph(RenderDevice* device)
-	: m_Device(device), m_CommandList(device), m_FrameIndex(0)
+RgResourceHandle RgPassBuilder::ReadStorageImage(RgResourceHandle texture)
+{
+	if (texture.IsValid())
+	{
+		m_PassNode.Usages.push_back({ RgResourceUsage::Type::StorageRead, texture.Id });
+	}
+	return texture;
+}
+
+RgResourceHandle RgPassBuilder::WriteStorageImage(RgResourceHandle texture)
+{
+	if (texture.IsValid())
+	{
+		m_PassNode.Usages.push_back({ RgResourceUsage::Type::StorageWrite, texture.Id });
+	}
+	return texture;
+}
+
+RgResourceHandle RgPassBuilder::ReadBuffer(RgResourceHandle buffer)
+{
+	if (buffer.IsValid())
+	{
+		m_PassNode.Usages.push_back({ RgResourceUsage::Type::BufferRead, buffer.Id });
+	}
+	return buffer;
+}
+
+RgResourceHandle RgPassBuilder::WriteBuffer(RgResourceHandle buffer)
+{
+	if (buffer.IsValid())
+	{
+		m_PassNode.Usages.push_back({ RgResourceUsage::Type::BufferWrite, buffer.Id });
+	}
+	return buffer;
+}
+
+void RgPassBuilder::UsePipeline(RgPipelineHandle pipeline)
+{
+	if (pipeline.IsValid())
+	{
+		m_PassNode.Pipelines.push_back(pipeline);
+	}
+}
+
+RenderGraph::RenderGraph(RenderDevice* device, uint32_t maxFIF)
+	: m_Device(device), m_PipelineLibrary(device), m_CommandList(device, &m_PipelineLibrary), m_FrameIndex(0), m_MaxFIF(maxFIF)
 {
 	m_TextureDescs.reserve(64);
 	m_PhysicalTextureViews.reserve(64);
@@ -193,12 +339,29 @@ RenderGraph::RenderGraph(RenderDevice* device)
 
 	CreateDescriptorPool();
 	CreateSampler();
+	CreateRecordingContexts();
+	CreateTimestampQueries();
 }
 
 RenderGraph::~RenderGraph()
 {
 	VkDevice device = m_Device->GetVulkanDevice();
 
+	for (auto& context : m_RecordingContexts)
+	{
+		for (auto pool : context.CommandPools)
+		{
+			vkDestroyCommandPool(device, pool, nullptr);
+		}
+	}
+	m_RecordingContexts.clear();
+
+	for (auto& timestamps : m_TimestampFrames)
+	{
+		vkDestroyQueryPool(device, timestamps.QueryPool, nullptr);
+	}
+	m_TimestampFrames.clear();
+
 	vkDestroySampler(device, m_Sampler, nullptr);
 
 	for (auto& [hash, rp] : m_RenderPassCache) vkDestroyRenderPass(device, rp, nullptr);
@@ -221,6 +384,12 @@ RenderGraph::~RenderGraph()
 	}
 	m_PhysicalTexturePool.clear();
 
+	for (auto& [name, texture] : m_PersistentTextures)
+	{
+		DestroyPersistentTexture(texture);
+	}
+	m_PersistentTextures.clear();
+
 	for (auto& pooled : m_PhysicalBufferPool)
 	{
 		if (!pooled.Active)
@@ -239,15 +408,25 @@ void RenderGraph::Reset(uint32_t frameIndex)
 {
 	m_FrameIndex = frameIndex;
 
+	ResolveTimestamps();
 	ResetRecording();
 	ResetCompilation();
 }
 
 void RenderGraph::ResetRecording()
 {
+	for (auto& context : m_RecordingContexts)
+	{
+		vkResetCommandPool(m_Device->GetVulkanDevice(), context.CommandPools[m_FrameIndex], 0);
+		context.UsedCommandBuffers = 0;
+	}
+
 	m_FrameDescriptorBindings.clear();
 	m_TextureDescs.clear();
 	m_PhysicalTextureViews.clear();
+	m_FramePersistentTextures.clear();
+	m_BufferDescs.clear();
+	m_PhysicalBuffers.clear();
 	m_PassNodes.clear();
 }
 
@@ -304,6 +483,23 @@ void RenderGraph::ResetCompilation()
 		m_PhysicalTexturePool = newBuffer;
 	}
 
+	for (auto it = m_PersistentTextures.begin(); it != m_PersistentTextures.end();)
+	{
+		auto& texture = it->second;
+		texture.FramesUnsued = texture.UsedThisFrame ? 0 : texture.FramesUnsued + 1;
+		texture.UsedThisFrame = false;
+
+		if (texture.FramesUnsued >= FREE_AFTER_UNUSED_FRAMES)
+		{
+			DestroyPersistentTexture(texture);
+			it = m_PersistentTextures.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
 	for (auto& pooled : m_PhysicalBufferPool)
 	{
 		if (pooled.FrameIndex != m_FrameIndex)
@@ -368,10 +564,17 @@ void RenderGraph::ClearCache()
 		vmaDestroyImage(m_Device->GetAllocator(), pooled.Image, pooled.Allocation);
 	}
 
+	for (auto& [name, texture] : m_PersistentTextures)
+	{
+		DestroyPersistentTexture(texture);
+	}
+
 	m_RenderPassCache.clear();
 	m_FramebufferCache.clear();
 	m_DescriptorSetPool.clear();
 	m_PhysicalTexturePool.clear();
+	m_PersistentTextures.clear();
+	m_FramePersistentTextures.clear();
 }
 
 RgResourceHandle RenderGraph::CreateTexture(const RgTextureDesc& desc)
@@ -400,6 +603,81 @@ RgResourceHandle RenderGraph::ImportTexture(VkImage image, VkImageView imageView
 	return RgResourceHandle{ id };
 }
 
+RgResourceHandle RenderGraph::CreatePersistentTexture(const std::string& name, const RgTextureDesc& desc, size_t contentHash, bool& upToDate)
+{
+	auto& texture = m_PersistentTextures[name];
+
+	bool descChanged = texture.Desc.Width != desc.Width || texture.Desc.Height != desc.Height || texture.Desc.Format != desc.Format;
+	if (texture.Image != VK_NULL_HANDLE && descChanged)
+	{
+		// frames in flight may still sample the old image
+		vkDeviceWaitIdle(m_Device->GetVulkanDevice());
+		DestroyPersistentTexture(texture);
+	}
+
+	if (texture.Image == VK_NULL_HANDLE)
+	{
+		// usage has to cover every frame, not just the passes recorded this one
+		VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+		switch (desc.Format)
+		{
+		case TextureFormat::D32_SFLOAT: usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT; break;
+		case TextureFormat::RGBA16_SFLOAT:
+		case TextureFormat::RG16_SFLOAT:
+		case TextureFormat::RGBA8_UNORM: usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT; break;
+		default: usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; break;
+		}
+
+		texture = {};
+		texture.Desc = desc;
+		texture.UsageFlags = usage;
+		texture.Image = CreatePhysicalImage(desc, usage, &texture.Allocation);
+		texture.View = CreatePhysicalImageView(texture.Image, desc, usage);
+	}
+
+	texture.UsedThisFrame = true;
+	upToDate = texture.HasContents && texture.ContentHash == contentHash;
+
+	uint32_t id = static_cast<uint32_t>(m_TextureDescs.size());
+	m_TextureDescs.push_back(desc);
+
+	RgTextureView view{};
+	view.Image = texture.Image;
+	view.ImageView = texture.View;
+	view.UsageFlags = texture.UsageFlags;
+	view.IsPersistent = true;
+	m_PhysicalTextureViews.push_back(view);
+
+	m_FramePersistentTextures.push_back({ id, &texture, contentHash });
+
+	return RgResourceHandle{ id };
+}
+
+void RenderGraph::DestroyPersistentTexture(PersistentTexture& texture)
+{
+	if (texture.Image == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	vkDestroyImageView(m_Device->GetVulkanDevice(), texture.View, nullptr);
+	vmaDestroyImage(m_Device->GetAllocator(), texture.Image, texture.Allocation);
+
+	texture.Image = VK_NULL_HANDLE;
+	texture.View = VK_NULL_HANDLE;
+	texture.Allocation = VK_NULL_HANDLE;
+	texture.HasContents = false;
+}
+
+RgResourceHandle RenderGraph::CreateBuffer(const RgBufferDesc& desc)
+{
+	uint32_t id = static_cast<uint32_t>(m_BufferDescs.size());
+	m_BufferDescs.push_back(desc);
+	m_PhysicalBuffers.push_back(VK_NULL_HANDLE);
+
+	return RgResourceHandle{ id };
+}
+
 void RenderGraph::AddPass(const std::string& passName, const std::vector<DescriptorBinding>& bindings, const std::vector<DescriptorBindingValue>& bindingValues, std::function<void(RgPassBuilder& builder)> setupFunc, std::function<void(RgCommandList& cmd)> executeFunc)
 {
 	RgPassNode newNode{};
@@ -414,10 +692,66 @@ void RenderGraph::AddPass(const std::string& passName, const std::vector<Descrip
 	m_PassNodes.push_back(builder.GetNode());
 }
 
+void RenderGraph::AddParallelPass(const std::string& passName, const std::vector<DescriptorBinding>& bindings, const std::vector<DescriptorBindingValue>& bindingValues, std::function<void(RgPassBuilder& builder)> setupFunc, uint32_t itemCount, std::function<void(RgCommandList& cmd, uint32_t first, uint32_t count)> executeFunc)
+{
+	RgPassNode newNode{};
+	newNode.Name = passName;
+	newNode.DescriptorBindings = bindings;
+	newNode.DescriptorBindingValues = bindingValues;
+	newNode.ParallelItemCount = itemCount;
+	newNode.ParallelExecuteCallback = executeFunc;
+
+	RgPassBuilder builder(newNode);
+	setupFunc(builder);
+
+	m_PassNodes.push_back(builder.GetNode());
+}
+
+void RenderGraph::AddComputePass(const std::string& passName, const std::vector<DescriptorBinding>& bindings, const std::vector<DescriptorBindingValue>& bindingValues, std::function<void(RgPassBuilder& builder)> setupFunc, std::function<void(RgCommandList& cmd)> executeFunc)
+{
+	RgPassNode newNode{};
+	newNode.Name = passName;
+	newNode.Type = RgPassType::Compute;
+	newNode.DescriptorBindings = bindings;
+	newNode.DescriptorBindingValues = bindingValues;
+	newNode.ExecuteCallback = executeFunc;
+
+	RgPassBuilder builder(newNode);
+	setupFunc(builder);
+
+	m_PassNodes.push_back(builder.GetNode());
+}
+
+RgPipelineHandle RenderGraph::RegisterPipeline(const std::shared_ptr<ShaderAsset>& vertexShader, const std::shared_ptr<ShaderAsset>& fragmentShader, const PipelineSpec& spec)
+{
+	RgPipelineDesc desc{};
+	desc.VertexShader = vertexShader;
+	desc.FragmentShader = fragmentShader;
+	desc.Spec = spec;
+
+	desc.Hash = spec.Hash();
+	HashCombine(desc.Hash, vertexShader->GetContentHash());
+	HashCombine(desc.Hash, fragmentShader->GetContentHash());
+
+	return m_PipelineLibrary.Register(desc);
+}
+
+RgPipelineHandle RenderGraph::RegisterComputePipeline(const std::shared_ptr<ShaderAsset>& computeShader, const PipelineSpec& spec)
+{
+	RgPipelineDesc desc{};
+	desc.ComputeShader = computeShader;
+	desc.Spec = spec;
+
+	desc.Hash = spec.Hash();
+	HashCombine(desc.Hash, computeShader->GetContentHash());
+
+	return m_PipelineLibrary.Register(desc);
+}
+
 void RenderGraph::AddOutput(const RgResourceHandle& handle)
 {
 	auto& view = m_PhysicalTextureViews[handle.Id];
-	view.UsageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT;
+	view.UsageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 	view.IsOutput = true;
 }
 
@@ -441,9 +775,16 @@ struct TextureStateTracker
 	VkAccessFlags AccessMask = 0;
 };
 
+struct BufferStateTracker
+{
+	VkPipelineStageFlags AccessStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	VkAccessFlags AccessMask = 0;
+};
+
 void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 {
 	ZoneScoped;
+	RgClock::time_point phaseStart = RgClock::now();
 
 	m_FrameDescriptorBindings = frameBindings;
 
@@ -498,12 +839,19 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 	{
 		for (const auto& usage : pass.Usages)
 		{
+			if (usage.IsBufferUsage())
+			{
+				continue;
+			}
+
 			auto& view = m_PhysicalTextureViews[usage.Handle.Id];
 			switch (usage.UsageType)
 			{
 			case RgResourceUsage::Type::ShaderRead: view.UsageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT; break;
 			case RgResourceUsage::Type::ColorWrite: view.UsageFlags |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; break;
 			case RgResourceUsage::Type::DepthWrite: view.UsageFlags |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT; break;
+			case RgResourceUsage::Type::StorageRead:
+			case RgResourceUsage::Type::StorageWrite: view.UsageFlags |= VK_IMAGE_USAGE_STORAGE_BIT; break;
 			}
 		}
 	}
@@ -515,7 +863,7 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 			continue;
 		}
 
-		if (!m_PhysicalTextureViews[i].IsImported)
+		if (!m_PhysicalTextureViews[i].IsImported && !m_PhysicalTextureViews[i].IsPersistent)
 		{
 			size_t descHash = HashTextureDescUsage(m_TextureDescs[i], m_PhysicalTextureViews[i].UsageFlags);
 			bool foundCachedResource = false;
@@ -554,17 +902,39 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 		}
 	}
 
+	for (size_t i = 0; i < m_BufferDescs.size(); i++)
+	{
+		uint32_t idx = GetOrCreateBuffer(m_BufferDescs[i]);
+		m_PhysicalBuffers[i] = m_PhysicalBufferPool[idx].Buffer;
+	}
+
+	m_FrameStats.CompileResourcesMs = MillisecondsSince(phaseStart);
+	phaseStart = RgClock::now();
+
 	std::vector<TextureStateTracker> textureStates(m_PhysicalTextureViews.size());
+	std::vector<BufferStateTracker> bufferStates(m_BufferDescs.size());
 	std::vector<bool> textureWrittenThisFrame(m_PhysicalTextureViews.size(), false);
 	std::vector<RenderPassAttachment> passColorAttachments;
 
+	for (const auto& persistent : m_FramePersistentTextures)
+	{
+		auto& state = textureStates[persistent.TextureId];
+		state.CurrentLayout = persistent.Texture->Layout;
+		state.AccessStage = persistent.Texture->AccessStage;
+		state.AccessMask = persistent.Texture->AccessMask;
+	}
+
 	for (const auto& recordedPass : m_PassNodes)
 	{
 		passColorAttachments.clear();
 
 		CompiledPass compiledPass{};
 		compiledPass.Name = recordedPass.Name;
+		compiledPass.Type = recordedPass.Type;
 		compiledPass.ExecuteCallback = recordedPass.ExecuteCallback;
+		compiledPass.ParallelItemCount = recordedPass.ParallelItemCount;
+		compiledPass.ParallelExecuteCallback = recordedPass.ParallelExecuteCallback;
+		compiledPass.Pipelines = recordedPass.Pipelines;
 
 		if (recordedPass.DescriptorBindings.size() != 0)
 		{
@@ -616,8 +986,51 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 		std::optional<RenderPassAttachment> passDepthAttachment = std::nullopt;
 		bool extentSet = false;
 
+		bool isComputePass = recordedPass.Type == RgPassType::Compute;
+		VkPipelineStageFlags shaderStage = isComputePass ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
 		for (const auto& usage : recordedPass.Usages)
 		{
+			if (usage.IsBufferUsage())
+			{
+				auto& bufferState = bufferStates[usage.Handle.Id];
+
+				VkAccessFlags targetAccess = usage.UsageType == RgResourceUsage::Type::BufferWrite ? VK_ACCESS_SHADER_WRITE_BIT : VK_ACCESS_SHADER_READ_BIT;
+				VkPipelineStageFlags targetStage = isComputePass ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : (VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+				bool hasHazard = (bufferState.AccessMask & VK_ACCESS_SHADER_WRITE_BIT) ||
+					((targetAccess & VK_ACCESS_SHADER_WRITE_BIT) && bufferState.AccessMask != 0);
+
+				if (hasHazard)
+				{
+					VkBufferBarrierCommand cmd{};
+					cmd.BufferId = usage.Handle.Id;
+					cmd.SrcStage = bufferState.AccessStage;
+					cmd.DstStage = targetStage;
+
+					cmd.Barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+					cmd.Barrier.pNext = nullptr;
+					cmd.Barrier.srcAccessMask = bufferState.AccessMask;
+					cmd.Barrier.dstAccessMask = targetAccess;
+					cmd.Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					cmd.Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					cmd.Barrier.buffer = m_PhysicalBuffers[usage.Handle.Id];
+					cmd.Barrier.offset = 0;
+					cmd.Barrier.size = VK_WHOLE_SIZE;
+
+					compiledPass.PrePassBufferBarriers.push_back(cmd);
+
+					bufferState.AccessStage = targetStage;
+					bufferState.AccessMask = targetAccess;
+				}
+				else
+				{
+					bufferState.AccessStage |= targetStage;
+					bufferState.AccessMask |= targetAccess;
+				}
+				continue;
+			}
+
 			const auto& view = m_PhysicalTextureViews[usage.Handle.Id];
 			const auto& desc = m_TextureDescs[usage.Handle.Id];
 			auto& state = textureStates[usage.Handle.Id];
@@ -640,6 +1053,8 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 			{
 			case RgResourceUsage::Type::ColorWrite:
 			{
+				HY_ASSERT(!isComputePass, "Compute pass '{}' cannot write color attachments", recordedPass.Name);
+
 				targetLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 				targetAccess = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 				targetStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -650,6 +1065,9 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 				case TextureFormat::RGBA8_SRGB:    vkFormat = VK_FORMAT_R8G8B8A8_SRGB; break;
 				case TextureFormat::RGBA16_SFLOAT: vkFormat = VK_FORMAT_R16G16B16A16_SFLOAT; break;
 				case TextureFormat::BGRA8_SRGB:    vkFormat = VK_FORMAT_B8G8R8A8_SRGB; break;
+				case TextureFormat::RGBA8_UNORM:   vkFormat = VK_FORMAT_R8G8B8A8_UNORM; break;
+				case TextureFormat::RG16_SFLOAT:   vkFormat = VK_FORMAT_R16G16_SFLOAT; break;
+				case TextureFormat::B10G11R11_UFLOAT: vkFormat = VK_FORMAT_B10G11R11_UFLOAT_PACK32; break;
 				case TextureFormat::D32_SFLOAT:
 					vkFormat = VK_FORMAT_D32_SFLOAT;
 					aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -675,6 +1093,8 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 
 			case RgResourceUsage::Type::DepthWrite:
 			{
+				HY_ASSERT(!isComputePass, "Compute pass '{}' cannot write depth attachments", recordedPass.Name);
+
 				targetLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 				targetAccess = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 				targetStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
@@ -696,12 +1116,26 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 			case RgResourceUsage::Type::ShaderRead:
 				targetLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 				targetAccess = VK_ACCESS_SHADER_READ_BIT;
-				targetStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+				targetStage = shaderStage;
 				if (desc.Format == TextureFormat::D32_SFLOAT) aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
 				break;
+
+			case RgResourceUsage::Type::StorageRead:
+				targetLayout = VK_IMAGE_LAYOUT_GENERAL;
+				targetAccess = VK_ACCESS_SHADER_READ_BIT;
+				targetStage = shaderStage;
+				break;
+
+			case RgResourceUsage::Type::StorageWrite:
+				targetLayout = VK_IMAGE_LAYOUT_GENERAL;
+				targetAccess = VK_ACCESS_SHADER_WRITE_BIT;
+				targetStage = shaderStage;
+				textureWrittenThisFrame[usage.Handle.Id] = true;
+				break;
 			}
 
-			if (state.CurrentLayout != targetLayout)
+			bool hasStorageHazard = ((state.AccessMask | targetAccess) & VK_ACCESS_SHADER_WRITE_BIT) != 0;
+			if (state.CurrentLayout != targetLayout || hasStorageHazard)
 			{
 				VkBarrierCommand cmd{};
 				cmd.TextureId = usage.Handle.Id;
@@ -731,6 +1165,11 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 				state.AccessStage = targetStage;
 				state.AccessMask = targetAccess;
 			}
+			else
+			{
+				state.AccessStage |= targetStage;
+				state.AccessMask |= targetAccess;
+			}
 		}
 
 		if (passDepthAttachment.has_value())
@@ -740,8 +1179,11 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 			compiledPass.ClearValues.push_back(depthClear);
 		}
 
-		compiledPass.RenderPass = GetOrCreateRenderPass(passColorAttachments, passDepthAttachment);
-		compiledPass.Framebuffer = GetOrCreateFramebuffer(compiledPass.RenderPass, compiledPass.ColorAttachments, compiledPass.DepthAttachment, compiledPass.RenderExtent);
+		if (!isComputePass)
+		{
+			compiledPass.RenderPass = GetOrCreateRenderPass(passColorAttachments, passDepthAttachment);
+			compiledPass.Framebuffer = GetOrCreateFramebuffer(compiledPass.RenderPass, compiledPass.ColorAttachments, compiledPass.DepthAttachment, compiledPass.RenderExtent);
+		}
 
 		m_CompiledPasses.push_back(std::move(compiledPass));
 	}
@@ -807,62 +1249,72 @@ void RenderGraph::Compile(const std::vector<DescriptorBinding>& frameBindings)
 			}
 		}
 	}
+
+	// the next frame picks persistent textures up in the state this one leaves them in
+	for (const auto& persistent : m_FramePersistentTextures)
+	{
+		const auto& state = textureStates[persistent.TextureId];
+		persistent.Texture->Layout = state.CurrentLayout;
+		persistent.Texture->AccessStage = state.AccessStage;
+		persistent.Texture->AccessMask = state.AccessMask;
+
+		if (textureWrittenThisFrame[persistent.TextureId])
+		{
+			persistent.Texture->HasContents = true;
+			persistent.Texture->ContentHash = persistent.ContentHash;
+		}
+	}
+
+	m_FrameStats.CompilePassesMs = MillisecondsSince(phaseStart);
+	phaseStart = RgClock::now();
+
+	PrewarmPipelines();
+
+	m_FrameStats.PrewarmMs = MillisecondsSince(phaseStart);
 }
 
 void RenderGraph::Execute(VkCommandBuffer cmdBuffer, const std::vector<DescriptorBindingValue>& bindingValues)
 {
 	ZoneScoped;
-	UpdateDescriptorSet(m_FrameDescriptorBindings, bindingValues, m_FrameDescriptorSet);
-
-	m_CommandList.InitFrame(cmdBuffer, &m_PhysicalTextureViews, m_FrameDescriptorSet);
 
-	for (const auto& pass : m_CompiledPasses)
+	m_FrameStats.Passes.clear();
+	m_FrameStats.Passes.resize(m_CompiledPasses.size());
+	for (size_t i = 0; i < m_CompiledPasses.size(); i++)
 	{
-		for (const auto& barrierCmd : pass.PrePassBarriers)
-		{
-			vkCmdPipelineBarrier(cmdBuffer, barrierCmd.SrcStage, barrierCmd.DstStage, 0,
-				0, nullptr, 0, nullptr, 1, &barrierCmd.Barrier);
-		}
+		m_FrameStats.Passes[i].Name = m_CompiledPasses[i].Name;
+	}
 
-		VkRenderPassBeginInfo beginInfo{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
-		beginInfo.renderPass = pass.RenderPass;
-		beginInfo.framebuffer = pass.Framebuffer;
-		beginInfo.renderArea.extent = pass.RenderExtent;
+	RgClock::time_point phaseStart = RgClock::now();
+	UpdateDescriptorSet(m_FrameDescriptorBindings, bindingValues, m_FrameDescriptorSet);
+	m_FrameStats.DescriptorUpdateMs = MillisecondsSince(phaseStart);
 
-		beginInfo.clearValueCount = static_cast<uint32_t>(pass.ClearValues.size());
-		beginInfo.pClearValues = pass.ClearValues.empty() ? nullptr : pass.ClearValues.data();
+	m_CommandList.InitFrame(cmdBuffer, &m_PhysicalTextureViews, &m_PhysicalBuffers, m_FrameDescriptorSet);
 
-		vkCmdBeginRenderPass(cmdBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	phaseStart = RgClock::now();
+	RecordParallelPasses();
+	m_FrameStats.ParallelRecordMs = MillisecondsSince(phaseStart);
 
-		VkViewport viewport{};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(pass.RenderExtent.width);
-		viewport.height = static_cast<float>(pass.RenderExtent.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+	BeginTimestamps(cmdBuffer);
 
-		VkRect2D scissor{};
-		scissor.offset = { 0, 0 };
-		scissor.extent = pass.RenderExtent;
-		vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+	phaseStart = RgClock::now();
+	for (size_t passIndex = 0; passIndex < m_CompiledPasses.size(); passIndex++)
+	{
+		const auto& pass = m_CompiledPasses[passIndex];
 
-		std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
-		if (m_FrameDescriptorSetLayout != VK_NULL_HANDLE)
+		for (const auto& barrierCmd : pass.PrePassBarriers)
 		{
-			descriptorSetLayouts.push_back(m_FrameDescriptorSetLayout);
+			vkCmdPipelineBarrier(cmdBuffer, barrierCmd.SrcStage, barrierCmd.DstStage, 0,
+				0, nullptr, 0, nullptr, 1, &barrierCmd.Barrier);
 		}
-		if (pass.DescriptorSetLayout)
+		for (const auto& barrierCmd : pass.PrePassBufferBarriers)
 		{
-			descriptorSetLayouts.push_back(pass.DescriptorSetLayout);
+			vkCmdPipelineBarrier(cmdBuffer, barrierCmd.SrcStage, barrierCmd.DstStage, 0,
+				0, nullptr, 1, &barrierCmd.Barrier, 0, nullptr);
 		}
 
-		m_CommandList.InitPass(pass.RenderPass, descriptorSetLayouts, pass.DescriptorSet);
-
-		pass.ExecuteCallback(m_CommandList);
-
-		vkCmdEndRenderPass(cmdBuffer);
+		WritePassTimestamp(cmdBuffer, passIndex, false);
+		RecordPass(cmdBuffer, pass, m_FrameStats.Passes[passIndex]);
+		WritePassTimestamp(cmdBuffer, passIndex, true);
 	}
 	
 	for (const auto& barrierCmd : m_PostRenderBarriers)
@@ -877,6 +1329,404 @@ void RenderGraph::Execute(VkCommandBuffer cmdBuffer, const std::vector<Descripto
 			1, &barrierCmd.Barrier
 		);
 	}
+
+	m_FrameStats.RecordMs = MillisecondsSince(phaseStart);
+
+	m_FrameStats.Commands = {};
+	for (const auto& passStats : m_FrameStats.Passes)
+	{
+		m_FrameStats.Commands.Add(passStats.Commands);
+	}
+
+	m_ExecutedFrames++;
+}
+
+void RenderGraph::RecordPass(VkCommandBuffer cmdBuffer, const CompiledPass& pass, RgPassStats& passStats)
+{
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts = GetPassDescriptorSetLayouts(pass);
+
+	bool isParallel = pass.ParallelExecuteCallback != nullptr;
+
+	if (pass.Type == RgPassType::Compute)
+	{
+		if (isParallel)
+		{
+			if (!pass.SecondaryCommandBuffers.empty())
+				vkCmdExecuteCommands(cmdBuffer, static_cast<uint32_t>(pass.SecondaryCommandBuffers.size()), pass.SecondaryCommandBuffers.data());
+			return;
+		}
+
+		RgClock::time_point passStart = RgClock::now();
+		m_CommandList.ResetStats();
+		m_CommandList.InitPass(VK_NULL_HANDLE, descriptorSetLayouts, pass.DescriptorSet);
+		pass.ExecuteCallback(m_CommandList);
+
+		passStats.RecordMs = MillisecondsSince(passStart);
+		passStats.Commands = m_CommandList.GetStats();
+		return;
+	}
+
+	VkRenderPassBeginInfo beginInfo{ VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+	beginInfo.renderPass = pass.RenderPass;
+	beginInfo.framebuffer = pass.Framebuffer;
+	beginInfo.renderArea.extent = pass.RenderExtent;
+
+	beginInfo.clearValueCount = static_cast<uint32_t>(pass.ClearValues.size());
+	beginInfo.pClearValues = pass.ClearValues.empty() ? nullptr : pass.ClearValues.data();
+
+	if (isParallel)
+	{
+		vkCmdBeginRenderPass(cmdBuffer, &beginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+		if (!pass.SecondaryCommandBuffers.empty())
+			vkCmdExecuteCommands(cmdBuffer, static_cast<uint32_t>(pass.SecondaryCommandBuffers.size()), pass.SecondaryCommandBuffers.data());
+		vkCmdEndRenderPass(cmdBuffer);
+		return;
+	}
+
+	vkCmdBeginRenderPass(cmdBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	VkViewport viewport{};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(pass.RenderExtent.width);
+	viewport.height = static_cast<float>(pass.RenderExtent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor{};
+	scissor.offset = { 0, 0 };
+	scissor.extent = pass.RenderExtent;
+	vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+
+	RgClock::time_point passStart = RgClock::now();
+	m_CommandList.ResetStats();
+	m_CommandList.InitPass(pass.RenderPass, descriptorSetLayouts, pass.DescriptorSet);
+
+	pass.ExecuteCallback(m_CommandList);
+
+	passStats.RecordMs = MillisecondsSince(passStart);
+	passStats.Commands = m_CommandList.GetStats();
+
+	vkCmdEndRenderPass(cmdBuffer);
+}
+
+void RenderGraph::BeginTimestamps(VkCommandBuffer cmdBuffer)
+{
+	if (!m_TimestampsSupported)
+	{
+		return;
+	}
+
+	auto& timestamps = m_TimestampFrames[m_FrameIndex];
+	vkCmdResetQueryPool(cmdBuffer, timestamps.QueryPool, 0, MAX_TIMESTAMPED_PASSES * 2);
+
+	size_t passCount = std::min<size_t>(m_CompiledPasses.size(), MAX_TIMESTAMPED_PASSES);
+	timestamps.PassNames.resize(passCount);
+	for (size_t i = 0; i < passCount; i++)
+	{
+		timestamps.PassNames[i] = m_CompiledPasses[i].Name;
+	}
+
+	timestamps.FrameNumber = m_ExecutedFrames;
+	timestamps.Pending = passCount != 0;
+}
+
+void RenderGraph::WritePassTimestamp(VkCommandBuffer cmdBuffer, size_t passIndex, bool end)
+{
+	if (!m_TimestampsSupported || passIndex >= MAX_TIMESTAMPED_PASSES)
+	{
+		return;
+	}
+
+	VkPipelineStageFlagBits stage = end ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	uint32_t query = static_cast<uint32_t>(passIndex) * 2 + (end ? 1 : 0);
+	vkCmdWriteTimestamp(cmdBuffer, stage, m_TimestampFrames[m_FrameIndex].QueryPool, query);
+}
+
+void RenderGraph::ResolveTimestamps()
+{
+	if (!m_TimestampsSupported)
+	{
+		return;
+	}
+
+	auto& timestamps = m_TimestampFrames[m_FrameIndex];
+	if (!timestamps.Pending)
+	{
+		return;
+	}
+	timestamps.Pending = false;
+
+	uint32_t queryCount = static_cast<uint32_t>(timestamps.PassNames.size()) * 2;
+	std::vector<uint64_t> results(queryCount);
+
+	// the frame's fence has been waited on before Reset, so the results are available without blocking
+	VkResult result = vkGetQueryPoolResults(m_Device->GetVulkanDevice(), timestamps.QueryPool, 0, queryCount,
+		results.size() * sizeof(uint64_t), results.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+	if (result != VK_SUCCESS)
+	{
+		return;
+	}
+
+	auto toMs = [this](uint64_t begin, uint64_t end)
+		{
+			uint64_t ticks = (end - begin) & m_TimestampMask;
+			return static_cast<double>(ticks) * m_TimestampPeriodNs / 1000000.0;
+		};
+
+	m_GpuTimings.FrameNumber = timestamps.FrameNumber;
+	m_GpuTimings.Passes.resize(timestamps.PassNames.size());
+	for (size_t i = 0; i < timestamps.PassNames.size(); i++)
+	{
+		m_GpuTimings.Passes[i].Name = timestamps.PassNames[i];
+		m_GpuTimings.Passes[i].Ms = toMs(results[i * 2], results[i * 2 + 1]);
+	}
+	m_GpuTimings.TotalMs = toMs(results.front(), results.back());
+	m_HasGpuTimings = true;
+}
+
+void RenderGraph::RecordParallelPasses()
+{
+	ZoneScoped;
+
+	struct RecordingTask
+	{
+		size_t PassIndex;
+		uint32_t ChunkIndex;
+		uint32_t First;
+		uint32_t Count;
+	};
+
+	std::vector<RecordingTask> tasks;
+	uint32_t threadCount = JobSystem::Get().GetThreadCount();
+
+	for (size_t i = 0; i < m_CompiledPasses.size(); i++)
+	{
+		auto& pass = m_CompiledPasses[i];
+		pass.SecondaryCommandBuffers.clear();
+
+		if (!pass.ParallelExecuteCallback || pass.ParallelItemCount == 0)
+		{
+			continue;
+		}
+
+		uint32_t chunkCount = (pass.ParallelItemCount + MIN_ITEMS_PER_RECORDING_CHUNK - 1) / MIN_ITEMS_PER_RECORDING_CHUNK;
+		chunkCount = std::clamp(chunkCount, 1u, threadCount);
+		uint32_t chunkSize = (pass.ParallelItemCount + chunkCount - 1) / chunkCount;
+
+		pass.SecondaryCommandBuffers.resize(chunkCount, VK_NULL_HANDLE);
+		for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+		{
+			uint32_t first = chunk * chunkSize;
+			uint32_t count = std::min(chunkSize, pass.ParallelItemCount - first);
+			tasks.push_back({ i, chunk, first, count });
+		}
+	}
+
+	if (tasks.empty())
+	{
+		return;
+	}
+
+	// written per task so the recording threads never share a counter
+	std::vector<RgPassStats> taskStats(tasks.size());
+
+	auto recordTask = [this, &tasks, &taskStats](uint32_t taskIndex, uint32_t threadIndex)
+		{
+			ZoneScopedN("Record Secondary Command Buffer");
+			RgClock::time_point taskStart = RgClock::now();
+
+			const auto& task = tasks[taskIndex];
+			auto& pass = m_CompiledPasses[task.PassIndex];
+			auto& context = m_RecordingContexts[threadIndex];
+
+			VkCommandBuffer cmdBuffer = AcquireSecondaryCommandBuffer(context);
+
+			VkCommandBufferInheritanceInfo inheritanceInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+			inheritanceInfo.renderPass = pass.RenderPass;
+			inheritanceInfo.subpass = 0;
+			inheritanceInfo.framebuffer = pass.Framebuffer;
+
+			VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			if (pass.Type == RgPassType::Graphics)
+			{
+				beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+			}
+			beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+			VkResult result = vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+			if (result != VK_SUCCESS)
+			{
+				HY_ENGINE_FATAL("Failed to begin Vulkan secondary command buffer... vkBeginCommandBuffer returned {}", (uint16_t)result);
+			}
+
+			if (pass.Type == RgPassType::Graphics)
+			{
+				VkViewport viewport{};
+				viewport.x = 0.0f;
+				viewport.y = 0.0f;
+				viewport.width = static_cast<float>(pass.RenderExtent.width);
+				viewport.height = static_cast<float>(pass.RenderExtent.height);
+				viewport.minDepth = 0.0f;
+				viewport.maxDepth = 1.0f;
+				vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+
+				VkRect2D scissor{};
+				scissor.offset = { 0, 0 };
+				scissor.extent = pass.RenderExtent;
+				vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+			}
+
+			std::vector<VkDescriptorSetLayout> descriptorSetLayouts = GetPassDescriptorSetLayouts(pass);
+
+			context.CommandList->ResetStats();
+			context.CommandList->InitFrame(cmdBuffer, &m_PhysicalTextureViews, &m_PhysicalBuffers, m_FrameDescriptorSet);
+			context.CommandList->InitPass(pass.RenderPass, descriptorSetLayouts, pass.DescriptorSet);
+
+			pass.ParallelExecuteCallback(*context.CommandList, task.First, task.Count);
+			taskStats[taskIndex].Commands = context.CommandList->GetStats();
+
+			result = vkEndCommandBuffer(cmdBuffer);
+			if (result != VK_SUCCESS)
+			{
+				HY_ENGINE_FATAL("Failed to end Vulkan secondary command buffer... vkEndCommandBuffer returned {}", (uint16_t)result);
+			}
+
+			pass.SecondaryCommandBuffers[task.ChunkIndex] = cmdBuffer;
+			taskStats[taskIndex].RecordMs = MillisecondsSince(taskStart);
+		};
+
+	// recording contexts belong to threads, every worker and the calling thread own one
+	JobSystem& jobs = JobSystem::Get();
+	jobs.ParallelFor(static_cast<uint32_t>(tasks.size()), 1, [&](uint32_t begin, uint32_t end)
+		{
+			uint32_t threadIndex = jobs.GetCurrentThreadIndex();
+			for (uint32_t taskIndex = begin; taskIndex < end; taskIndex++)
+			{
+				recordTask(taskIndex, threadIndex);
+			}
+		});
+
+	for (size_t i = 0; i < tasks.size(); i++)
+	{
+		auto& passStats = m_FrameStats.Passes[tasks[i].PassIndex];
+		passStats.RecordMs += taskStats[i].RecordMs;
+		passStats.Commands.Add(taskStats[i].Commands);
+	}
+}
+
+void RenderGraph::PrewarmPipelines()
+{
+	ZoneScoped;
+
+	struct PrewarmTask
+	{
+		size_t PassIndex;
+		RgPipelineHandle Pipeline;
+	};
+
+	std::vector<PrewarmTask> tasks;
+	for (size_t i = 0; i < m_CompiledPasses.size(); i++)
+	{
+		const auto& pass = m_CompiledPasses[i];
+		if (pass.Pipelines.empty())
+		{
+			continue;
+		}
+
+		size_t layoutHash = RgPipelineLibrary::HashLayouts(GetPassDescriptorSetLayouts(pass));
+		for (auto pipeline : pass.Pipelines)
+		{
+			if (!m_PipelineLibrary.Contains(pipeline, pass.RenderPass, layoutHash))
+			{
+				tasks.push_back({ i, pipeline });
+			}
+		}
+	}
+
+	if (tasks.empty())
+	{
+		return;
+	}
+
+	HY_ENGINE_INFO("Prewarming {} pipelines", tasks.size());
+
+	JobSystem::Get().ParallelFor(static_cast<uint32_t>(tasks.size()), 1, [this, &tasks](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t taskIndex = begin; taskIndex < end; taskIndex++)
+			{
+				const auto& task = tasks[taskIndex];
+				const auto& pass = m_CompiledPasses[task.PassIndex];
+
+				auto layouts = GetPassDescriptorSetLayouts(pass);
+				m_PipelineLibrary.GetOrCreate(task.Pipeline, pass.RenderPass, layouts, RgPipelineLibrary::HashLayouts(layouts));
+			}
+		});
+}
+
+std::vector<VkDescriptorSetLayout> RenderGraph::GetPassDescriptorSetLayouts(const CompiledPass& pass) const
+{
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+	if (m_FrameDescriptorSetLayout != VK_NULL_HANDLE)
+	{
+		descriptorSetLayouts.push_back(m_FrameDescriptorSetLayout);
+	}
+	if (pass.DescriptorSetLayout)
+	{
+		descriptorSetLayouts.push_back(pass.DescriptorSetLayout);
+	}
+	return descriptorSetLayouts;
+}
+
+VkCommandBuffer RenderGraph::AcquireSecondaryCommandBuffer(RecordingContext& context)
+{
+	auto& buffers = context.CommandBuffers[m_FrameIndex];
+	if (context.UsedCommandBuffers < buffers.size())
+	{
+		return buffers[context.UsedCommandBuffers++];
+	}
+
+	VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+	allocInfo.commandPool = context.CommandPools[m_FrameIndex];
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+	allocInfo.commandBufferCount = 1;
+
+	VkCommandBuffer cmdBuffer;
+	VkResult result = vkAllocateCommandBuffers(m_Device->GetVulkanDevice(), &allocInfo, &cmdBuffer);
+	if (result != VK_SUCCESS)
+	{
+		HY_ENGINE_FATAL("Failed to allocate Vulkan secondary command buffer... vkAllocateCommandBuffers returned {}", (uint16_t)result);
+	}
+
+	buffers.push_back(cmdBuffer);
+	context.UsedCommandBuffers++;
+	return cmdBuffer;
+}
+
+void RenderGraph::CreateRecordingContexts()
+{
+	m_RecordingContexts.resize(JobSystem::Get().GetThreadCount());
+	for (auto& context : m_RecordingContexts)
+	{
+		context.CommandPools.resize(m_MaxFIF);
+		context.CommandBuffers.resize(m_MaxFIF);
+		context.CommandList = std::make_unique<RgCommandList>(m_Device, &m_PipelineLibrary);
+
+		for (uint32_t i = 0; i < m_MaxFIF; i++)
+		{
+			VkCommandPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			poolInfo.queueFamilyIndex = m_Device->GetGraphicsFamilyIndex();
+
+			VkResult result = vkCreateCommandPool(m_Device->GetVulkanDevice(), &poolInfo, nullptr, &context.CommandPools[i]);
+			if (result != VK_SUCCESS)
+			{
+				HY_ENGINE_FATAL("Failed to create Vulkan command pool... vkCreateCommandPool returned {}", (uint16_t)result);
+			}
+		}
+	}
 }
 
 void RenderGraph::CreateDescriptorPool()
@@ -909,6 +1759,42 @@ void RenderGraph::CreateDescriptorPool()
 	}
 }
 
+void RenderGraph::CreateTimestampQueries()
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(m_Device->GetVulkanPhysicalDevice(), &properties);
+
+	uint32_t familyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(m_Device->GetVulkanPhysicalDevice(), &familyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> families(familyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(m_Device->GetVulkanPhysicalDevice(), &familyCount, families.data());
+
+	uint32_t validBits = families[m_Device->GetGraphicsFamilyIndex()].timestampValidBits;
+	m_TimestampsSupported = validBits != 0 && properties.limits.timestampPeriod > 0.0f;
+	if (!m_TimestampsSupported)
+	{
+		HY_ENGINE_WARN("Graphics queue does not support timestamps, GPU pass timings are disabled");
+		return;
+	}
+
+	m_TimestampPeriodNs = properties.limits.timestampPeriod;
+	m_TimestampMask = validBits >= 64 ? UINT64_MAX : ((uint64_t(1) << validBits) - 1);
+
+	m_TimestampFrames.resize(m_MaxFIF);
+	for (auto& timestamps : m_TimestampFrames)
+	{
+		VkQueryPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+		poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		poolInfo.queryCount = MAX_TIMESTAMPED_PASSES * 2;
+
+		VkResult result = vkCreateQueryPool(m_Device->GetVulkanDevice(), &poolInfo, nullptr, &timestamps.QueryPool);
+		if (result != VK_SUCCESS)
+		{
+			HY_ENGINE_FATAL("Failed to create Vulkan query pool... vkCreateQueryPool returned {}", (uint16_t)result);
+		}
+	}
+}
+
 void RenderGraph::CreateSampler()
 {
 	VkSamplerCreateInfo createInfo{};
@@ -1097,6 +1983,9 @@ VkImage RenderGraph::CreatePhysicalImage(const RgTextureDesc& desc, VkImageUsage
 	case TextureFormat::RGBA8_SRGB:    vkFormat = VK_FORMAT_R8G8B8A8_SRGB; break;
 	case TextureFormat::RGBA16_SFLOAT: vkFormat = VK_FORMAT_R16G16B16A16_SFLOAT; break;
 	case TextureFormat::BGRA8_SRGB:    vkFormat = VK_FORMAT_B8G8R8A8_SRGB; break;
+	case TextureFormat::RGBA8_UNORM:   vkFormat = VK_FORMAT_R8G8B8A8_UNORM; break;
+	case TextureFormat::RG16_SFLOAT:   vkFormat = VK_FORMAT_R16G16_SFLOAT; break;
+	case TextureFormat::B10G11R11_UFLOAT: vkFormat = VK_FORMAT_B10G11R11_UFLOAT_PACK32; break;
 	case TextureFormat::D32_SFLOAT:    vkFormat = VK_FORMAT_D32_SFLOAT; break;
 	}
 
@@ -1147,6 +2036,9 @@ VkImageView RenderGraph::CreatePhysicalImageView(VkImage image, const RgTextureD
 	case TextureFormat::RGBA8_SRGB:    vkFormat = VK_FORMAT_R8G8B8A8_SRGB; break;
 	case TextureFormat::RGBA16_SFLOAT: vkFormat = VK_FORMAT_R16G16B16A16_SFLOAT; break;
 	case TextureFormat::BGRA8_SRGB:    vkFormat = VK_FORMAT_B8G8R8A8_SRGB; break;
+	case TextureFormat::RGBA8_UNORM:   vkFormat = VK_FORMAT_R8G8B8A8_UNORM; break;
+	case TextureFormat::RG16_SFLOAT:   vkFormat = VK_FORMAT_R16G16_SFLOAT; break;
+	case TextureFormat::B10G11R11_UFLOAT: vkFormat = VK_FORMAT_B10G11R11_UFLOAT_PACK32; break;
 	case TextureFormat::D32_SFLOAT:
 		vkFormat = VK_FORMAT_D32_SFLOAT;
 		aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -1213,6 +2105,7 @@ uint32_t RenderGraph::GetOrCreateBuffer(const RgBufferDesc& desc)
 	pooled.IsFree = false;
 	pooled.Hash = hash;
 	pooled.Size = desc.Size;
+	pooled.FrameIndex = m_FrameIndex;
 
 	VkBufferCreateInfo bufferInfo{};
 	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -1222,12 +2115,22 @@ uint32_t RenderGraph::GetOrCreateBuffer(const RgBufferDesc& desc)
 	{
 	case RgBufferType::Uniform: bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT; break;
 	case RgBufferType::Storage: bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT; break;
+	case RgBufferType::DeviceStorage:
+		bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		break;
 	}
 	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
 	VmaAllocationCreateInfo allocInfo{};
 	allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-	allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+	if (desc.Type == RgBufferType::DeviceStorage)
+	{
+		allocInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	}
+	else
+	{
+		allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+	}
 
 	VmaAllocationInfo allocationInfo{};
 	VkResult result = vmaCreateBuffer(
@@ -1245,7 +2148,7 @@ uint32_t RenderGraph::GetOrCreateBuffer(const RgBufferDesc& desc)
 	}
 
 	pooled.MappedMemory = allocationInfo.pMappedData;
-	pooled.IsMapped = true;
+	pooled.IsMapped = pooled.MappedMemory != nullptr;
 
 	m_PhysicalBufferPool.push_back(pooled);
 
@@ -1273,8 +2176,32 @@ void RenderGraph::UpdateDescriptorSet(const std::vector<DescriptorBinding>& desc
 
 		switch (binding.Type)
 		{
-		case DescriptorType::UniformBuffer:
 		case DescriptorType::StorageBuffer:
+			if (!value.Buffers.empty())
+			{
+				for (uint32_t j = 0; j < value.Buffers.size(); j++)
+				{
+					VkDescriptorBufferInfo bufInfo{};
+					bufInfo.buffer = m_PhysicalBuffers[value.Buffers[j].Id];
+					bufInfo.offset = 0;
+					bufInfo.range = VK_WHOLE_SIZE;
+
+					bufferInfos.push_back(bufInfo);
+
+					VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+					write.dstSet = descriptorSet;
+					write.dstBinding = i;
+					write.dstArrayElement = j;
+					write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+					write.descriptorCount = 1;
+					write.pBufferInfo = &bufferInfos.back();
+
+					descriptorWrites.push_back(write);
+				}
+				break;
+			}
+			[[fallthrough]];
+		case DescriptorType::UniformBuffer:
 		{
 			RgBufferType bufType = (binding.Type == DescriptorType::UniformBuffer)
 				? RgBufferType::Uniform : RgBufferType::Storage;
@@ -1327,6 +2254,30 @@ void RenderGraph::UpdateDescriptorSet(const std::vector<DescriptorBinding>& desc
 			}
 			break;
 		}
+
+		case DescriptorType::StorageImage:
+		{
+			for (uint32_t j = 0; j < value.Resources.size(); j++)
+			{
+				VkDescriptorImageInfo imgInfo{};
+				imgInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+				imgInfo.imageView = m_PhysicalTextureViews[value.Resources[j].Id].ImageView;
+				imgInfo.sampler = VK_NULL_HANDLE;
+
+				imageInfos.push_back(imgInfo);
+
+				VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+				write.dstSet = descriptorSet;
+				write.dstBinding = i;
+				write.dstArrayElement = j;
+				write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+				write.descriptorCount = 1;
+				write.pImageInfo = &imageInfos.back();
+
+				descriptorWrites.push_back(write);
+			}
+			break;
+		}
 		}
 	}
 
@@ -332,6 +332,8 @@ RenderDeviceType RenderInstance::MapDeviceType(VkPhysicalDeviceType vkType)
 		return RenderDeviceType::IntegratedGPU;
 	case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
 		return RenderDeviceType::VirtualGPU;
+	case VK_PHYSICAL_DEVICE_TYPE_CPU:
+		return RenderDeviceType::CPU;
 	default:
 		return RenderDeviceType::Other;
 	}
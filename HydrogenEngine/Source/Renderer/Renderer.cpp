@@ -6,13 +6,16 @@
 #include "Tracy/Tracy.hpp"
 
 #include <backends/imgui_impl_vulkan.h>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cstring>
 
 using namespace Hydrogen;
 
 Renderer::Renderer(const std::shared_ptr<Viewport>& viewport, RenderDevice* device, SwapChain* swapChain, uint32_t maxFIF)
 	: m_Viewport(viewport), m_Device(device), m_SwapChain(swapChain), m_MaxFIF(maxFIF)
 {
-	m_RenderGraph = std::make_unique<RenderGraph>(device);
+	m_RenderGraph = std::make_unique<RenderGraph>(device, m_MaxFIF);
 
 	CreateCommandBuffer();
 	CreateSyncObjects();
@@ -52,7 +55,7 @@ Renderer::Renderer(const std::shared_ptr<Viewport>& viewport, RenderDevice* devi
 Renderer::Renderer(RenderDevice* device, uint32_t maxFIF)
 	: m_Viewport(nullptr), m_Device(device), m_SwapChain(nullptr), m_MaxFIF(maxFIF)
 {
-	m_RenderGraph = std::make_unique<RenderGraph>(device);
+	m_RenderGraph = std::make_unique<RenderGraph>(device, m_MaxFIF);
 
 	CreateCommandBuffer();
 	CreateSyncObjects();
@@ -206,6 +209,130 @@ std::vector<RgTextureView> Renderer::Render(const std::function<const std::vecto
 	return m_RenderGraph->GetOutputs();
 }
 
+std::vector<uint8_t> Renderer::ReadbackTexture(const RgTextureView& view, uint32_t width, uint32_t height, TextureFormat format)
+{
+	ZoneScoped;
+
+	HY_ASSERT(format == TextureFormat::RGBA16_SFLOAT || format == TextureFormat::RGBA8_SRGB || format == TextureFormat::RGBA8_UNORM,
+		"Readback of texture format {} is not supported", (uint32_t)format);
+
+	uint32_t bytesPerPixel = (format == TextureFormat::RGBA16_SFLOAT) ? 8 : 4;
+	VkDeviceSize size = (VkDeviceSize)width * height * bytesPerPixel;
+
+	// The output is only valid once every in-flight frame that may still write it has retired
+	m_Device->WaitForIdle();
+
+	VkBufferCreateInfo bufferInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = size;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	VmaAllocationCreateInfo allocInfo{};
+	allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+	allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	VkBuffer readbackBuffer = VK_NULL_HANDLE;
+	VmaAllocation readbackAllocation = VK_NULL_HANDLE;
+	VmaAllocationInfo readbackInfo{};
+	VkResult result = vmaCreateBuffer(m_Device->GetAllocator(), &bufferInfo, &allocInfo, &readbackBuffer, &readbackAllocation, &readbackInfo);
+	if (result != VK_SUCCESS)
+	{
+		HY_ENGINE_FATAL("Failed to create VMA readback buffer... vmaCreateBuffer returned {}", (uint16_t)result);
+	}
+
+	VkCommandBufferAllocateInfo cmdAllocInfo{};
+	cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	cmdAllocInfo.commandPool = m_Device->GetCommandPool();
+	cmdAllocInfo.commandBufferCount = 1;
+
+	VkCommandBuffer commandBuffer;
+	vkAllocateCommandBuffers(m_Device->GetVulkanDevice(), &cmdAllocInfo, &commandBuffer);
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+	// Barrier: SHADER_READ -> TRANSFER_SRC
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = view.Image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+	barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	VkBufferImageCopy region{};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { width, height, 1 };
+
+	vkCmdCopyImageToBuffer(commandBuffer, view.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer, 1, &region);
+
+	// Barrier: TRANSFER_SRC -> SHADER_READ, the graph expects outputs in this layout
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	vkEndCommandBuffer(commandBuffer);
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+
+	vkQueueSubmit(m_Device->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+	vkQueueWaitIdle(m_Device->GetGraphicsQueue());
+
+	vkFreeCommandBuffers(m_Device->GetVulkanDevice(), m_Device->GetCommandPool(), 1, &commandBuffer);
+
+	vmaInvalidateAllocation(m_Device->GetAllocator(), readbackAllocation, 0, VK_WHOLE_SIZE);
+
+	std::vector<uint8_t> pixels((size_t)width * height * 4);
+	if (format == TextureFormat::RGBA16_SFLOAT)
+	{
+		const uint16_t* source = static_cast<const uint16_t*>(readbackInfo.pMappedData);
+		for (size_t i = 0; i < pixels.size(); i++)
+		{
+			float value = glm::clamp(glm::unpackHalf1x16(source[i]), 0.0f, 1.0f);
+
+			// Alpha stays linear
+			if (i % 4 != 3)
+			{
+				value = value <= 0.0031308f ? value * 12.92f : 1.055f * glm::pow(value, 1.0f / 2.4f) - 0.055f;
+			}
+
+			pixels[i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+		}
+	}
+	else
+	{
+		std::memcpy(pixels.data(), readbackInfo.pMappedData, pixels.size());
+	}
+
+	vmaDestroyBuffer(m_Device->GetAllocator(), readbackBuffer, readbackAllocation);
+
+	return pixels;
+}
+
 void Renderer::UpdateSwapChain(SwapChain* swapChain)
 {
 	m_SwapChain = swapChain;
@@ -375,8 +502,6 @@ void Renderer::InitImGui()
 }
 
 std::unique_ptr<GizmoMeshCache> DefaultRenderer::s_GizmoMeshCache;
-std::unique_ptr<RenderBuffer> DefaultRenderer::s_SphereVertexBuffer;
-std::unique_ptr<RenderBuffer> DefaultRenderer::s_SphereIndexBuffer;
 
 struct UniformBuffer
 {
@@ -384,6 +509,8 @@ struct UniformBuffer
 	glm::mat4 Proj;
 	glm::vec3 ViewPos;
 	float Padding;
+	glm::mat4 InverseViewProj;
+	glm::mat4 PrevViewProj; // unjittered
 };
 
 struct GeometryPassPushConstants
@@ -401,23 +528,60 @@ struct GeometryPassPushConstants
 	float Metallic;
 
 	int32_t BoneBaseIndex;
-	float Padding1;
+	int32_t PreviousModelIndex; // -1 when the object did not move since the last frame
 
 	glm::vec4 Emissive;
 };
 
-struct LightingPassPushConstants
+struct GBufferDrawItem
+{
+	GeometryPassPushConstants PushConstants;
+	const RenderBuffer* VertexBuffer;
+	const RenderBuffer* IndexBuffer;
+	uint32_t IndexCount;
+	bool Skinned;
+	bool Static;
+
+	uint32_t EntityId;
+	uint32_t BoneCount;
+
+	glm::vec3 BoundsMin;
+	glm::vec3 BoundsMax;
+};
+
+struct ShadowCascadeDrawLists
+{
+	std::vector<uint32_t> StaticItems;
+	std::vector<uint32_t> DynamicItems; // every caster when the cascade is not cached
+	bool Cached = false;
+	size_t StaticHash = 0;
+};
+
+struct ClusterPushConstants
+{
+	glm::mat4 InverseProj;
+	glm::vec4 ScreenSizeNearFar;
+	uint32_t LightCount;
+};
+
+struct BloomPushConstants
 {
-	alignas(16) glm::mat4 Model;
-	alignas(16) glm::vec3 Color;
-	float Intensity;
-	alignas(16) glm::vec3 Position;
-	float Radius;
+	glm::vec2 SourceTexelSize;
+	int32_t KarisAverage;
+	float Scale;
 };
 
-struct BlurPushConstants
+struct TemporalResolvePushConstants
 {
-	int Horizontal;
+	glm::mat4 Reprojection;
+	glm::vec2 Jitter;
+	glm::vec2 InputSize;
+	glm::vec2 OutputSize;
+	glm::vec2 OutputTexelSize;
+	float FeedbackMin;
+	float FeedbackMax;
+	int32_t HistoryValid;
+	float Padding;
 };
 
 void GizmoMeshCache::Initialize(RenderDevice* device)
@@ -493,30 +657,380 @@ void GizmoMeshCache::Cleanup()
 	CapsuleMesh.IndexBuffer.reset();
 }
 
-RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSettings settings, const CameraComponent& camera, glm::vec3 cameraPos, Scene* scene)
+static glm::mat3 AbsMatrix(const glm::mat4& matrix)
+{
+	glm::mat3 result = glm::mat3(matrix);
+	for (int i = 0; i < 3; i++)
+	{
+		result[i] = glm::abs(result[i]);
+	}
+
+	return result;
+}
+
+static void TransformBounds(const MeshBounds& bounds, const glm::mat4& model, glm::vec3& outMin, glm::vec3& outMax)
+{
+	glm::vec3 center = glm::vec3(model * glm::vec4((bounds.Min + bounds.Max) * 0.5f, 1.0f));
+	glm::vec3 extent = AbsMatrix(model) * ((bounds.Max - bounds.Min) * 0.5f);
+
+	outMin = center - extent;
+	outMax = center + extent;
+}
+
+static void CollectGBufferDrawItems(Scene* scene, std::vector<GBufferDrawItem>& drawItems, size_t& staticCasterHash, const std::vector<uint32_t>& boneBaseIndices, uint32_t albedoOffset, uint32_t normalOffset, uint32_t ORMOffset, uint32_t emissiveOffset)
+{
+	ZoneScoped;
+
+	staticCasterHash = 0;
+
+	uint32_t albedoIndex = 0;
+	uint32_t normalIndex = 0;
+	uint32_t ORMIndex = 0;
+	uint32_t emissiveIndex = 0;
+
+	auto fillMaterial = [&](GeometryPassPushConstants& pushConstants, const std::shared_ptr<MaterialAsset>& material)
+		{
+			pushConstants.AlbedoIndex = -1;
+			pushConstants.NormalIndex = -1;
+			pushConstants.ORMIndex = -1;
+			pushConstants.EmissiveIndex = -1;
+
+			if (material->GetAlbedoMap())
+			{
+				pushConstants.AlbedoIndex = albedoIndex + albedoOffset;
+				albedoIndex++;
+			}
+			if (material->GetNormalMap())
+			{
+				pushConstants.NormalIndex = normalIndex + normalOffset;
+				normalIndex++;
+			}
+			if (material->GetORMMap())
+			{
+				pushConstants.ORMIndex = ORMIndex + ORMOffset;
+				ORMIndex++;
+			}
+			if (material->GetEmissiveMap())
+			{
+				pushConstants.EmissiveIndex = emissiveIndex + emissiveOffset;
+				emissiveIndex++;
+			}
+
+			pushConstants.Tint = glm::vec4(material->GetTint(), 1.0);
+			pushConstants.Roughness = material->GetRoughnessFactor();
+			pushConstants.Metallic = material->GetMetallicFactor();
+			pushConstants.Emissive = material->GetEmissive();
+		};
+
+	// mesh renderers are kept in slot order, so the world matrices are read front to back
+	const auto& world = scene->GetWorldTransforms();
+
+	scene->IterateComponents<MeshRendererComponent>([&](Entity e, MeshRendererComponent& mesh)
+		{
+			uint32_t slot = world.GetSlot((entt::entity)e.GetID());
+			if (!mesh.Mesh || !mesh.Material || slot == INVALID_WORLD_SLOT)
+			{
+				return;
+			}
+
+			GBufferDrawItem item{};
+			item.PushConstants.Model = world.Matrices[slot];
+			item.EntityId = e.GetID();
+			fillMaterial(item.PushConstants, mesh.Material);
+
+			item.VertexBuffer = mesh.Mesh->GetVertexBuffer();
+			item.IndexBuffer = mesh.Mesh->GetIndexBuffer();
+			item.IndexCount = mesh.Mesh->GetIndexCount();
+			item.Skinned = false;
+			TransformBounds(mesh.Mesh->GetBounds(), item.PushConstants.Model, item.BoundsMin, item.BoundsMax);
+
+			// physics only moves non static bodies, everything else is treated as static until its transform changes
+			auto* rigidbody = e.TryGetComponent<RigidbodyComponent>();
+			item.Static = !rigidbody || (reactphysics3d::BodyType)rigidbody->Type == reactphysics3d::BodyType::STATIC;
+
+			if (item.Static)
+			{
+				HashCombine(staticCasterHash, e.GetID());
+				HashCombine(staticCasterHash, world.Revisions[slot]);
+				HashCombine(staticCasterHash, reinterpret_cast<size_t>(item.VertexBuffer));
+				HashCombine(staticCasterHash, item.IndexCount);
+			}
+
+			drawItems.push_back(item);
+		});
+
+	uint32_t boneBaseIndicesIndex = 0;
+	scene->IterateComponents<SkeletalMeshRendererComponent>([&](Entity e, SkeletalMeshRendererComponent& mesh)
+		{
+			// every skeleton got a palette uploaded, even the ones that are not drawn
+			if (!mesh.Skeleton)
+			{
+				return;
+			}
+
+			uint32_t boneBaseIndex = boneBaseIndices[boneBaseIndicesIndex++];
+			uint32_t slot = world.GetSlot((entt::entity)e.GetID());
+			if (!mesh.SkeletalMesh || !mesh.Material || slot == INVALID_WORLD_SLOT)
+			{
+				return;
+			}
+
+			GBufferDrawItem item{};
+			item.PushConstants.Model = world.Matrices[slot];
+			item.PushConstants.BoneBaseIndex = boneBaseIndex;
+			item.EntityId = e.GetID();
+			item.BoneCount = (uint32_t)mesh.Bones.size();
+			fillMaterial(item.PushConstants, mesh.Material);
+
+			item.VertexBuffer = mesh.SkeletalMesh->GetVertexBuffer();
+			item.IndexBuffer = mesh.SkeletalMesh->GetIndexBuffer();
+			item.IndexCount = mesh.SkeletalMesh->GetIndexCount();
+			item.Skinned = true;
+			item.Static = false;
+			// bind pose bounds, animated limbs may leave them slightly
+			TransformBounds(mesh.SkeletalMesh->GetBounds(), item.PushConstants.Model, item.BoundsMin, item.BoundsMax);
+
+			drawItems.push_back(item);
+		});
+}
+
+// previous model matrices and bone palettes for the velocity target, objects that did not move get none
+static void CollectPreviousTransforms(TemporalViewState& state, std::vector<GBufferDrawItem>& drawItems, const std::vector<glm::mat4>& bones,
+	std::vector<glm::mat4>& prevModels, std::vector<glm::mat4>& prevBones)
+{
+	ZoneScoped;
+
+	// palettes without a previous frame repeat the current one, which gives them no motion
+	prevBones = bones;
+
+	std::unordered_map<uint32_t, glm::mat4> currentModels;
+	std::unordered_map<uint32_t, std::vector<glm::mat4>> currentBones;
+	currentModels.reserve(drawItems.size());
+
+	for (auto& item : drawItems)
+	{
+		const glm::mat4& model = item.PushConstants.Model;
+		item.PushConstants.PreviousModelIndex = -1;
+
+		auto prevModel = state.PrevModels.find(item.EntityId);
+		bool hasPrevModel = prevModel != state.PrevModels.end();
+		bool moved = hasPrevModel && prevModel->second != model;
+
+		if (item.Skinned)
+		{
+			auto palette = bones.begin() + item.PushConstants.BoneBaseIndex;
+			auto prevPalette = state.PrevBones.find(item.EntityId);
+			if (prevPalette != state.PrevBones.end() && prevPalette->second.size() == item.BoneCount)
+			{
+				std::copy(prevPalette->second.begin(), prevPalette->second.end(), prevBones.begin() + item.PushConstants.BoneBaseIndex);
+				moved = true;
+			}
+
+			currentBones[item.EntityId].assign(palette, palette + item.BoneCount);
+		}
+
+		if (moved)
+		{
+			item.PushConstants.PreviousModelIndex = (int32_t)prevModels.size();
+			prevModels.push_back(hasPrevModel ? prevModel->second : model);
+		}
+
+		currentModels[item.EntityId] = model;
+	}
+
+	state.PrevModels = std::move(currentModels);
+	state.PrevBones = std::move(currentBones);
+}
+
+static float GetCascadeSplit(const ShadowSettings& shadows, uint32_t cascadeCount, float nearPlane, float farPlane, uint32_t cascade)
+{
+	float lambda = shadows.SplitLambda;
+	if (shadows.SplitScheme == ShadowSplitScheme::Uniform)
+		lambda = 0.0f;
+	else if (shadows.SplitScheme == ShadowSplitScheme::Logarithmic)
+		lambda = 1.0f;
+
+	float p = (float)(cascade + 1) / (float)cascadeCount;
+	float uniformSplit = nearPlane + (farPlane - nearPlane) * p;
+	float logSplit = nearPlane * std::pow(farPlane / nearPlane, p);
+
+	return glm::mix(uniformSplit, logSplit, glm::clamp(lambda, 0.0f, 1.0f));
+}
+
+static float Halton(uint32_t index, uint32_t base)
+{
+	float result = 0.0f;
+	float fraction = 1.0f / (float)base;
+	while (index > 0)
+	{
+		result += (float)(index % base) * fraction;
+		index /= base;
+		fraction /= (float)base;
+	}
+	return result;
+}
+
+static size_t HashMatrix(const glm::mat4& matrix)
+{
+	size_t seed = 0;
+	for (int column = 0; column < 4; column++)
+	{
+		for (int row = 0; row < 4; row++)
+		{
+			HashCombine(seed, std::hash<float>{}(matrix[column][row]));
+		}
+	}
+
+	return seed;
+}
+
+static void ComputeShadowCascades(const ShadowSettings& shadows, const CameraComponent& camera, glm::vec3 lightDirection,
+	const std::vector<GBufferDrawItem>& drawItems, size_t staticCasterHash, ShadowCascadeData& cascades, std::vector<ShadowCascadeDrawLists>& cascadeDrawLists)
 {
 	ZoneScoped;
 
-	if (!s_SphereVertexBuffer)
+	uint32_t cascadeCount = glm::clamp(shadows.CascadeCount, 1u, (uint32_t)MAX_SHADOW_CASCADES);
+	float nearPlane = camera.NearPlane;
+	float farPlane = std::max(std::min(camera.FarPlane, shadows.MaxDistance), nearPlane + 0.01f);
+
+	float aspect = camera.ViewportHeight > 0 ? (float)camera.ViewportWidth / (float)camera.ViewportHeight : 1.0f;
+	float tanHalfFovY = std::tan(glm::radians(camera.FOV) * 0.5f);
+	float tanHalfFovX = tanHalfFovY * aspect;
+	glm::mat4 inverseView = glm::inverse(camera.View);
+
+	glm::vec3 L = glm::normalize(lightDirection);
+	glm::vec3 up = std::abs(L.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), L, up);
+	glm::mat4 inverseLightRotation = glm::inverse(lightRotation);
+
+	cascades = {};
+	cascades.CascadeCount = cascadeCount;
+	cascades.Resolution = (float)shadows.Resolution;
+	cascadeDrawLists.assign(cascadeCount, {});
+
+	float sliceNear = nearPlane;
+	for (uint32_t c = 0; c < cascadeCount; c++)
 	{
-		auto sphereData = GenerateUVSphere(16, 16);
+		float sliceFar = GetCascadeSplit(shadows, cascadeCount, nearPlane, farPlane, c);
+		auto& lists = cascadeDrawLists[c];
+		lists.Cached = shadows.CacheStaticCasters && c >= shadows.FirstCachedCascade;
+
+		// a bounding sphere keeps the cascade size constant while the camera rotates
+		glm::vec3 corners[8];
+		glm::vec3 center = glm::vec3(0.0f);
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			float depth = (i & 4) ? sliceFar : sliceNear;
+			float x = ((i & 1) ? 1.0f : -1.0f) * depth * tanHalfFovX;
+			float y = ((i & 2) ? 1.0f : -1.0f) * depth * tanHalfFovY;
+
+			corners[i] = glm::vec3(inverseView * glm::vec4(x, y, -depth, 1.0f));
+			center += corners[i] / 8.0f;
+		}
+
+		float radius = 0.0f;
+		for (const auto& corner : corners)
+		{
+			radius = std::max(radius, glm::length(corner - center));
+		}
+
+		// cached cascades snap to a coarse grid so the static layer survives small camera moves,
+		// the radius grows by the largest snapping offset so the slice stays covered
+		float snapStep = 0.0f;
+		if (lists.Cached)
+		{
+			snapStep = radius * SHADOW_CACHE_SNAP_FRACTION;
+			radius += snapStep * 1.5f;
+		}
+		radius = std::ceil(radius * 16.0f) / 16.0f;
+
+		// snapping to whole texels stops static geometry from shimmering
+		float texelSize = 2.0f * radius / (float)shadows.Resolution;
+		snapStep = std::max(std::round(snapStep / texelSize), 1.0f) * texelSize;
+
+		glm::vec3 lightSpaceCenter = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+		lightSpaceCenter.x = std::floor(lightSpaceCenter.x / snapStep) * snapStep;
+		lightSpaceCenter.y = std::floor(lightSpaceCenter.y / snapStep) * snapStep;
+		center = glm::vec3(inverseLightRotation * glm::vec4(lightSpaceCenter, 1.0f));
+
+		glm::mat4 lightView = glm::lookAt(center - L * radius, center, up);
+		glm::mat3 absLightView = AbsMatrix(lightView);
+
+		// casters outside the slice along the light direction still throw shadows into it,
+		// so only the xy extent culls and the near plane is pulled back to the furthest caster
+		float casterNear = 0.0f;
+		for (uint32_t i = 0; i < (uint32_t)drawItems.size(); i++)
+		{
+			const auto& item = drawItems[i];
+			glm::vec3 itemCenter = glm::vec3(lightView * glm::vec4((item.BoundsMin + item.BoundsMax) * 0.5f, 1.0f));
+			glm::vec3 itemExtent = absLightView * ((item.BoundsMax - item.BoundsMin) * 0.5f);
+
+			if (std::abs(itemCenter.x) - itemExtent.x > radius || std::abs(itemCenter.y) - itemExtent.y > radius)
+				continue;
+			if (-itemCenter.z - itemExtent.z > 2.0f * radius)
+				continue;
 
-		BufferDescription vertexBufferDesc;
-		vertexBufferDesc.cpuVisible = false;
-		vertexBufferDesc.size = sphereData.Vertices.size() * sizeof(float);
-		vertexBufferDesc.type = BufferType::Vertex;
+			casterNear = std::max(casterNear, itemCenter.z + itemExtent.z);
 
-		s_SphereVertexBuffer = std::make_unique<RenderBuffer>(Application::Get()->GetRenderDevice(), vertexBufferDesc);
-		s_SphereVertexBuffer->UploadDataStaging((void*)sphereData.Vertices.data(), vertexBufferDesc.size);
+			if (lists.Cached && item.Static)
+				lists.StaticItems.push_back(i);
+			else
+				lists.DynamicItems.push_back(i);
+		}
+
+		// a dynamic caster moving towards the light should not rebuild the static layer every frame
+		if (lists.Cached)
+		{
+			casterNear = std::ceil(casterNear / radius) * radius;
+		}
+
+		glm::mat4 lightProj = glm::orthoRH_ZO(-radius, radius, -radius, radius, -casterNear, 2.0f * radius);
+		lightProj[1][1] *= -1;
 
-		BufferDescription indexBufferDesc;
-		indexBufferDesc.cpuVisible = false;
-		indexBufferDesc.size = sphereData.Indices.size() * sizeof(uint32_t);
-		indexBufferDesc.type = BufferType::Index;
+		cascades.LightViewProj[c] = lightProj * lightView;
+		cascades.SplitDepths[c] = sliceFar;
+		cascades.TexelSizes[c] = texelSize;
 
-		s_SphereIndexBuffer = std::make_unique<RenderBuffer>(Application::Get()->GetRenderDevice(), indexBufferDesc);
-		s_SphereIndexBuffer->UploadDataStaging((void*)sphereData.Indices.data(), indexBufferDesc.size);
+		if (lists.Cached)
+		{
+			cascades.StaticLayerMask |= 1u << c;
+
+			lists.StaticHash = staticCasterHash;
+			HashCombine(lists.StaticHash, HashMatrix(cascades.LightViewProj[c]));
+		}
+
+		sliceNear = sliceFar;
 	}
+}
+
+RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSettings settings, const CameraComponent& sceneCamera, glm::vec3 cameraPos, Scene* scene)
+{
+	ZoneScoped;
+
+	scene->UpdateTransforms();
+
+	TemporalViewState& temporalState = renderer->GetTemporalState();
+	uint64_t frameIndex = ++temporalState.FrameIndex;
+
+	float renderScale = glm::clamp(settings.Display.RenderScale, 0.25f, 1.0f);
+	uint32_t renderWidth = std::max(1u, (uint32_t)std::round((float)settings.Display.Width * renderScale));
+	uint32_t renderHeight = std::max(1u, (uint32_t)std::round((float)settings.Display.Height * renderScale));
+	bool temporalEnabled = settings.Temporal.Enabled;
+
+	CameraComponent camera = sceneCamera;
+	glm::vec2 jitterPixels = glm::vec2(0.0f);
+	if (temporalEnabled)
+	{
+		// fewer input pixels per output pixel need a longer sequence to cover it
+		uint32_t phaseCount = (uint32_t)std::ceil(TEMPORAL_JITTER_PHASES / (renderScale * renderScale));
+		uint32_t phase = (uint32_t)(frameIndex % phaseCount) + 1;
+
+		jitterPixels = glm::vec2(Halton(phase, 2), Halton(phase, 3)) - 0.5f;
+		camera.Jitter = jitterPixels * 2.0f / glm::vec2((float)renderWidth, (float)renderHeight);
+		camera.CalculateProj();
+	}
+
+	glm::mat4 unjitteredViewProj = camera.UnjitteredProj * camera.View;
 
 	std::vector<const Texture*> AlbedoTextures;
 	std::vector<const Texture*> NormalTextures;
@@ -541,10 +1055,58 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 		Bones.push_back({});
 	}
 
+	std::vector<GBufferDrawItem> gBufferDrawItems;
+	size_t staticCasterHash = 0;
+	CollectGBufferDrawItems(scene, gBufferDrawItems, staticCasterHash, BoneBaseIndices,
+		0,
+		(uint32_t)AlbedoTextures.size(),
+		(uint32_t)AlbedoTextures.size() + (uint32_t)NormalTextures.size(),
+		(uint32_t)AlbedoTextures.size() + (uint32_t)NormalTextures.size() + (uint32_t)ORMTextures.size());
+
+	std::vector<glm::mat4> PrevModels;
+	std::vector<glm::mat4> PrevBones;
+	CollectPreviousTransforms(temporalState, gBufferDrawItems, Bones, PrevModels, PrevBones);
+
+	if (PrevModels.size() == 0)
+	{
+		PrevModels.push_back({});
+	}
+
 	UniformBuffer cameraInfo = {};
 	cameraInfo.View = camera.View;
 	cameraInfo.Proj = camera.Proj;
 	cameraInfo.ViewPos = cameraPos;
+	cameraInfo.InverseViewProj = glm::inverse(camera.Proj * camera.View);
+	cameraInfo.PrevViewProj = temporalState.PrevViewProj;
+
+	auto pointLights = GetPointLights(scene, camera.View);
+	uint32_t pointLightCount = static_cast<uint32_t>(pointLights.size());
+	if (pointLights.size() == 0)
+	{
+		pointLights.push_back({});
+	}
+
+	auto directionalLights = GetDirectionalLights(scene);
+	if (directionalLights.size() == 0)
+		directionalLights.push_back({ .Intensity = 0.0f });
+
+	// only the first shadow casting directional light gets cascades
+	ShadowCascadeData shadowCascades = {};
+	std::vector<ShadowCascadeDrawLists> shadowDrawLists;
+	for (auto& light : directionalLights)
+	{
+		if (light.CastsShadows == 0.0f)
+			continue;
+
+		if (settings.Shadows.Enabled && shadowDrawLists.empty())
+		{
+			ComputeShadowCascades(settings.Shadows, camera, light.Direction, gBufferDrawItems, staticCasterHash, shadowCascades, shadowDrawLists);
+		}
+		else
+		{
+			light.CastsShadows = 0.0f;
+		}
+	}
 
 	const auto& outputs = renderer->Render(
 		[&](RenderGraph* graph) -> const std::vector<DescriptorBindingValue>
@@ -552,175 +1114,263 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 			uint32_t textureWidth = static_cast<uint32_t>(settings.Display.Width);
 			uint32_t textureHeight = static_cast<uint32_t>(settings.Display.Height);
 
-			auto gBufferPosition = graph->CreateTexture({ .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::RGBA16_SFLOAT });
-			auto gBufferNormal = graph->CreateTexture({ .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::RGBA16_SFLOAT });
-			auto gBufferAlbedoRoughness = graph->CreateTexture({ .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::RGBA8_SRGB });
-			auto gBufferMetallicAO = graph->CreateTexture({ .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::RGBA8_SRGB });
-			auto gBufferEmissive = graph->CreateTexture({ .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::RGBA16_SFLOAT });
-			auto gBufferDepth = graph->CreateTexture({ .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::D32_SFLOAT });
-			
-			graph->AddPass("GBuffer",
+			bool compactGBuffer = settings.Rendering.CompactGBuffer;
+			auto gBufferDepth = graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::D32_SFLOAT });
+
+			// Compact layout drops the position target (reconstructed from depth) and packs normals and material
+			std::vector<RgResourceHandle> gBufferTargets;
+			if (compactGBuffer)
+			{
+				gBufferTargets = {
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RG16_SFLOAT }),
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA8_SRGB }),
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA8_UNORM }),
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::B10G11R11_UFLOAT })
+				};
+			}
+			else
+			{
+				gBufferTargets = {
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA16_SFLOAT }),
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA16_SFLOAT }),
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA8_SRGB }),
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA8_SRGB }),
+					graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA16_SFLOAT })
+				};
+			}
+
+			std::vector<RgResourceHandle> lightingInputs = gBufferTargets;
+			if (compactGBuffer)
+			{
+				lightingInputs.insert(lightingInputs.begin(), gBufferDepth);
+			}
+
+			// object motion only, zero for everything that did not move since the last frame
+			auto gBufferVelocity = graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RG16_SFLOAT });
+
+			PipelineSpec gBufferPipelineSpec = {};
+			gBufferPipelineSpec.VertexBufferLayout = { {VertexElementType::Float3}, {VertexElementType::Float2}, {VertexElementType::Float3}, {VertexElementType::Float3} };
+			gBufferPipelineSpec.PushConstants = { { sizeof(GeometryPassPushConstants), (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Vertex) } };
+			gBufferPipelineSpec.CullMode = ShaderCullMode::Back;
+			gBufferPipelineSpec.ColorBlending = std::vector<BlendMode>(gBufferTargets.size() + 1, BlendMode::None);
+			gBufferPipelineSpec.DepthSpec = { .DepthTest = true, .DepthWrite = true, .Operator = DepthTestOp::Less };
+			if (settings.Debug.WireframeMode)
+			{
+				gBufferPipelineSpec.PolygonMode = PolygonModeStyle::Line;
+			}
+
+			PipelineSpec gBufferSkinnedPipelineSpec = gBufferPipelineSpec;
+			gBufferSkinnedPipelineSpec.VertexBufferLayout = { {VertexElementType::Float3}, {VertexElementType::Float2}, {VertexElementType::Float3},
+															{VertexElementType::Float3}, {VertexElementType::Int4}, {VertexElementType::Float4} };
+
+			auto gBufferFragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>(
+				compactGBuffer ? "GBufferCompactFragmentShader.glsl" : "GBufferFragmentShader.glsl");
+			auto gBufferPipeline = graph->RegisterPipeline(
+				Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GBufferVertexShader.glsl"), gBufferFragmentShader, gBufferPipelineSpec);
+			auto gBufferSkinnedPipeline = graph->RegisterPipeline(
+				Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GBufferSkinnedVertexShader.glsl"), gBufferFragmentShader, gBufferSkinnedPipelineSpec);
+
+			graph->AddParallelPass("GBuffer",
 				{
 					{ 0, DescriptorType::CombinedImageSampler, 1000, ShaderStage::Fragment, DescriptorBindingFlags::VariableDescriptorCount },
-					{ 1, DescriptorType::StorageBuffer, 1, ShaderStage::Vertex }
+					{ 1, DescriptorType::StorageBuffer, 1, ShaderStage::Vertex },
+					{ 2, DescriptorType::StorageBuffer, 1, ShaderStage::Vertex },
+					{ 3, DescriptorType::StorageBuffer, 1, ShaderStage::Vertex }
 				},
 
 				{
 					{ .Textures = Textures },
-					{ .Size = Bones.size() * sizeof(glm::mat4), .Data = (uint32_t*)Bones.data() }
+					{ .Size = Bones.size() * sizeof(glm::mat4), .Data = (uint32_t*)Bones.data() },
+					{ .Size = PrevModels.size() * sizeof(glm::mat4), .Data = (uint32_t*)PrevModels.data() },
+					{ .Size = PrevBones.size() * sizeof(glm::mat4), .Data = (uint32_t*)PrevBones.data() }
 				},
 
 				[&](RgPassBuilder& builder)
 				{
-					builder.WriteColor(gBufferPosition);
-					builder.WriteColor(gBufferNormal);
-					builder.WriteColor(gBufferAlbedoRoughness);
-					builder.WriteColor(gBufferMetallicAO);
-					builder.WriteColor(gBufferEmissive);
+					for (auto target : gBufferTargets)
+					{
+						builder.WriteColor(target);
+					}
+					builder.WriteColor(gBufferVelocity);
 					builder.WriteDepth(gBufferDepth);
+
+					builder.UsePipeline(gBufferPipeline);
+					builder.UsePipeline(gBufferSkinnedPipeline);
 				},
-				[&](RgCommandList& cmd)
+				static_cast<uint32_t>(gBufferDrawItems.size()),
+				[&, gBufferPipeline, gBufferSkinnedPipeline](RgCommandList& cmd, uint32_t first, uint32_t count)
 				{
 					ZoneScopedN("GBuffer Pass");
 
-					auto vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GBufferVertexShader.glsl");
-					auto fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GBufferFragmentShader.glsl");
-
-					PipelineSpec gBufferPipeline = {};
-					gBufferPipeline.VertexBufferLayout = { {VertexElementType::Float3}, {VertexElementType::Float2}, {VertexElementType::Float3}, {VertexElementType::Float3} };
-					gBufferPipeline.PushConstants = { { sizeof(GeometryPassPushConstants), (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Vertex) } };
-					gBufferPipeline.CullMode = ShaderCullMode::Back;
-					gBufferPipeline.ColorBlending = { BlendMode::None, BlendMode::None, BlendMode::None, BlendMode::None, BlendMode::None };
-					gBufferPipeline.DepthSpec = { .DepthTest = true, .DepthWrite = true, .Operator = DepthTestOp::Less };
-					if (settings.Debug.WireframeMode)
+					for (uint32_t i = first; i < first + count; i++)
 					{
-						gBufferPipeline.PolygonMode = PolygonModeStyle::Line;
-					}
-
-					cmd.BindPipeline(vertexShader, fragmentShader, gBufferPipeline);
+						const auto& item = gBufferDrawItems[i];
 
-					uint32_t albedoIndex = 0;
-					uint32_t normalIndex = 0;
-					uint32_t ORMIndex = 0;
-					uint32_t emissiveIndex = 0;
+						cmd.BindPipeline(item.Skinned ? gBufferSkinnedPipeline : gBufferPipeline);
+						cmd.PushConstants(&item.PushConstants, sizeof(GeometryPassPushConstants), 0, (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Vertex));
 
-					uint32_t albedoOffset = 0;
-					uint32_t normalOffset = (uint32_t)AlbedoTextures.size();
-					uint32_t ORMOffset = (uint32_t)AlbedoTextures.size() + (uint32_t)NormalTextures.size();
-					uint32_t emissiveOffset = (uint32_t)AlbedoTextures.size() + (uint32_t)NormalTextures.size() + (uint32_t)ORMTextures.size();
+						cmd.BindVertexBuffer(item.VertexBuffer);
+						cmd.BindIndexBuffer(item.IndexBuffer);
+						cmd.DrawIndexed(item.IndexCount);
+					}
+				});
 
-					scene->IterateComponents<MeshRendererComponent>([&cmd, &albedoIndex, &normalIndex, &ORMIndex, &emissiveIndex, albedoOffset, normalOffset, ORMOffset, emissiveOffset]
-					(Entity e, MeshRendererComponent& mesh)
-						{
-							if (!mesh.Mesh || !mesh.Material)
+			std::vector<RgResourceHandle> shadowMaps;
+			std::vector<RgResourceHandle> staticShadowLayers;
+			if (!shadowDrawLists.empty())
+			{
+				PipelineSpec shadowPipelineSpec = {};
+				shadowPipelineSpec.VertexBufferLayout = gBufferPipelineSpec.VertexBufferLayout;
+				shadowPipelineSpec.PushConstants = { { sizeof(GeometryPassPushConstants), ShaderStage::Vertex } };
+				shadowPipelineSpec.CullMode = ShaderCullMode::Back;
+				shadowPipelineSpec.ColorBlending = {};
+				shadowPipelineSpec.DepthSpec = { .DepthTest = true, .DepthWrite = true, .Operator = DepthTestOp::Less };
+
+				PipelineSpec shadowSkinnedPipelineSpec = shadowPipelineSpec;
+				shadowSkinnedPipelineSpec.VertexBufferLayout = gBufferSkinnedPipelineSpec.VertexBufferLayout;
+
+				auto shadowFragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("ShadowFragmentShader.glsl");
+				auto shadowPipeline = graph->RegisterPipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GBufferShadowVertexShader.glsl"), shadowFragmentShader, shadowPipelineSpec);
+				auto shadowSkinnedPipeline = graph->RegisterPipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GBufferSkinnedShadowVertexShader.glsl"), shadowFragmentShader, shadowSkinnedPipelineSpec);
+
+				auto addShadowPass = [&](const std::string& name, RgResourceHandle target, uint32_t cascade, const std::vector<uint32_t>* items)
+					{
+						graph->AddParallelPass(name,
 							{
-								return;
-							}
+								{ 0, DescriptorType::UniformBuffer, 1, ShaderStage::Vertex },
+								{ 1, DescriptorType::StorageBuffer, 1, ShaderStage::Vertex }
+							},
 
-							GeometryPassPushConstants pushConstants{};
-							pushConstants.Model = e.GetComponent<TransformComponent>().GetModel();
-
-							pushConstants.AlbedoIndex = -1;
-							pushConstants.NormalIndex = -1;
-							pushConstants.ORMIndex = -1;
-							pushConstants.EmissiveIndex = -1;
-
-							if (mesh.Material->GetAlbedoMap())
-							{
-								pushConstants.AlbedoIndex = albedoIndex + albedoOffset;
-								albedoIndex++;
-							}
-							if (mesh.Material->GetNormalMap())
 							{
-								pushConstants.NormalIndex = normalIndex + normalOffset;
-								normalIndex++;
-							}
-							if (mesh.Material->GetORMMap())
+								{ .Size = sizeof(glm::mat4), .Data = (uint32_t*)&shadowCascades.LightViewProj[cascade] },
+								{ .Size = Bones.size() * sizeof(glm::mat4), .Data = (uint32_t*)Bones.data() }
+							},
+
+							[&](RgPassBuilder& builder)
 							{
-								pushConstants.ORMIndex = ORMIndex + ORMOffset;
-								ORMIndex++;
-							}
-							if (mesh.Material->GetEmissiveMap())
+								builder.WriteDepth(target);
+
+								builder.UsePipeline(shadowPipeline);
+								builder.UsePipeline(shadowSkinnedPipeline);
+							},
+							static_cast<uint32_t>(items->size()),
+							[&gBufferDrawItems, items, shadowPipeline, shadowSkinnedPipeline](RgCommandList& cmd, uint32_t first, uint32_t count)
 							{
-								pushConstants.EmissiveIndex = emissiveIndex + emissiveOffset;
-								emissiveIndex++;
-							}
+								ZoneScopedN("Shadow Cascade Pass");
 
-							pushConstants.Tint = glm::vec4(mesh.Material->GetTint(), 1.0);
-							pushConstants.Roughness = mesh.Material->GetRoughnessFactor();
-							pushConstants.Metallic = mesh.Material->GetMetallicFactor();
-							pushConstants.Emissive = mesh.Material->GetEmissive();
+								for (uint32_t i = first; i < first + count; i++)
+								{
+									const auto& item = gBufferDrawItems[(*items)[i]];
 
-							cmd.PushConstants(&pushConstants, sizeof(GeometryPassPushConstants), 0, (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Vertex));
+									cmd.BindPipeline(item.Skinned ? shadowSkinnedPipeline : shadowPipeline);
+									cmd.PushConstants(&item.PushConstants, sizeof(GeometryPassPushConstants), 0, ShaderStage::Vertex);
 
-							cmd.BindVertexBuffer(mesh.Mesh->GetVertexBuffer());
-							cmd.BindIndexBuffer(mesh.Mesh->GetIndexBuffer());
-							cmd.DrawIndexed(mesh.Mesh->GetIndexCount());
-						});
+									cmd.BindVertexBuffer(item.VertexBuffer);
+									cmd.BindIndexBuffer(item.IndexBuffer);
+									cmd.DrawIndexed(item.IndexCount);
+								}
+							});
+					};
 
-					vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GBufferSkinnedVertexShader.glsl");
-					gBufferPipeline.VertexBufferLayout = { {VertexElementType::Float3}, {VertexElementType::Float2}, {VertexElementType::Float3},
-															{VertexElementType::Float3}, {VertexElementType::Int4}, {VertexElementType::Float4} };
-					cmd.BindPipeline(vertexShader, fragmentShader, gBufferPipeline);
+				RgTextureDesc shadowMapDesc = { .Width = settings.Shadows.Resolution, .Height = settings.Shadows.Resolution, .Format = TextureFormat::D32_SFLOAT };
+				for (uint32_t c = 0; c < shadowCascades.CascadeCount; c++)
+				{
+					const auto& lists = shadowDrawLists[c];
 
-					uint32_t boneBaseIndicesIndex = 0;
-					scene->IterateComponents<SkeletalMeshRendererComponent>([&cmd, &albedoIndex, &normalIndex, &ORMIndex, &emissiveIndex, albedoOffset, normalOffset, ORMOffset, emissiveOffset, &boneBaseIndicesIndex, BoneBaseIndices]
-					(Entity e, SkeletalMeshRendererComponent& mesh)
+					// the static layer is only redrawn when a static caster moved or the cascade itself shifted
+					if (lists.Cached)
+					{
+						bool upToDate = false;
+						auto staticLayer = graph->CreatePersistentTexture("ShadowCascadeStatic" + std::to_string(c), shadowMapDesc, lists.StaticHash, upToDate);
+						staticShadowLayers.push_back(staticLayer);
+
+						if (!upToDate)
 						{
-							if (!mesh.SkeletalMesh || !mesh.Skeleton || !mesh.Material)
-							{
-								return;
-							}
+							addShadowPass("Shadow Cascade " + std::to_string(c) + " Static", staticLayer, c, &lists.StaticItems);
+						}
+					}
 
-							GeometryPassPushConstants pushConstants{};
-							pushConstants.Model = e.GetComponent<TransformComponent>().GetModel();
+					auto shadowMap = graph->CreateTexture(shadowMapDesc);
+					shadowMaps.push_back(shadowMap);
 
-							pushConstants.AlbedoIndex = -1;
-							pushConstants.NormalIndex = -1;
-							pushConstants.ORMIndex = -1;
-							pushConstants.EmissiveIndex = -1;
-							pushConstants.BoneBaseIndex = BoneBaseIndices[boneBaseIndicesIndex++];
+					addShadowPass("Shadow Cascade " + std::to_string(c), shadowMap, c, &lists.DynamicItems);
+				}
+			}
 
-							if (mesh.Material->GetAlbedoMap())
-							{
-								pushConstants.AlbedoIndex = albedoIndex + albedoOffset;
-								albedoIndex++;
-							}
-							if (mesh.Material->GetNormalMap())
-							{
-								pushConstants.NormalIndex = normalIndex + normalOffset;
-								normalIndex++;
-							}
-							if (mesh.Material->GetORMMap())
-							{
-								pushConstants.ORMIndex = ORMIndex + ORMOffset;
-								ORMIndex++;
-							}
-							if (mesh.Material->GetEmissiveMap())
-							{
-								pushConstants.EmissiveIndex = emissiveIndex + emissiveOffset;
-								emissiveIndex++;
-							}
+			// unused cascade slots still need a valid image, the shader never samples past CascadeCount
+			std::vector<RgResourceHandle> shadowMapBindings(MAX_SHADOW_CASCADES, shadowMaps.empty() ? lightingInputs[0] : shadowMaps[0]);
+			for (size_t c = 0; c < shadowMaps.size(); c++)
+			{
+				shadowMapBindings[c] = shadowMaps[c];
+			}
 
-							pushConstants.Tint = glm::vec4(mesh.Material->GetTint(), 1.0);
-							pushConstants.Roughness = mesh.Material->GetRoughnessFactor();
-							pushConstants.Metallic = mesh.Material->GetMetallicFactor();
-							pushConstants.Emissive = mesh.Material->GetEmissive();
+			// cascades without a static layer bind their full map again, StaticLayerMask skips the fetch
+			std::vector<RgResourceHandle> staticShadowLayerBindings = shadowMapBindings;
+			for (size_t c = 0, layer = 0; c < shadowDrawLists.size(); c++)
+			{
+				if (shadowDrawLists[c].Cached)
+				{
+					staticShadowLayerBindings[c] = staticShadowLayers[layer++];
+				}
+			}
 
-							cmd.PushConstants(&pushConstants, sizeof(GeometryPassPushConstants), 0, (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Vertex));
+			auto sceneColor = graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA16_SFLOAT });
+			auto sceneBright = graph->CreateTexture({ .Width = renderWidth, .Height = renderHeight, .Format = TextureFormat::RGBA16_SFLOAT });
 
-							cmd.BindVertexBuffer(mesh.SkeletalMesh->GetVertexBuffer());
-							cmd.BindIndexBuffer(mesh.SkeletalMesh->GetIndexBuffer());
-							cmd.DrawIndexed(mesh.SkeletalMesh->GetIndexCount());
-						});
+			ClusterPushConstants clusterParams{};
+			clusterParams.InverseProj = glm::inverse(camera.Proj);
+			clusterParams.ScreenSizeNearFar = glm::vec4((float)renderWidth, (float)renderHeight, camera.NearPlane, camera.FarPlane);
+			clusterParams.LightCount = pointLightCount;
+
+			constexpr uint32_t clusterCount = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+			auto clusterLightCounts = graph->CreateBuffer({ .Size = clusterCount * sizeof(uint32_t), .Type = RgBufferType::DeviceStorage });
+			auto clusterLightIndices = graph->CreateBuffer({ .Size = clusterCount * MAX_LIGHTS_PER_CLUSTER * sizeof(uint32_t), .Type = RgBufferType::DeviceStorage });
+
+			PipelineSpec lightCullingPipelineSpec = {};
+			lightCullingPipelineSpec.PushConstants = { { sizeof(ClusterPushConstants), ShaderStage::Compute } };
+
+			auto lightCullingPipeline = graph->RegisterComputePipeline(
+				Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("ClusterLightCullingComputeShader.glsl"),
+				lightCullingPipelineSpec);
+
+			graph->AddComputePass("Light Culling",
+				{
+					{ 0, DescriptorType::StorageBuffer, 1, ShaderStage::Compute },
+					{ 1, DescriptorType::StorageBuffer, 1, ShaderStage::Compute }
+				},
+				{
+					{ .Buffers = {clusterLightCounts} },
+					{ .Buffers = {clusterLightIndices} }
+				},
+				[&](RgPassBuilder& builder)
+				{
+					builder.WriteBuffer(clusterLightCounts);
+					builder.WriteBuffer(clusterLightIndices);
+					builder.UsePipeline(lightCullingPipeline);
+				},
+				[lightCullingPipeline, clusterParams](RgCommandList& cmd)
+				{
+					ZoneScopedN("Light Culling Pass");
+
+					cmd.BindPipeline(lightCullingPipeline);
+					cmd.PushConstants(&clusterParams, sizeof(ClusterPushConstants), 0, ShaderStage::Compute);
+					cmd.Dispatch(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z);
 				});
 
-			auto sceneColor = graph->CreateTexture({ .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::RGBA16_SFLOAT });
-			auto sceneBright = graph->CreateTexture({ .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::RGBA16_SFLOAT });
+			PipelineSpec lightingPipelineSpec = {};
+			lightingPipelineSpec.VertexBufferLayout = {};
+			lightingPipelineSpec.PushConstants = { { sizeof(ClusterPushConstants), ShaderStage::Fragment } };
+			lightingPipelineSpec.CullMode = ShaderCullMode::None;
+			lightingPipelineSpec.ColorBlending = { BlendMode::None, BlendMode::None };
+			lightingPipelineSpec.DepthSpec = { .DepthTest = false, .DepthWrite = false };
 
-			auto directionalLights = GetDirectionalLights(scene);
-			if (directionalLights.size() == 0)
-				directionalLights.push_back({ .Intensity = 0.0f });
+			auto lightingPipeline = graph->RegisterPipeline(
+				Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("DirectionalLightsVertexShader.glsl"),
+				Application::Get()->MainAssetManager.GetAsset<ShaderAsset>(
+					compactGBuffer ? "ClusteredLightingCompactFragmentShader.glsl" : "ClusteredLightingFragmentShader.glsl"),
+				lightingPipelineSpec);
 
 			graph->AddPass("Lighting",
 				{
@@ -729,16 +1379,26 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 					{ 2, DescriptorType::CombinedImageSampler, 1, ShaderStage::Fragment },
 					{ 3, DescriptorType::CombinedImageSampler, 1, ShaderStage::Fragment },
 					{ 4, DescriptorType::CombinedImageSampler, 1, ShaderStage::Fragment },
-					{ 5, DescriptorType::StorageBuffer, 1, ShaderStage::Fragment }
+					{ 5, DescriptorType::StorageBuffer, 1, ShaderStage::Fragment },
+					{ 6, DescriptorType::StorageBuffer, 1, ShaderStage::Fragment },
+					{ 7, DescriptorType::StorageBuffer, 1, ShaderStage::Fragment },
+					{ 8, DescriptorType::CombinedImageSampler, MAX_SHADOW_CASCADES, ShaderStage::Fragment },
+					{ 9, DescriptorType::UniformBuffer, 1, ShaderStage::Fragment },
+					{ 10, DescriptorType::CombinedImageSampler, MAX_SHADOW_CASCADES, ShaderStage::Fragment }
 				},
 
 				{
-					{ .Resources = {gBufferPosition} },
-					{ .Resources = {gBufferNormal} },
-					{ .Resources = {gBufferAlbedoRoughness} },
-					{ .Resources = {gBufferMetallicAO} },
-					{ .Resources = {gBufferEmissive} },
+					{ .Resources = {lightingInputs[0]} },
+					{ .Resources = {lightingInputs[1]} },
+					{ .Resources = {lightingInputs[2]} },
+					{ .Resources = {lightingInputs[3]} },
+					{ .Resources = {lightingInputs[4]} },
 					{ .Size = directionalLights.size() * sizeof(DirectionalLight), .Data = (uint32_t*)directionalLights.data()},
+					{ .Buffers = {clusterLightCounts} },
+					{ .Buffers = {clusterLightIndices} },
+					{ .Resources = shadowMapBindings },
+					{ .Size = sizeof(ShadowCascadeData), .Data = (uint32_t*)&shadowCascades },
+					{ .Resources = staticShadowLayerBindings }
 				},
 
 				[&](RgPassBuilder& builder)
@@ -746,67 +1406,49 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 					builder.WriteColor(sceneColor);
 					builder.WriteColor(sceneBright);
 
-					builder.ReadTexture(gBufferPosition);
-					builder.ReadTexture(gBufferNormal);
-					builder.ReadTexture(gBufferAlbedoRoughness);
-					builder.ReadTexture(gBufferMetallicAO);
-					builder.ReadTexture(gBufferEmissive);
-				},
-				[&](RgCommandList& cmd)
-				{
-					ZoneScopedN("Lighting Pass");
-
-					// directional lights
-					auto vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("DirectionalLightsVertexShader.glsl");
-					auto fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("DirectionalLightsPBRFragmentShader.glsl");
-
-					PipelineSpec directionalLightsPipeline = {};
-					directionalLightsPipeline.VertexBufferLayout = {};
-					directionalLightsPipeline.PushConstants = {};
-					directionalLightsPipeline.CullMode = ShaderCullMode::None;
-					directionalLightsPipeline.ColorBlending = { BlendMode::None, BlendMode::None };
-					directionalLightsPipeline.DepthSpec = { .DepthTest = false, .DepthWrite = false };
+					for (auto input : lightingInputs)
+					{
+						builder.ReadTexture(input);
+					}
 
-					cmd.BindPipeline(vertexShader, fragmentShader, directionalLightsPipeline);
-					cmd.Draw(3);
+					for (auto shadowMap : shadowMaps)
+					{
+						builder.ReadTexture(shadowMap);
+					}
 
-					// point lights
-					vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("PointLightVertexShader.glsl");
-					fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("PointLightPBRFragmentShader.glsl");
+					for (auto staticLayer : staticShadowLayers)
+					{
+						builder.ReadTexture(staticLayer);
+					}
 
-					PipelineSpec pointLightPipeline = {};
-					pointLightPipeline.VertexBufferLayout = { {VertexElementType::Float3}, {VertexElementType::Float2}, {VertexElementType::Float3} };
-					pointLightPipeline.PushConstants = { { sizeof(LightingPassPushConstants), (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Vertex) } };
-					pointLightPipeline.CullMode = ShaderCullMode::Front;
-					pointLightPipeline.ColorBlending = { BlendMode::Additive, BlendMode::Additive };
-					pointLightPipeline.DepthSpec = { .DepthTest = false, .DepthWrite = false };
+					builder.ReadBuffer(clusterLightCounts);
+					builder.ReadBuffer(clusterLightIndices);
 
-					cmd.BindPipeline(vertexShader, fragmentShader, pointLightPipeline);
+					builder.UsePipeline(lightingPipeline);
+				},
+				[lightingPipeline, clusterParams](RgCommandList& cmd)
+				{
+					ZoneScopedN("Lighting Pass");
 
-					scene->IterateComponents<PointLightComponent>(
-						[&](Entity e, const PointLightComponent& l)
-						{
-							const auto& transform = e.GetComponent<TransformComponent>().GetModel();
-							glm::vec3 position = glm::vec3(transform[3]);
-							glm::mat4 model = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), glm::vec3(l.Radius));
-
-							LightingPassPushConstants pushConstants{};
-							pushConstants.Model = model;
-							pushConstants.Color = l.Color;
-							pushConstants.Intensity = l.Intensity;
-							pushConstants.Position = position;
-							pushConstants.Radius = l.Radius;
-
-							cmd.PushConstants(&pushConstants, sizeof(LightingPassPushConstants), 0, (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Vertex));
-
-							cmd.BindVertexBuffer(s_SphereVertexBuffer.get());
-							cmd.BindIndexBuffer(s_SphereIndexBuffer.get());
-							cmd.DrawIndexed((uint32_t)(s_SphereIndexBuffer->GetSize() / sizeof(uint32_t)));
-						});
+					cmd.BindPipeline(lightingPipeline);
+					cmd.PushConstants(&clusterParams, sizeof(ClusterPushConstants), 0, ShaderStage::Fragment);
+					cmd.Draw(3);
 				});
 
 			if (settings.Rendering.Skybox)
 			{
+				PipelineSpec skyboxPipelineSpec = {};
+				skyboxPipelineSpec.VertexBufferLayout = {};
+				skyboxPipelineSpec.PushConstants = {};
+				skyboxPipelineSpec.CullMode = ShaderCullMode::None;
+				skyboxPipelineSpec.ColorBlending = { BlendMode::None };
+				skyboxPipelineSpec.DepthSpec = { .DepthTest = true, .DepthWrite = false, .Operator = DepthTestOp::LessOrEqual };
+
+				auto skyboxPipeline = graph->RegisterPipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("SkyboxVertexShader.glsl"),
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("SkyboxFragmentShader.glsl"),
+					skyboxPipelineSpec);
+
 				graph->AddPass("Skybox",
 					{
 						{ 0, DescriptorType::CombinedImageSampler, 1, ShaderStage::Fragment }
@@ -820,28 +1462,30 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 					{
 						builder.WriteColor(sceneColor);
 						builder.WriteDepth(gBufferDepth);
+						builder.UsePipeline(skyboxPipeline);
 					},
-					[&](RgCommandList& cmd)
+					[skyboxPipeline](RgCommandList& cmd)
 					{
 						ZoneScopedN("Skybox Pass");
 
-						auto vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("SkyboxVertexShader.glsl");
-						auto fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("SkyboxFragmentShader.glsl");
-
-						PipelineSpec skyboxProcessingPipeline = {};
-						skyboxProcessingPipeline.VertexBufferLayout = {};
-						skyboxProcessingPipeline.PushConstants = {};
-						skyboxProcessingPipeline.CullMode = ShaderCullMode::None;
-						skyboxProcessingPipeline.ColorBlending = { BlendMode::None };
-						skyboxProcessingPipeline.DepthSpec = { .DepthTest = true, .DepthWrite = false, .Operator = DepthTestOp::LessOrEqual };
-
-						cmd.BindPipeline(vertexShader, fragmentShader, skyboxProcessingPipeline);
+						cmd.BindPipeline(skyboxPipeline);
 						cmd.Draw(3);
 					});
 			}
 
 			if (settings.Debug.RenderGrid)
 			{
+				PipelineSpec gridPipelineSpec = {};
+				gridPipelineSpec.VertexBufferLayout = {};
+				gridPipelineSpec.PushConstants = {};
+				gridPipelineSpec.CullMode = ShaderCullMode::None;
+				gridPipelineSpec.ColorBlending = { BlendMode::Alpha };
+
+				auto gridPipeline = graph->RegisterPipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GridVertexShader.glsl"),
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GridFragmentShader.glsl"),
+					gridPipelineSpec);
+
 				graph->AddPass("Grid",
 					{
 						{ 0, DescriptorType::CombinedImageSampler, 1, ShaderStage::Fragment }
@@ -855,21 +1499,13 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 					{
 						builder.WriteColor(sceneColor);
 						builder.ReadTexture(gBufferDepth);
+						builder.UsePipeline(gridPipeline);
 					},
-					[&](RgCommandList& cmd)
+					[gridPipeline](RgCommandList& cmd)
 					{
 						ZoneScopedN("Grid Pass");
 
-						auto vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GridVertexShader.glsl");
-						auto fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("GridFragmentShader.glsl");
-
-						PipelineSpec gridProcessingPipeline = {};
-						gridProcessingPipeline.VertexBufferLayout = {};
-						gridProcessingPipeline.PushConstants = {};
-						gridProcessingPipeline.CullMode = ShaderCullMode::None;
-						gridProcessingPipeline.ColorBlending = { BlendMode::Alpha };
-
-						cmd.BindPipeline(vertexShader, fragmentShader, gridProcessingPipeline);
+						cmd.BindPipeline(gridPipeline);
 						cmd.Draw(3);
 					});
 			}
@@ -899,6 +1535,18 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 				CollectGizmoRenderData(billboardGizmos, instanceData, billboardTextures);
 				uint32_t instanceCount = static_cast<uint32_t>(instanceData.size());
 
+				PipelineSpec billboardPipelineSpec = {};
+				billboardPipelineSpec.VertexBufferLayout = {};
+				billboardPipelineSpec.PushConstants = {};
+				billboardPipelineSpec.CullMode = ShaderCullMode::None;
+				billboardPipelineSpec.ColorBlending = { BlendMode::Alpha };
+				billboardPipelineSpec.DepthSpec = { .DepthTest = true, .DepthWrite = false };
+
+				auto billboardPipeline = graph->RegisterPipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("BillboardVertexShader.glsl"),
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("BillboardFragmentShader.glsl"),
+					billboardPipelineSpec);
+
 				graph->AddPass("Billboard Gizmo",
 					{
 						{ 0, DescriptorType::StorageBuffer, 1, ShaderStage::Vertex },
@@ -913,50 +1561,44 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 					{
 						builder.WriteColor(sceneColor);
 						builder.WriteDepth(gBufferDepth);
+						builder.UsePipeline(billboardPipeline);
 					},
-					[instanceCount](RgCommandList& cmd)
+					[instanceCount, billboardPipeline](RgCommandList& cmd)
 					{
 						ZoneScopedN("Billboard Gizmo Pass");
 
-						auto vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("BillboardVertexShader.glsl");
-						auto fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("BillboardFragmentShader.glsl");
-
-						PipelineSpec billboardPipeline = {};
-						billboardPipeline.VertexBufferLayout = {};
-						billboardPipeline.PushConstants = {};
-						billboardPipeline.CullMode = ShaderCullMode::None;
-						billboardPipeline.ColorBlending = { BlendMode::Alpha };
-						billboardPipeline.DepthSpec = { .DepthTest = true, .DepthWrite = false };
-
-						cmd.BindPipeline(vertexShader, fragmentShader, billboardPipeline);
+						cmd.BindPipeline(billboardPipeline);
 						cmd.Draw(6, instanceCount);
 					});
 			}
 
 			if (!wireframeGizmos.empty())
 			{
+				PipelineSpec wireframePipelineSpec = {};
+				wireframePipelineSpec.VertexBufferLayout = { { VertexElementType::Float3 } };
+				wireframePipelineSpec.PushConstants = { { sizeof(glm::mat4) + sizeof(glm::vec3), (ShaderStage)((uint8_t)ShaderStage::Vertex | (uint8_t)ShaderStage::Fragment) } };
+				wireframePipelineSpec.CullMode = ShaderCullMode::None;
+				wireframePipelineSpec.ColorBlending = { BlendMode::Alpha };
+				wireframePipelineSpec.PolygonMode = PolygonModeStyle::Line;
+				wireframePipelineSpec.DepthSpec = { .DepthTest = true, .DepthWrite = false };
+
+				auto wireframePipeline = graph->RegisterPipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("WireframeVertexShader.glsl"),
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("WireframeFragmentShader.glsl"),
+					wireframePipelineSpec);
+
 				graph->AddPass("Wireframe Gizmo", {}, {},
 					[&](RgPassBuilder& builder)
 					{
 						builder.WriteColor(sceneColor);
 						builder.WriteDepth(gBufferDepth);
+						builder.UsePipeline(wireframePipeline);
 					},
-					[drawDataList](RgCommandList& cmd)
+					[drawDataList, wireframePipeline](RgCommandList& cmd)
 					{
 						ZoneScopedN("Wireframe Gizmo Pass");
 
-						auto vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("WireframeVertexShader.glsl");
-						auto fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("WireframeFragmentShader.glsl");
-
-						PipelineSpec wireframePipeline = {};
-						wireframePipeline.VertexBufferLayout = { { VertexElementType::Float3 } };
-						wireframePipeline.PushConstants = { { sizeof(glm::mat4) + sizeof(glm::vec3), (ShaderStage)((uint8_t)ShaderStage::Vertex | (uint8_t)ShaderStage::Fragment) } };
-						wireframePipeline.CullMode = ShaderCullMode::None;
-						wireframePipeline.ColorBlending = { BlendMode::Alpha };
-						wireframePipeline.PolygonMode = PolygonModeStyle::Line;
-						wireframePipeline.DepthSpec = { .DepthTest = true, .DepthWrite = false };
-
-						cmd.BindPipeline(vertexShader, fragmentShader, wireframePipeline);
+						cmd.BindPipeline(wireframePipeline);
 
 						for (const auto& drawData : drawDataList)
 						{
@@ -991,60 +1633,183 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 			}
 
 			RgResourceHandle currentSceneTarget = sceneColor;
+
+			// resolves the jittered frame against the reprojected history at output resolution, the result is next frame's history
+			if (temporalEnabled)
+			{
+				RgTextureDesc historyDesc = { .Width = textureWidth, .Height = textureHeight, .Format = TextureFormat::RGBA16_SFLOAT };
+
+				bool historyValid = false;
+				bool resolvedUpToDate = false;
+				auto history = graph->CreatePersistentTexture("TemporalHistory" + std::to_string((frameIndex + 1) % 2), historyDesc, frameIndex - 1, historyValid);
+				auto resolved = graph->CreatePersistentTexture("TemporalHistory" + std::to_string(frameIndex % 2), historyDesc, frameIndex, resolvedUpToDate);
+
+				TemporalResolvePushConstants params{};
+				params.Reprojection = temporalState.PrevViewProj * glm::inverse(unjitteredViewProj);
+				params.Jitter = -jitterPixels; // a pixel sees the scene shifted against the projection offset
+				params.InputSize = glm::vec2((float)renderWidth, (float)renderHeight);
+				params.OutputSize = glm::vec2((float)textureWidth, (float)textureHeight);
+				params.OutputTexelSize = 1.0f / params.OutputSize;
+				params.FeedbackMin = settings.Temporal.FeedbackMin;
+				params.FeedbackMax = settings.Temporal.FeedbackMax;
+				params.HistoryValid = historyValid;
+
+				PipelineSpec temporalPipelineSpec = {};
+				temporalPipelineSpec.PushConstants = { { sizeof(TemporalResolvePushConstants), ShaderStage::Compute } };
+
+				auto temporalPipeline = graph->RegisterComputePipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("TemporalResolveComputeShader.glsl"), temporalPipelineSpec);
+
+				graph->AddComputePass("Temporal Resolve",
+					{
+						{ 0, DescriptorType::CombinedImageSampler, 1, ShaderStage::Compute },
+						{ 1, DescriptorType::CombinedImageSampler, 1, ShaderStage::Compute },
+						{ 2, DescriptorType::CombinedImageSampler, 1, ShaderStage::Compute },
+						{ 3, DescriptorType::StorageImage, 1, ShaderStage::Compute },
+						{ 4, DescriptorType::CombinedImageSampler, 1, ShaderStage::Compute }
+					},
+					{
+						{ .Resources = {sceneColor} },
+						{ .Resources = {gBufferDepth} },
+						{ .Resources = {history} },
+						{ .Resources = {resolved} },
+						{ .Resources = {gBufferVelocity} }
+					},
+					[&](RgPassBuilder& builder)
+					{
+						builder.ReadTexture(sceneColor);
+						builder.ReadTexture(gBufferDepth);
+						builder.ReadTexture(history);
+						builder.ReadTexture(gBufferVelocity);
+						builder.WriteStorageImage(resolved);
+						builder.UsePipeline(temporalPipeline);
+					},
+					[temporalPipeline, params, textureWidth, textureHeight](RgCommandList& cmd)
+					{
+						ZoneScopedN("Temporal Resolve Pass");
+
+						cmd.BindPipeline(temporalPipeline);
+						cmd.PushConstants(&params, sizeof(TemporalResolvePushConstants), 0, ShaderStage::Compute);
+						cmd.Dispatch((textureWidth + 7) / 8, (textureHeight + 7) / 8, 1);
+					});
+
+				currentSceneTarget = resolved;
+			}
+
 			RgResourceHandle finalBloomTarget;
 
-			if (settings.PostProcessing.BloomEnabled && settings.PostProcessing.BloomIterations > 0)
+			if (settings.PostProcessing.BloomEnabled && settings.PostProcessing.BloomMipCount > 0)
 			{
-				uint32_t bloomWidth = std::max(1u, textureWidth / 2);
-				uint32_t bloomHeight = std::max(1u, textureHeight / 2);
+				// every mip halves the resolution, so the blur radius doubles per level while the cost shrinks geometrically
+				std::vector<RgResourceHandle> bloomMips;
+				std::vector<glm::uvec2> bloomMipSizes;
+
+				uint32_t mipWidth = renderWidth;
+				uint32_t mipHeight = renderHeight;
+				for (uint32_t i = 0; i < std::min<uint32_t>(settings.PostProcessing.BloomMipCount, MAX_BLOOM_MIPS); i++)
+				{
+					if (mipWidth < 2 || mipHeight < 2)
+						break;
 
-				RgResourceHandle blurPing = graph->CreateTexture({ .Width = bloomWidth, .Height = bloomHeight, .Format = TextureFormat::RGBA16_SFLOAT });
-				RgResourceHandle blurPong = graph->CreateTexture({ .Width = bloomWidth, .Height = bloomHeight, .Format = TextureFormat::RGBA16_SFLOAT });
+					mipWidth /= 2;
+					mipHeight /= 2;
 
-				uint8_t numBlurPasses = settings.PostProcessing.BloomIterations * 2;
-				for (uint8_t i = 0; i < numBlurPasses; i++)
+					bloomMips.push_back(graph->CreateTexture({ .Width = mipWidth, .Height = mipHeight, .Format = TextureFormat::RGBA16_SFLOAT }));
+					bloomMipSizes.push_back({ mipWidth, mipHeight });
+				}
+
+				PipelineSpec bloomPipelineSpec = {};
+				bloomPipelineSpec.PushConstants = { { sizeof(BloomPushConstants), ShaderStage::Compute } };
+
+				auto downsamplePipeline = graph->RegisterComputePipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("BloomDownsampleComputeShader.glsl"), bloomPipelineSpec);
+				auto upsamplePipeline = graph->RegisterComputePipeline(
+					Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("BloomUpsampleComputeShader.glsl"), bloomPipelineSpec);
+
+				glm::uvec2 sourceSize = { renderWidth, renderHeight };
+				RgResourceHandle source = sceneBright;
+				for (size_t i = 0; i < bloomMips.size(); i++)
 				{
-					std::string name = "Bloom Blur Pass " + std::to_string(i);
-					bool horizontal = (i % 2) == 0;
+					RgResourceHandle target = bloomMips[i];
+					glm::uvec2 targetSize = bloomMipSizes[i];
 
-					RgResourceHandle readTarget = (i == 0) ? sceneBright : (horizontal ? blurPong : blurPing);
-					RgResourceHandle writeTarget = horizontal ? blurPing : blurPong;
+					BloomPushConstants params{};
+					params.SourceTexelSize = 1.0f / glm::vec2(sourceSize);
+					params.KarisAverage = i == 0;
+					params.Scale = 1.0f;
 
-					graph->AddPass(name,
-						{ { 0, DescriptorType::CombinedImageSampler, 1, ShaderStage::Fragment } },
-						{ {.Resources = {readTarget} } },
+					graph->AddComputePass("Bloom Downsample " + std::to_string(i),
+						{
+							{ 0, DescriptorType::CombinedImageSampler, 1, ShaderStage::Compute },
+							{ 1, DescriptorType::StorageImage, 1, ShaderStage::Compute }
+						},
+						{
+							{ .Resources = {source} },
+							{ .Resources = {target} }
+						},
 						[&](RgPassBuilder& builder)
 						{
-							builder.WriteColor(writeTarget);
-							builder.ReadTexture(readTarget);
+							builder.ReadTexture(source);
+							builder.WriteStorageImage(target);
+							builder.UsePipeline(downsamplePipeline);
 						},
-						[horizontal](RgCommandList& cmd)
+						[downsamplePipeline, params, targetSize](RgCommandList& cmd)
 						{
-							ZoneScopedN("Bloom Blur Pass");
+							ZoneScopedN("Bloom Downsample Pass");
 
-							auto vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("BlurVertexShader.glsl");
-							auto fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("BlurFragmentShader.glsl");
+							cmd.BindPipeline(downsamplePipeline);
+							cmd.PushConstants(&params, sizeof(BloomPushConstants), 0, ShaderStage::Compute);
+							cmd.Dispatch((targetSize.x + 7) / 8, (targetSize.y + 7) / 8, 1);
+						});
 
-							PipelineSpec blurPipeline = {};
-							blurPipeline.VertexBufferLayout = {};
-							blurPipeline.PushConstants = { { sizeof(BlurPushConstants), ShaderStage::Fragment } };
-							blurPipeline.CullMode = ShaderCullMode::None;
-							blurPipeline.ColorBlending = { BlendMode::None };
-							blurPipeline.DepthSpec = { .DepthTest = false, .DepthWrite = false };
+					source = target;
+					sourceSize = targetSize;
+				}
 
-							cmd.BindPipeline(vertexShader, fragmentShader, blurPipeline);
+				// walk back up, each level adds a tent filtered copy of the level below it
+				for (int32_t i = (int32_t)bloomMips.size() - 2; i >= 0; i--)
+				{
+					RgResourceHandle target = graph->CreateTexture({ .Width = bloomMipSizes[i].x, .Height = bloomMipSizes[i].y, .Format = TextureFormat::RGBA16_SFLOAT });
+					RgResourceHandle downsampled = bloomMips[i];
+					glm::uvec2 targetSize = bloomMipSizes[i];
 
-							BlurPushConstants pc{};
-							pc.Horizontal = horizontal;
+					BloomPushConstants params{};
+					params.SourceTexelSize = 1.0f / glm::vec2(sourceSize);
+					params.KarisAverage = 0;
+					params.Scale = i == 0 ? 1.0f / (float)bloomMips.size() : 1.0f; // every level contributed once
 
-							cmd.PushConstants(&pc, sizeof(BlurPushConstants), 0, ShaderStage::Fragment);
+					graph->AddComputePass("Bloom Upsample " + std::to_string(i),
+						{
+							{ 0, DescriptorType::CombinedImageSampler, 1, ShaderStage::Compute },
+							{ 1, DescriptorType::CombinedImageSampler, 1, ShaderStage::Compute },
+							{ 2, DescriptorType::StorageImage, 1, ShaderStage::Compute }
+						},
+						{
+							{ .Resources = {source} },
+							{ .Resources = {downsampled} },
+							{ .Resources = {target} }
+						},
+						[&](RgPassBuilder& builder)
+						{
+							builder.ReadTexture(source);
+							builder.ReadTexture(downsampled);
+							builder.WriteStorageImage(target);
+							builder.UsePipeline(upsamplePipeline);
+						},
+						[upsamplePipeline, params, targetSize](RgCommandList& cmd)
+						{
+							ZoneScopedN("Bloom Upsample Pass");
 
-							cmd.Draw(3);
-						}
-					);
+							cmd.BindPipeline(upsamplePipeline);
+							cmd.PushConstants(&params, sizeof(BloomPushConstants), 0, ShaderStage::Compute);
+							cmd.Dispatch((targetSize.x + 7) / 8, (targetSize.y + 7) / 8, 1);
+						});
 
-					finalBloomTarget = writeTarget;
+					source = target;
+					sourceSize = targetSize;
 				}
+
+				finalBloomTarget = bloomMips.empty() ? RgResourceHandle{} : source;
 			}
 
 			RgResourceHandle sceneFinal;
@@ -1055,6 +1820,18 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 
 			RgResourceHandle bloomInput = (finalBloomTarget.IsValid()) ? finalBloomTarget : sceneBright;
 
+			PipelineSpec postProcessingPipelineSpec = {};
+			postProcessingPipelineSpec.VertexBufferLayout = {};
+			postProcessingPipelineSpec.PushConstants = {};
+			postProcessingPipelineSpec.CullMode = ShaderCullMode::None;
+			postProcessingPipelineSpec.ColorBlending = { BlendMode::None };
+			postProcessingPipelineSpec.DepthSpec = { .DepthTest = false, .DepthWrite = false };
+
+			auto postProcessingPipeline = graph->RegisterPipeline(
+				Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("PostProcessingVertexShader.glsl"),
+				Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("PostProcessingFragmentShader.glsl"),
+				postProcessingPipelineSpec);
+
 			graph->AddPass("Post Processing Composite",
 				{
 					{ 0, DescriptorType::CombinedImageSampler, 1, ShaderStage::Fragment },
@@ -1068,31 +1845,30 @@ RgTextureView DefaultRenderer::RenderSceneDeferred(Renderer* renderer, RenderSet
 					builder.WriteColor(sceneFinal);
 					builder.ReadTexture(currentSceneTarget);
 					builder.ReadTexture(bloomInput);
+					builder.UsePipeline(postProcessingPipeline);
 				},
-				[settings](RgCommandList& cmd) {
+				[postProcessingPipeline](RgCommandList& cmd) {
 					ZoneScopedN("Post Processing Composite Pass");
 
-					auto vertexShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("PostProcessingVertexShader.glsl");
-					auto fragmentShader = Application::Get()->MainAssetManager.GetAsset<ShaderAsset>("PostProcessingFragmentShader.glsl");
-
-					PipelineSpec postProcessingPipeline = {};
-					postProcessingPipeline.VertexBufferLayout = {};
-					postProcessingPipeline.PushConstants = {};
-					postProcessingPipeline.CullMode = ShaderCullMode::None;
-					postProcessingPipeline.ColorBlending = { BlendMode::None };
-					postProcessingPipeline.DepthSpec = { .DepthTest = false, .DepthWrite = false };
-
-					cmd.BindPipeline(vertexShader, fragmentShader, postProcessingPipeline);
+					cmd.BindPipeline(postProcessingPipeline);
 					cmd.Draw(3);
 				});
 
 			if (!settings.Display.RenderToSwapChain)
 				graph->AddOutput(sceneFinal);
 
-			graph->Compile({ { 0, DescriptorType::UniformBuffer, 1, (ShaderStage)((uint32_t)ShaderStage::Vertex | (uint32_t)ShaderStage::Fragment) } });
-			return { { sizeof(UniformBuffer), (uint32_t*)&cameraInfo } };
+			graph->Compile({
+				{ 0, DescriptorType::UniformBuffer, 1, (ShaderStage)((uint32_t)ShaderStage::Vertex | (uint32_t)ShaderStage::Fragment) },
+				{ 1, DescriptorType::StorageBuffer, 1, (ShaderStage)((uint32_t)ShaderStage::Fragment | (uint32_t)ShaderStage::Compute) }
+			});
+			return {
+				{ sizeof(UniformBuffer), (uint32_t*)&cameraInfo },
+				{ pointLights.size() * sizeof(PointLight), (uint32_t*)pointLights.data() }
+			};
 		}, settings.Display.RenderToSwapChain);
 
+	temporalState.PrevViewProj = unjitteredViewProj;
+
 	if (settings.Display.RenderToSwapChain)
 		return RgTextureView{};
 
@@ -1201,23 +1977,52 @@ void DefaultRenderer::UploadBones(Scene* scene, std::vector<glm::mat4>& bones, s
 				return;
 
 			boneBaseIndices.push_back(static_cast<uint32_t>(bones.size()));
-			bones.insert(bones.begin(), m.Bones.begin(), m.Bones.end());
+			bones.insert(bones.end(), m.Bones.begin(), m.Bones.end());
 		});
 }
 
 std::vector<DirectionalLight> DefaultRenderer::GetDirectionalLights(Scene* scene)
 {
+	const auto& world = scene->GetWorldTransforms();
+
 	std::vector<DirectionalLight> directionalLights;
 	scene->IterateComponents<DirectionalLightComponent>(
 		[&](Entity e, const DirectionalLightComponent& l)
 		{
-			const auto& transform = e.GetComponent<TransformComponent>().GetModel();
-			directionalLights.push_back({ l.Color, l.Intensity, glm::vec3(transform[2]), 0.0f });
+			uint32_t slot = world.GetSlot((entt::entity)e.GetID());
+			if (slot == INVALID_WORLD_SLOT)
+				return;
+
+			const auto& transform = world.Matrices[slot];
+			directionalLights.push_back({ l.Color, l.Intensity, glm::vec3(transform[2]), l.CastShadows ? 1.0f : 0.0f });
 		});
 
 	return directionalLights;
 }
 
+std::vector<PointLight> DefaultRenderer::GetPointLights(Scene* scene, const glm::mat4& view)
+{
+	const auto& world = scene->GetWorldTransforms();
+
+	std::vector<PointLight> pointLights;
+	pointLights.reserve(scene->GetRegistry().storage<PointLightComponent>().size());
+	scene->IterateComponents<PointLightComponent>(
+		[&](Entity e, const PointLightComponent& l)
+		{
+			uint32_t slot = world.GetSlot((entt::entity)e.GetID());
+			if (slot == INVALID_WORLD_SLOT)
+				return;
+
+			const auto& transform = world.Matrices[slot];
+			glm::vec3 position = glm::vec3(transform[3]);
+			glm::vec3 viewPosition = glm::vec3(view * glm::vec4(position, 1.0f));
+
+			pointLights.push_back({ position, l.Radius, l.Color, l.Intensity, viewPosition, 0.0f });
+		});
+
+	return pointLights;
+}
+
 void DefaultRenderer::CollectGizmoRenderData(const std::vector<Gizmo>& gizmos, std::vector<BillboardInstanceData>& instanceData, std::vector<const Texture*>& textures)
 {
 	instanceData.reserve(gizmos.size());
@@ -130,6 +130,9 @@ void Texture::ExtractVulkanFlags()
 	case TextureFormat::RGBA8_SRGB:    m_VkFormat = VK_FORMAT_R8G8B8A8_SRGB; break;
 	case TextureFormat::RGBA16_SFLOAT: m_VkFormat = VK_FORMAT_R16G16B16A16_SFLOAT; break;
 	case TextureFormat::BGRA8_SRGB:    m_VkFormat = VK_FORMAT_B8G8R8A8_SRGB; break;
+	case TextureFormat::RGBA8_UNORM:   m_VkFormat = VK_FORMAT_R8G8B8A8_UNORM; break;
+	case TextureFormat::RG16_SFLOAT:   m_VkFormat = VK_FORMAT_R16G16_SFLOAT; break;
+	case TextureFormat::B10G11R11_UFLOAT: m_VkFormat = VK_FORMAT_B10G11R11_UFLOAT_PACK32; break;
 	case TextureFormat::D32_SFLOAT:
 		m_VkFormat = VK_FORMAT_D32_SFLOAT;
 		m_AspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
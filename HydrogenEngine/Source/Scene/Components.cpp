@@ -3,10 +3,10 @@
 
 using namespace Hydrogen;
 
-void GenericComponent::Serialize(json& j) const
+void Hydrogen::SerializeFields(const void* component, const std::vector<FieldInfo>& fields, json& j)
 {
-	char* basePtr = (char*)this;
-	for (const auto& field : GetReflectionFields())
+	char* basePtr = (char*)component;
+	for (const auto& field : fields)
 	{
 		char* fieldPtr = basePtr + field.Offset;
 
@@ -37,10 +37,10 @@ void GenericComponent::Serialize(json& j) const
 	}
 }
 
-void GenericComponent::Deserialize(const json& j)
+void Hydrogen::DeserializeFields(void* component, const std::vector<FieldInfo>& fields, const json& j)
 {
-	char* basePtr = (char*)this;
-	for (const auto& field : GetReflectionFields())
+	char* basePtr = (char*)component;
+	for (const auto& field : fields)
 	{
 		if (!j.contains(field.Name)) continue;
 
@@ -128,6 +128,31 @@ void GenericComponent::Deserialize(const json& j)
 	}
 }
 
+void Hydrogen::CopyFields(const void* source, void* target, const std::vector<FieldInfo>& fields)
+{
+	const char* sourcePtr = (const char*)source;
+	char* targetPtr = (char*)target;
+	for (const auto& field : fields)
+	{
+		const char* from = sourcePtr + field.Offset;
+		char* to = targetPtr + field.Offset;
+
+		switch (field.Type)
+		{
+		case FieldType::Float: *reinterpret_cast<float*>(to) = *reinterpret_cast<const float*>(from); break;
+		case FieldType::Int: *reinterpret_cast<int*>(to) = *reinterpret_cast<const int*>(from); break;
+		case FieldType::UInt64: *reinterpret_cast<uint64_t*>(to) = *reinterpret_cast<const uint64_t*>(from); break;
+		case FieldType::Bool: *reinterpret_cast<bool*>(to) = *reinterpret_cast<const bool*>(from); break;
+		case FieldType::String: *reinterpret_cast<std::string*>(to) = *reinterpret_cast<const std::string*>(from); break;
+		case FieldType::Vec2: *reinterpret_cast<glm::vec2*>(to) = *reinterpret_cast<const glm::vec2*>(from); break;
+		case FieldType::Vec3: *reinterpret_cast<glm::vec3*>(to) = *reinterpret_cast<const glm::vec3*>(from); break;
+		case FieldType::Vec4: *reinterpret_cast<glm::vec4*>(to) = *reinterpret_cast<const glm::vec4*>(from); break;
+		case FieldType::Quaternion: *reinterpret_cast<glm::quat*>(to) = *reinterpret_cast<const glm::quat*>(from); break;
+		case FieldType::Asset: *reinterpret_cast<std::shared_ptr<Asset>*>(to) = *reinterpret_cast<const std::shared_ptr<Asset>*>(from); break;
+		}
+	}
+}
+
 void ScriptsComponent::Serialize(json& j) const
 {
 	j["Scripts"] = json::array();
@@ -171,7 +196,30 @@ void ScriptsComponent::Deserialize(const json& j)
 {
 }
 
-void ScriptsComponent::PostDeserialize(const json& j)
+void ScriptsComponent::RemapEntities(json& j, const std::unordered_map<uint64_t, uint64_t>& uuids)
+{
+	if (!j.contains("Scripts") || !j["Scripts"].is_array())
+		return;
+
+	for (auto& scriptJson : j["Scripts"])
+	{
+		if (!scriptJson.is_object() || !scriptJson.contains("Fields") || !scriptJson["Fields"].is_array())
+			continue;
+
+		for (auto& fieldJson : scriptJson["Fields"])
+		{
+			if (fieldJson.value("Type", -1) != static_cast<int>(ScriptFieldType::Entity) || !fieldJson.contains("Value"))
+				continue;
+
+			// references to entities outside the copied set are kept as they are
+			auto it = uuids.find(fieldJson["Value"].get<uint64_t>());
+			if (it != uuids.end())
+				fieldJson["Value"] = it->second;
+		}
+	}
+}
+
+void ScriptsComponent::PostDeserialize(const json& j, Entity entity)
 {
 	Scripts.clear();
 
@@ -222,7 +270,7 @@ void ScriptsComponent::PostDeserialize(const json& j)
 				case ScriptFieldType::Entity:
 				{
 					uint64_t uuid = fieldJson["Value"].get<uint64_t>();
-					field.Value = GetEntity().GetScene()->GetEntityByUUID(uuid);
+					field.Value = entity.GetScene()->GetEntityByUUID(uuid);
 					break;
 				}
 				default:
@@ -1,6 +1,8 @@
 #include "Hydrogen/Scene/Physics.hpp"
 #include "Hydrogen/Scene/Components.hpp"
+#include "Hydrogen/Scene/SystemScheduler.hpp"
 #include "Hydrogen/Application.hpp"
+#include "Tracy/Tracy.hpp"
 
 using namespace Hydrogen;
 
@@ -41,13 +43,17 @@ void PhysicsWorld::Reset()
 	}
 }
 
-reactphysics3d::RigidBody* PhysicsWorld::CreateRigidbody(const TransformComponent& transform) const
+reactphysics3d::RigidBody* PhysicsWorld::CreateRigidbody(const glm::mat4& world) const
 {
 	HY_ASSERT(m_PhysicsWorld, "Physics world is null!");
 
-	glm::vec3 translation = transform.GetTranslation();
-	glm::vec3 scale = transform.GetScale();
-	glm::quat rotation = transform.GetRotation();
+	// bodies simulate in world space, the matrix already carries every parent
+	glm::vec3 translation = glm::vec3(world[3]);
+	glm::vec3 scale = glm::vec3(glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2])));
+	glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+
+	if (scale.x > 0.0f && scale.y > 0.0f && scale.z > 0.0f)
+		rotation = glm::quat_cast(glm::mat3(glm::vec3(world[0]) / scale.x, glm::vec3(world[1]) / scale.y, glm::vec3(world[2]) / scale.z));
 
 	if (glm::length(scale) < 0.001f)
 	{
@@ -86,12 +92,47 @@ void PhysicsWorld::DestroyRigidbody(reactphysics3d::RigidBody* body)
 
 void PhysicsWorld::UpdatePhysics(float timestep)
 {
+	if (m_HasPendingBodies)
+	{
+		CreatePendingBodies();
+	}
+
 	if (m_PhysicsWorld)
 	{
 		m_PhysicsWorld->update(static_cast<reactphysics3d::decimal>(timestep));
 	}
 }
 
+void PhysicsWorld::CreatePendingBodies()
+{
+	ZoneScoped;
+
+	// bodies start from the world matrices, so the hierarchy of new entities has to be linked and resolved first
+	m_Scene->UpdateTransforms();
+
+	auto& registry = m_Scene->GetRegistry();
+	for (auto [entity, transform, rigidbody] : registry.view<TransformComponent, RigidbodyComponent>().each())
+	{
+		if (rigidbody.Rigidbody)
+			continue;
+
+		rigidbody.Rigidbody = CreateRigidbody(transform.GetWorldMatrix());
+		rigidbody.ApplyFields();
+	}
+
+	// colliders go second, they take their mass from the rigidbody
+	for (auto [entity, collider] : registry.view<ColliderComponent>().each())
+	{
+		if (collider.Collider)
+			continue;
+
+		collider.Rigidbody = registry.try_get<RigidbodyComponent>(entity);
+		collider.CreateCollider();
+	}
+
+	m_HasPendingBodies = false;
+}
+
 void PhysicsWorld::SyncTransforms()
 {
 	if (!m_PhysicsWorld || !m_Scene)
@@ -100,7 +141,8 @@ void PhysicsWorld::SyncTransforms()
 		return;
 	}
 
-	m_Scene->IterateComponents<TransformComponent, RigidbodyComponent>([](Entity entity, TransformComponent& transform, RigidbodyComponent& rb)
+	// every body only writes its own transform, so chunks of the view run in parallel
+	SystemScheduler::ParallelForEach<TransformComponent, RigidbodyComponent>(m_Scene, [](Entity entity, TransformComponent& transform, RigidbodyComponent& rb)
 		{
 			if (!rb.Rigidbody || (reactphysics3d::BodyType)rb.Type == reactphysics3d::BodyType::STATIC) return;
 
@@ -109,8 +151,21 @@ void PhysicsWorld::SyncTransforms()
 			reactphysics3d::Vector3 p = t.getPosition();
 			reactphysics3d::Quaternion q = t.getOrientation();
 
-			transform.SetTranslation(glm::vec3(p.x, p.y, p.z));
-			transform.SetRotation(glm::quat(q.w, q.x, q.y, q.z));
+			glm::vec3 position(p.x, p.y, p.z);
+			glm::quat rotation(q.w, q.x, q.y, q.z);
+
+			// bodies simulate in world space, children store their pose relative to the parent
+			Entity parent = entity.GetScene()->GetParent(entity);
+			if (parent.IsValid())
+			{
+				glm::mat4 local = glm::inverse(parent.GetComponent<TransformComponent>().GetWorldMatrix()) * (glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation));
+
+				position = glm::vec3(local[3]);
+				rotation = glm::normalize(glm::quat_cast(glm::mat3(glm::normalize(glm::vec3(local[0])), glm::normalize(glm::vec3(local[1])), glm::normalize(glm::vec3(local[2])))));
+			}
+
+			transform.SetTranslation(position);
+			transform.SetRotation(rotation);
 		});
 }
 
@@ -133,9 +188,8 @@ void RigidbodyComponent::ApplyRotationLock()
 }
 
 RigidbodyComponent::RigidbodyComponent(Entity entity)
-	: GenericComponent(entity)
 {
-	Rigidbody = entity.GetScene()->GetPhysicsWorld().CreateRigidbody(entity.GetComponent<TransformComponent>());
+	entity.GetScene()->GetPhysicsWorld().RequestPendingBodies();
 }
 
 void RigidbodyComponent::SetType(reactphysics3d::BodyType type)
@@ -188,9 +242,8 @@ void RigidbodyComponent::SetAngularVelocity(glm::vec3 velocity)
 	if (Rigidbody) Rigidbody->setAngularVelocity({ velocity.x, velocity.y, velocity.z });
 }
 
-void RigidbodyComponent::Deserialize(const json& j)
+void RigidbodyComponent::ApplyFields()
 {
-	GenericComponent::Deserialize(j);
 	if (Rigidbody)
 	{
 		Rigidbody->setType((reactphysics3d::BodyType)Type);
@@ -217,14 +270,10 @@ void RigidbodyComponent::Deserialize(const json& j)
 			Rigidbody->setLocalCenterOfMass(reactphysics3d::Vector3(0.0f, 0.0f, 0.0f));
 		}
 	}
-	else
-	{
-		//createrigidbody
-	}
 }
 
 ColliderComponent::ColliderComponent(Entity entity)
-	: GenericComponent(entity), Rigidbody(entity.TryGetComponent<RigidbodyComponent>()), Collider(nullptr)
+	: Rigidbody(entity.TryGetComponent<RigidbodyComponent>()), Collider(nullptr)
 {
 	CreateCollider();
 }
@@ -285,9 +334,3 @@ void ColliderComponent::CreateCollider()
 	body->setLinearVelocity(reactphysics3d::Vector3(0.0f, 0.0f, 0.0f));
 	body->setAngularVelocity(reactphysics3d::Vector3(0.0f, 0.0f, 0.0f));
 }
-
-void ColliderComponent::Deserialize(const json& j)
-{
-	GenericComponent::Deserialize(j);
-	CreateCollider();
-}
@@ -0,0 +1,241 @@
+#include "Hydrogen/Scene/Prefab.hpp"
+#include "Hydrogen/AssetManager.hpp"
+#include "Tracy/Tracy.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace Hydrogen;
+
+void PrefabAsset::Read()
+{
+	std::ifstream fin(m_Filepath);
+	std::stringstream buffer;
+	buffer << fin.rdbuf();
+	m_Content = std::move(buffer.str());
+	fin.close();
+
+	if (m_Content.empty())
+	{
+		m_Content = "{}";
+	}
+
+	// instances already spawned keep their copies, the next spawn rebuilds from the new content
+	m_Template.reset();
+}
+
+const PrefabTemplate& PrefabAsset::GetTemplate()
+{
+	if (m_Template)
+		return *m_Template;
+
+	ZoneScoped;
+
+	auto prefab = std::make_shared<PrefabTemplate>();
+	prefab->Source = std::make_shared<Scene>();
+
+	json content = json::parse(m_Content, nullptr, false);
+	if (content.is_object())
+		prefab->Source->DeserializeScene(content);
+	else
+		HY_ENGINE_ERROR("Failed to parse prefab '{}'", m_Filepath);
+
+	Scene& source = *prefab->Source;
+	auto& registry = source.GetRegistry();
+
+	std::unordered_map<entt::entity, int32_t> nodes;
+	std::vector<entt::entity> nodeEntities;
+	for (auto entity : registry.view<UUIDComponent>())
+	{
+		nodes[entity] = static_cast<int32_t>(prefab->Nodes.size());
+		nodeEntities.push_back(entity);
+		prefab->Nodes.emplace_back().UUID = registry.get<UUIDComponent>(entity).UUID;
+	}
+
+	for (auto [entity, index] : nodes)
+	{
+		auto* relationship = registry.try_get<RelationshipComponent>(entity);
+		if (relationship && relationship->Parent != entt::null)
+			prefab->Nodes[index].Parent = nodes.at(relationship->Parent);
+	}
+
+	for (size_t i = 0; i < prefab->Nodes.size(); i++)
+	{
+		if (prefab->Nodes[i].Parent >= 0)
+			continue;
+
+		if (auto* transform = registry.try_get<TransformComponent>(nodeEntities[i]))
+			prefab->Origin = transform->GetTranslation();
+		break;
+	}
+
+	// same order as the binary scene, components constructed with their entity may look at the plain ones
+	std::vector<const std::pair<const std::string, ComponentRegistry::ComponentHandlers>*> types;
+	for (const auto& type : ComponentRegistry::Get().GetAllHandlers())
+	{
+		types.push_back(&type);
+	}
+	std::sort(types.begin(), types.end(), [](const auto* lhs, const auto* rhs)
+		{
+			if (lhs->second.BindsEntity != rhs->second.BindsEntity)
+				return !lhs->second.BindsEntity;
+			return lhs->first < rhs->first;
+		});
+
+	std::vector<entt::entity> entities;
+	std::vector<void*> components;
+	for (const auto* type : types)
+	{
+		const auto& handlers = type->second;
+
+		entities.clear();
+		components.clear();
+		handlers.GetAll(source, entities, components);
+
+		for (size_t i = 0; i < entities.size(); i++)
+		{
+			PrefabTemplate::Component component{ &handlers, components[i], json() };
+			if (handlers.CustomSerialized)
+				handlers.Serialize(component.Value, Entity(entities[i], &source));
+
+			prefab->Nodes[nodes.at(entities[i])].Components.push_back(std::move(component));
+		}
+	}
+
+	m_Template = std::move(prefab);
+	return *m_Template;
+}
+
+std::vector<Entity> Scene::Instantiate(PrefabAsset& prefab, uint32_t count, const std::vector<glm::vec3>& offsets)
+{
+	ZoneScoped;
+
+	const PrefabTemplate& prefabTemplate = prefab.GetTemplate();
+	const size_t nodeCount = prefabTemplate.Nodes.size();
+
+	std::vector<Entity> roots;
+	if (count == 0 || nodeCount == 0)
+		return roots;
+
+	// node major, the copies of node k are entities [k * count, (k + 1) * count)
+	std::vector<entt::entity> entities(nodeCount * count);
+	m_Registry.create(entities.begin(), entities.end());
+
+	std::vector<UUIDComponent> uuids(entities.size());
+	m_Registry.insert<UUIDComponent>(entities.begin(), entities.end(), uuids.begin());
+
+	struct PendingPost
+	{
+		const ComponentRegistry::ComponentHandlers* Handlers;
+		json Value;
+		entt::entity Entity;
+	};
+
+	std::vector<PendingPost> pendingPost;
+	std::vector<entt::entity> copies(count);
+	std::vector<void*> components;
+
+	// entity references inside the prefab have to point at the entities of the same copy
+	std::unordered_map<uint64_t, uint64_t> copyUUIDs;
+	auto MapCopyUUIDs = [&](uint32_t copy) -> const std::unordered_map<uint64_t, uint64_t>&
+		{
+			copyUUIDs.clear();
+			for (size_t node = 0; node < nodeCount; node++)
+				copyUUIDs[prefabTemplate.Nodes[node].UUID] = m_Registry.get<UUIDComponent>(entities[node * count + copy]).UUID;
+
+			return copyUUIDs;
+		};
+
+	auto InstanceComponents = [&](bool plain)
+		{
+			for (size_t node = 0; node < nodeCount; node++)
+			{
+				std::copy_n(entities.begin() + node * count, count, copies.begin());
+
+				for (const auto& component : prefabTemplate.Nodes[node].Components)
+				{
+					const auto& handlers = *component.Handlers;
+					bool insertable = handlers.InsertCopies && !handlers.CustomSerialized;
+					if (insertable != plain)
+						continue;
+
+					if (insertable)
+					{
+						// one batch insert per node and type, every copy starts from the template value
+						handlers.InsertCopies(*this, component.Data, copies);
+					}
+					else if (handlers.CustomSerialized)
+					{
+						for (uint32_t i = 0; i < count; i++)
+						{
+							json value = component.Value;
+							if (handlers.RemapEntities)
+								handlers.RemapEntities(value, MapCopyUUIDs(i));
+
+							handlers.Deserialize(value, Entity(copies[i], this));
+							pendingPost.push_back({ &handlers, std::move(value), copies[i] });
+						}
+					}
+					else
+					{
+						components.clear();
+						handlers.AddAll(*this, copies, components);
+						for (void* target : components)
+						{
+							CopyFields(component.Data, target, *handlers.Fields);
+							if (handlers.ApplyFields)
+								handlers.ApplyFields(target);
+						}
+					}
+				}
+			}
+		};
+
+	InstanceComponents(true);
+
+	// the copied relationships still carry the links of the source scene, each copy hangs below its own parent copy
+	for (size_t node = 0; node < nodeCount; node++)
+	{
+		int32_t parent = prefabTemplate.Nodes[node].Parent;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			entt::entity entity = entities[node * count + i];
+			if (auto* relationship = m_Registry.try_get<RelationshipComponent>(entity))
+			{
+				relationship->Parent = entt::null;
+				relationship->FirstChild = entt::null;
+				relationship->PrevSibling = entt::null;
+				relationship->NextSibling = entt::null;
+				relationship->ChildCount = 0;
+				relationship->Depth = 0;
+				relationship->ParentUUID = parent >= 0 ? m_Registry.get<UUIDComponent>(entities[parent * count + i]).UUID : 0;
+			}
+
+			if (parent < 0 && i < offsets.size())
+			{
+				if (auto* transform = m_Registry.try_get<TransformComponent>(entity))
+					transform->SetTranslation(transform->GetTranslation() + offsets[i]);
+			}
+		}
+	}
+
+	LinkHierarchy(entities);
+
+	InstanceComponents(false);
+
+	for (const auto& post : pendingPost)
+	{
+		post.Handlers->PostDeserialize(post.Value, Entity(post.Entity, this));
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		for (size_t node = 0; node < nodeCount; node++)
+		{
+			if (prefabTemplate.Nodes[node].Parent < 0)
+				roots.emplace_back(entities[node * count + i], this);
+		}
+	}
+
+	return roots;
+}
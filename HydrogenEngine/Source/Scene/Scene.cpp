@@ -4,6 +4,8 @@
 #include "Hydrogen/Scene/Animation.hpp"
 #include "Hydrogen/Scripting/ScriptEngine.hpp"
 #include "Hydrogen/Scene/Components.hpp"
+#include "Hydrogen/Scene/SystemScheduler.hpp"
+#include "Tracy/Tracy.hpp"
 
 #include <string>
 
@@ -38,17 +40,375 @@ uint64_t Entity::GetUUID() const
 
 void Entity::SetUUID(uint64_t uuid)
 {
-	GetComponent<UUIDComponent>().UUID = uuid;
+	auto& component = GetComponent<UUIDComponent>();
+	uint64_t oldUUID = component.UUID;
+	component.UUID = uuid;
+
+	m_Scene->RemapUUID(m_Entity, oldUUID, uuid);
 }
 
 void Entity::Delete()
 {
-	m_Scene->m_Registry.destroy(m_Entity);
+	m_Scene->DestroyEntity(m_Entity);
 }
 Scene::Scene()
 	: m_PhysicsWorld(PhysicsWorld(this, { 0.0f, -9.81f, 0.0f }))
 {
 	m_ScriptSystem = std::make_unique<ScriptSystem>(this);
+
+	// every path that adds or removes a UUIDComponent keeps the index current
+	m_Registry.on_construct<UUIDComponent>().connect<&Scene::OnUUIDConstruct>(this);
+	m_Registry.on_destroy<UUIDComponent>().connect<&Scene::OnUUIDDestroy>(this);
+
+	// slots of the world transform stream are reassigned whenever the set of transforms changes
+	m_Registry.on_construct<TransformComponent>().connect<&Scene::OnWorldLayoutChange>(this);
+	m_Registry.on_destroy<TransformComponent>().connect<&Scene::OnWorldLayoutChange>(this);
+	m_Registry.on_construct<RelationshipComponent>().connect<&Scene::OnWorldLayoutChange>(this);
+	m_Registry.on_destroy<RelationshipComponent>().connect<&Scene::OnWorldLayoutChange>(this);
+	m_Registry.on_construct<MeshRendererComponent>().connect<&Scene::OnWorldLayoutChange>(this);
+	m_Registry.on_destroy<MeshRendererComponent>().connect<&Scene::OnWorldLayoutChange>(this);
+
+	// the scheduler only overlaps systems that touch disjoint components
+	m_Systems = std::make_unique<SystemScheduler>();
+
+	// scripts move entities, drive animators and spawn prefabs, everything below touches one of these pools and waits for them
+	SystemAccess scriptAccess = SystemAccess().Write<ScriptsComponent, TransformComponent, RelationshipComponent, MeshRendererComponent,
+		AnimatorComponent, CameraComponent, RigidbodyComponent>();
+	scriptAccess.MainThread = true; // the lua state is not thread safe
+	m_Systems->AddSystem("Scripts", scriptAccess,
+		[this](float dt)
+		{
+			if (m_ScriptSystem)
+				m_ScriptSystem->OnUpdate(dt);
+
+			// spawned prefabs change the hierarchy, the pools are sorted here so the hierarchy pass only reads them
+			SortHierarchy();
+		});
+
+	m_Systems->AddSystem("Animation", SystemAccess().Write<AnimatorComponent, SkeletalMeshRendererComponent>(),
+		[this](float dt)
+		{
+			SystemScheduler::ParallelForEach<AnimatorComponent>(this, [dt](Entity, AnimatorComponent& animator)
+				{
+					animator.UpdateAnimation(dt);
+				});
+		});
+
+	m_Systems->AddSystem("Transform Hierarchy", SystemAccess().Write<TransformComponent>().Read<RelationshipComponent>(),
+		[this](float) { UpdateWorldTransforms(); });
+
+	// after the hierarchy, so children read the world matrices of their parents from this frame
+	m_Systems->AddSystem("Physics Sync", SystemAccess().Write<TransformComponent>().Read<RigidbodyComponent, RelationshipComponent>(),
+		[this](float) { m_PhysicsWorld.SyncTransforms(); });
+}
+
+Scene::~Scene() = default;
+
+void Scene::OnUUIDConstruct(entt::registry& registry, entt::entity entity)
+{
+	m_EntitiesByUUID[registry.get<UUIDComponent>(entity).UUID] = entity;
+}
+
+void Scene::OnUUIDDestroy(entt::registry& registry, entt::entity entity)
+{
+	auto it = m_EntitiesByUUID.find(registry.get<UUIDComponent>(entity).UUID);
+	if (it != m_EntitiesByUUID.end() && it->second == entity)
+	{
+		m_EntitiesByUUID.erase(it);
+	}
+}
+
+void Scene::RemapUUID(entt::entity entity, uint64_t oldUUID, uint64_t newUUID)
+{
+	auto it = m_EntitiesByUUID.find(oldUUID);
+	if (it != m_EntitiesByUUID.end() && it->second == entity)
+	{
+		m_EntitiesByUUID.erase(it);
+	}
+
+	m_EntitiesByUUID[newUUID] = entity;
+}
+
+void Scene::LinkChild(entt::entity child, entt::entity parent)
+{
+	auto& relationship = m_Registry.get<RelationshipComponent>(child);
+	auto& parentRelationship = m_Registry.get<RelationshipComponent>(parent);
+
+	relationship.Parent = parent;
+	relationship.PrevSibling = entt::null;
+	relationship.NextSibling = parentRelationship.FirstChild;
+
+	if (parentRelationship.FirstChild != entt::null)
+		m_Registry.get<RelationshipComponent>(parentRelationship.FirstChild).PrevSibling = child;
+
+	parentRelationship.FirstChild = child;
+	parentRelationship.ChildCount++;
+}
+
+void Scene::UnlinkChild(entt::entity child)
+{
+	auto& relationship = m_Registry.get<RelationshipComponent>(child);
+	if (relationship.Parent == entt::null)
+		return;
+
+	auto& parentRelationship = m_Registry.get<RelationshipComponent>(relationship.Parent);
+	if (parentRelationship.FirstChild == child)
+		parentRelationship.FirstChild = relationship.NextSibling;
+
+	if (relationship.PrevSibling != entt::null)
+		m_Registry.get<RelationshipComponent>(relationship.PrevSibling).NextSibling = relationship.NextSibling;
+
+	if (relationship.NextSibling != entt::null)
+		m_Registry.get<RelationshipComponent>(relationship.NextSibling).PrevSibling = relationship.PrevSibling;
+
+	parentRelationship.ChildCount--;
+
+	relationship.Parent = entt::null;
+	relationship.PrevSibling = entt::null;
+	relationship.NextSibling = entt::null;
+}
+
+void Scene::UpdateDepths(entt::entity root)
+{
+	std::vector<entt::entity> stack = { root };
+	while (!stack.empty())
+	{
+		entt::entity entity = stack.back();
+		stack.pop_back();
+
+		auto& relationship = m_Registry.get<RelationshipComponent>(entity);
+		relationship.Depth = relationship.Parent == entt::null ? 0 : m_Registry.get<RelationshipComponent>(relationship.Parent).Depth + 1;
+
+		for (entt::entity child = relationship.FirstChild; child != entt::null; child = m_Registry.get<RelationshipComponent>(child).NextSibling)
+			stack.push_back(child);
+	}
+
+	m_HierarchyOrderDirty = true;
+}
+
+void Scene::SetParent(Entity child, Entity parent)
+{
+	auto& relationship = child.GetComponent<RelationshipComponent>();
+
+	if (parent.IsValid())
+	{
+		for (entt::entity ancestor = parent.m_Entity; ancestor != entt::null; ancestor = m_Registry.get<RelationshipComponent>(ancestor).Parent)
+		{
+			if (ancestor == child.m_Entity)
+			{
+				HY_ENGINE_WARN("Cannot parent entity {} to one of its own descendants", child.GetUUID());
+				return;
+			}
+		}
+	}
+
+	UnlinkChild(child.m_Entity);
+	relationship.ParentUUID = 0;
+
+	if (parent.IsValid())
+	{
+		LinkChild(child.m_Entity, parent.m_Entity);
+		relationship.ParentUUID = parent.GetUUID();
+	}
+
+	UpdateDepths(child.m_Entity);
+
+	if (auto* transform = child.TryGetComponent<TransformComponent>())
+		transform->WorldDirty = true;
+}
+
+Entity Scene::GetParent(Entity entity)
+{
+	auto* relationship = entity.TryGetComponent<RelationshipComponent>();
+	if (!relationship || relationship->Parent == entt::null)
+		return Entity();
+
+	return Entity(relationship->Parent, this);
+}
+
+std::vector<Entity> Scene::GetChildren(Entity entity)
+{
+	std::vector<Entity> children;
+
+	auto* relationship = entity.TryGetComponent<RelationshipComponent>();
+	if (!relationship)
+		return children;
+
+	children.reserve(relationship->ChildCount);
+	for (entt::entity child = relationship->FirstChild; child != entt::null; child = m_Registry.get<RelationshipComponent>(child).NextSibling)
+		children.emplace_back(child, this);
+
+	return children;
+}
+
+void Scene::UpdateTransforms()
+{
+	SortHierarchy();
+	UpdateWorldTransforms();
+}
+
+void Scene::SortHierarchy()
+{
+	ZoneScoped;
+
+	if (m_HierarchyOrderDirty)
+	{
+		// parents are stored before their children, so a single pass in storage order always sees the parent first
+		m_Registry.sort<RelationshipComponent>([](const RelationshipComponent& lhs, const RelationshipComponent& rhs) { return lhs.Depth < rhs.Depth; });
+		m_Registry.sort<TransformComponent, RelationshipComponent>();
+		m_HierarchyOrderDirty = false;
+		m_WorldLayoutDirty = true;
+	}
+
+	// mesh renderers follow the slot order, which turns the renderer's reads of the stream into a forward walk
+	if (m_WorldLayoutDirty)
+		m_Registry.sort<MeshRendererComponent, TransformComponent>();
+}
+
+void Scene::UpdateWorldTransforms()
+{
+	ZoneScoped;
+
+	// the slots follow the pass order, so a layout change rewrites the whole stream and otherwise only moved entities are copied
+	bool relayout = m_WorldLayoutDirty;
+	if (relayout)
+	{
+		// an upper bound, trimmed once the pass counted the slots
+		size_t count = m_Registry.storage<TransformComponent>().size();
+		m_WorldTransforms.Matrices.resize(count);
+		m_WorldTransforms.Revisions.resize(count);
+		m_WorldTransforms.Entities.clear();
+		m_WorldTransforms.Entities.reserve(count);
+		m_WorldTransforms.Slots.assign(m_Registry.storage<entt::entity>().size(), INVALID_WORLD_SLOT);
+
+		m_WorldLayoutDirty = false;
+	}
+
+	uint32_t slot = 0;
+	auto view = m_Registry.view<RelationshipComponent>();
+	for (auto entity : view)
+	{
+		auto* transform = m_Registry.try_get<TransformComponent>(entity);
+		if (!transform)
+			continue;
+
+		const auto& relationship = view.get<RelationshipComponent>(entity);
+		const TransformComponent* parent = relationship.Parent != entt::null ? m_Registry.try_get<TransformComponent>(relationship.Parent) : nullptr;
+
+		transform->WorldChanged = transform->WorldDirty || (parent && parent->WorldChanged);
+		if (transform->WorldChanged)
+		{
+			transform->WorldCache = parent ? parent->WorldCache * transform->GetModel() : transform->GetModel();
+			transform->WorldDirty = false;
+			transform->Revision++;
+		}
+
+		if (relayout)
+		{
+			m_WorldTransforms.Entities.push_back(entity);
+			m_WorldTransforms.Slots[static_cast<uint32_t>(entt::to_entity(entity))] = slot;
+		}
+
+		if (relayout || transform->WorldChanged)
+		{
+			m_WorldTransforms.Matrices[slot] = transform->WorldCache;
+			m_WorldTransforms.Revisions[slot] = transform->Revision;
+		}
+
+		slot++;
+	}
+
+	// transforms of entities without a relationship get no slot
+	if (relayout)
+	{
+		m_WorldTransforms.Matrices.resize(slot);
+		m_WorldTransforms.Revisions.resize(slot);
+	}
+}
+
+void Scene::RebuildHierarchy()
+{
+	// scenes saved before the hierarchy existed may lack the component on some entities
+	for (auto entity : m_Registry.view<TransformComponent>(entt::exclude<RelationshipComponent>))
+		Entity(entity, this).AddComponent<RelationshipComponent>();
+
+	auto view = m_Registry.view<RelationshipComponent>();
+	for (auto entity : view)
+	{
+		auto& relationship = view.get<RelationshipComponent>(entity);
+		relationship.Parent = entt::null;
+		relationship.FirstChild = entt::null;
+		relationship.PrevSibling = entt::null;
+		relationship.NextSibling = entt::null;
+		relationship.ChildCount = 0;
+		relationship.Depth = 0;
+	}
+
+	LinkHierarchy(std::vector<entt::entity>(view.begin(), view.end()));
+}
+
+void Scene::LinkHierarchy(const std::vector<entt::entity>& entities)
+{
+	std::vector<uint8_t> linked(m_Registry.storage<entt::entity>().size(), 0);
+	for (auto entity : entities)
+		linked[static_cast<uint32_t>(entt::to_entity(entity))] = 1;
+
+	for (auto entity : entities)
+	{
+		auto* relationship = m_Registry.try_get<RelationshipComponent>(entity);
+		if (!relationship || relationship->ParentUUID == 0)
+			continue;
+
+		Entity parent = GetEntityByUUID(relationship->ParentUUID);
+		if (!parent.IsValid() || parent.m_Entity == entity || !parent.HasComponent<RelationshipComponent>())
+		{
+			HY_ENGINE_WARN("Entity {} references missing parent {}, making it a root", m_Registry.get<UUIDComponent>(entity).UUID, relationship->ParentUUID);
+			relationship->ParentUUID = 0;
+			continue;
+		}
+
+		LinkChild(entity, parent.m_Entity);
+	}
+
+	// depths flow down from the topmost entity of the set, which may hang below an entity that was already there
+	for (auto entity : entities)
+	{
+		auto* relationship = m_Registry.try_get<RelationshipComponent>(entity);
+		if (relationship && (relationship->Parent == entt::null || !linked[static_cast<uint32_t>(entt::to_entity(relationship->Parent))]))
+			UpdateDepths(entity);
+	}
+
+	for (auto entity : entities)
+	{
+		if (auto* transform = m_Registry.try_get<TransformComponent>(entity))
+			transform->WorldDirty = true;
+	}
+
+	m_HierarchyOrderDirty = true;
+}
+
+void Scene::DestroyEntity(entt::entity entity)
+{
+	// children are destroyed with their parent, collected up front as destroying them unlinks them from this entity
+	if (m_Registry.all_of<RelationshipComponent>(entity))
+	{
+		for (Entity child : GetChildren(Entity(entity, this)))
+			DestroyEntity(child.m_Entity);
+
+		UnlinkChild(entity);
+	}
+
+	// the body and its colliders belong to the physics world, not to the component
+	if (auto* rigidbody = m_Registry.try_get<RigidbodyComponent>(entity))
+	{
+		m_PhysicsWorld.DestroyRigidbody(rigidbody->Rigidbody);
+		rigidbody->Rigidbody = nullptr;
+	}
+
+	m_Registry.destroy(entity);
+
+	// removal swaps the last element into the hole, which breaks the depth order
+	m_HierarchyOrderDirty = true;
 }
 
 Entity Scene::GetEntityByEntityID(uint32_t id)
@@ -65,16 +425,11 @@ Entity Scene::GetEntityByEntityID(uint32_t id)
 
 Entity Scene::GetEntityByUUID(uint64_t uuid)
 {
-	Entity res;
-	IterateComponents([&res, uuid](Entity entity)
-		{
-			if (entity.GetUUID() == uuid)
-			{
-				res = entity;
-			}
-		});
+	auto it = m_EntitiesByUUID.find(uuid);
+	if (it == m_EntitiesByUUID.end())
+		return Entity();
 
-	return res;
+	return Entity(it->second, this);
 }
 
 void Scene::UpdatePhysics(float timestep)
@@ -96,14 +451,7 @@ void Scene::InitScripts()
 
 void Scene::Update(float dt)
 {
-	m_PhysicsWorld.SyncTransforms();
-	if (m_ScriptSystem)
-		m_ScriptSystem->OnUpdate(dt);
-
-	IterateComponents<AnimatorComponent>([dt](Entity e, AnimatorComponent& anim)
-		{
-			anim.UpdateAnimation(dt);
-		});
+	m_Systems->Run(dt);
 }
 
 static void SanitizeJsonFloats(json& j, float precision = 10000.0f)
@@ -188,14 +536,16 @@ void Scene::DeserializeScene(const json& j)
 				handlers.PostDeserialize(value[name], e);
 		}
 	}
+
+	RebuildHierarchy();
 }
 
-UUIDComponent::UUIDComponent(Entity)
+UUIDComponent::UUIDComponent()
 {
 	UUID = GenerateUUID();
 }
 
-UUIDComponent::UUIDComponent(Entity, uint64_t uuid)
+UUIDComponent::UUIDComponent(uint64_t uuid)
 {
 	UUID = uuid;
 }
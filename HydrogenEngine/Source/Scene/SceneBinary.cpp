@@ -0,0 +1,667 @@
+#include "Hydrogen/Scene/SceneBinary.hpp"
+#include "Hydrogen/Application.hpp"
+#include "Tracy/Tracy.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <unordered_set>
+
+using namespace Hydrogen;
+
+// layout, integers in the byte order of the writing machine:
+//   header    magic, version, entity count, string count, block count
+//   entities  uint64 uuid per entity, blocks refer to entities by their index in here
+//   strings   uint32 length and the bytes, holds names, tags, asset files and json blobs
+//   blocks    one per component type: name, kind, count and an entity index per component, followed
+//             for reflected types by the field schema and one packed column per field,
+//             for custom serialized types by one json string per component
+
+#define SCENE_BINARY_MAGIC 0x42535948 // "HYSB"
+#define SCENE_BINARY_VERSION 1
+#define SCENE_BINARY_NO_INDEX UINT32_MAX
+
+static uint32_t GetFieldSize(FieldType type)
+{
+	switch (type)
+	{
+	case FieldType::Float: return sizeof(float);
+	case FieldType::Int: return sizeof(int);
+	case FieldType::UInt64: return sizeof(uint64_t);
+	case FieldType::Bool: return sizeof(bool);
+	case FieldType::Vec2: return sizeof(glm::vec2);
+	case FieldType::Vec3: return sizeof(glm::vec3);
+	case FieldType::Vec4: return sizeof(glm::vec4);
+	case FieldType::Quaternion: return sizeof(glm::quat);
+	case FieldType::String: return sizeof(uint32_t); // string table index
+	case FieldType::Asset: return sizeof(uint32_t);
+	}
+
+	return 0;
+}
+
+class SceneBinaryWriter
+{
+public:
+	template<typename T>
+	void Write(const T& value)
+	{
+		WriteBytes(&value, sizeof(T));
+	}
+
+	void WriteBytes(const void* data, size_t size)
+	{
+		size_t offset = m_Data.size();
+		m_Data.resize(offset + size);
+		std::memcpy(m_Data.data() + offset, data, size);
+	}
+
+	uint32_t AddString(const std::string& string)
+	{
+		auto [it, inserted] = m_StringIndices.try_emplace(string, static_cast<uint32_t>(m_Strings.size()));
+		if (inserted)
+			m_Strings.push_back(&it->first);
+
+		return it->second;
+	}
+
+	std::vector<uint8_t>& GetData() { return m_Data; }
+	const std::vector<const std::string*>& GetStrings() const { return m_Strings; }
+
+private:
+	std::vector<uint8_t> m_Data;
+
+	std::unordered_map<std::string, uint32_t> m_StringIndices;
+	std::vector<const std::string*> m_Strings;
+};
+
+class SceneBinaryReader
+{
+public:
+	SceneBinaryReader(const uint8_t* data, size_t size)
+		: m_Data(data), m_Size(size)
+	{
+	}
+
+	template<typename T>
+	bool Read(T& value)
+	{
+		return ReadBytes(&value, sizeof(T));
+	}
+
+	bool ReadBytes(void* data, size_t size)
+	{
+		if (size > m_Size - m_Offset)
+			return false;
+
+		std::memcpy(data, m_Data + m_Offset, size);
+		m_Offset += size;
+		return true;
+	}
+
+	bool Skip(size_t size)
+	{
+		if (size > m_Size - m_Offset)
+			return false;
+
+		m_Offset += size;
+		return true;
+	}
+
+	size_t GetOffset() const { return m_Offset; }
+
+private:
+	const uint8_t* m_Data;
+	size_t m_Size;
+	size_t m_Offset = 0;
+};
+
+std::vector<uint8_t> Scene::SerializeSceneBinary()
+{
+	auto view = m_Registry.view<UUIDComponent>();
+	return SerializeSceneBinary(std::vector<entt::entity>(view.begin(), view.end()));
+}
+
+std::vector<uint8_t> Scene::SerializeSceneBinary(const std::vector<entt::entity>& entities)
+{
+	ZoneScoped;
+
+	std::vector<uint64_t> uuids;
+	uuids.reserve(entities.size());
+	std::vector<uint32_t> entityIndices(m_Registry.storage<entt::entity>().size(), SCENE_BINARY_NO_INDEX);
+	for (auto entity : entities)
+	{
+		// entities without a UUID cannot be referenced by the file
+		const auto* uuid = m_Registry.try_get<UUIDComponent>(entity);
+		if (!uuid)
+			continue;
+
+		entityIndices[static_cast<uint32_t>(entt::to_entity(entity))] = static_cast<uint32_t>(uuids.size());
+		uuids.push_back(uuid->UUID);
+	}
+
+	// components constructed with their entity may look at plain ones, so those come first
+	std::vector<const std::pair<const std::string, ComponentRegistry::ComponentHandlers>*> types;
+	for (const auto& type : ComponentRegistry::Get().GetAllHandlers())
+	{
+		types.push_back(&type);
+	}
+	std::sort(types.begin(), types.end(), [](const auto* lhs, const auto* rhs)
+		{
+			if (lhs->second.BindsEntity != rhs->second.BindsEntity)
+				return !lhs->second.BindsEntity;
+			return lhs->first < rhs->first;
+		});
+
+	SceneBinaryWriter blocks;
+	uint32_t blockCount = 0;
+
+	std::unordered_map<const Asset*, uint32_t> assetNames;
+	std::vector<entt::entity> typeEntities;
+	std::vector<void*> components;
+	for (const auto* type : types)
+	{
+		const auto& [name, handlers] = *type;
+
+		typeEntities.clear();
+		components.clear();
+		handlers.GetAll(*this, typeEntities, components);
+
+		size_t count = 0;
+		for (size_t i = 0; i < typeEntities.size(); i++)
+		{
+			if (entityIndices[static_cast<uint32_t>(entt::to_entity(typeEntities[i]))] == SCENE_BINARY_NO_INDEX)
+				continue;
+
+			typeEntities[count] = typeEntities[i];
+			components[count] = components[i];
+			count++;
+		}
+		typeEntities.resize(count);
+		components.resize(count);
+
+		if (count == 0)
+			continue;
+
+		blocks.Write(blocks.AddString(name));
+		blocks.Write(handlers.CustomSerialized ? SceneBlockKind::Json : SceneBlockKind::Fields);
+		blocks.Write(static_cast<uint32_t>(count));
+		for (auto entity : typeEntities)
+		{
+			blocks.Write(entityIndices[static_cast<uint32_t>(entt::to_entity(entity))]);
+		}
+		blockCount++;
+
+		if (handlers.CustomSerialized)
+		{
+			for (auto entity : typeEntities)
+			{
+				json componentJson;
+				handlers.Serialize(componentJson, Entity(entity, this));
+				blocks.Write(blocks.AddString(componentJson.dump()));
+			}
+			continue;
+		}
+
+		const auto& fields = *handlers.Fields;
+		blocks.Write(static_cast<uint32_t>(fields.size()));
+		for (const auto& field : fields)
+		{
+			blocks.Write(blocks.AddString(field.Name));
+			blocks.Write(static_cast<uint8_t>(field.Type));
+		}
+
+		for (const auto& field : fields)
+		{
+			for (void* component : components)
+			{
+				const char* fieldPtr = static_cast<const char*>(component) + field.Offset;
+
+				switch (field.Type)
+				{
+				case FieldType::String:
+					blocks.Write(blocks.AddString(*reinterpret_cast<const std::string*>(fieldPtr)));
+					break;
+
+				case FieldType::Asset:
+				{
+					const auto& asset = *reinterpret_cast<const std::shared_ptr<Asset>*>(fieldPtr);
+					if (!asset)
+					{
+						blocks.Write<uint32_t>(SCENE_BINARY_NO_INDEX);
+						break;
+					}
+
+					auto it = assetNames.find(asset.get());
+					if (it == assetNames.end())
+						it = assetNames.emplace(asset.get(), blocks.AddString(std::filesystem::path(asset->GetPath()).filename().string())).first;
+
+					blocks.Write(it->second);
+					break;
+				}
+
+				default:
+					blocks.WriteBytes(fieldPtr, GetFieldSize(field.Type));
+					break;
+				}
+			}
+		}
+	}
+
+	SceneBinaryWriter out;
+	out.Write<uint32_t>(SCENE_BINARY_MAGIC);
+	out.Write<uint32_t>(SCENE_BINARY_VERSION);
+	out.Write(static_cast<uint32_t>(uuids.size()));
+	out.Write(static_cast<uint32_t>(blocks.GetStrings().size()));
+	out.Write(blockCount);
+
+	out.WriteBytes(uuids.data(), uuids.size() * sizeof(uint64_t));
+
+	for (const std::string* string : blocks.GetStrings())
+	{
+		out.Write(static_cast<uint32_t>(string->size()));
+		out.WriteBytes(string->data(), string->size());
+	}
+
+	out.WriteBytes(blocks.GetData().data(), blocks.GetData().size());
+
+	return std::move(out.GetData());
+}
+
+bool Scene::DeserializeSceneBinary(const uint8_t* data, size_t size)
+{
+	ZoneScoped;
+
+	auto parsed = std::make_shared<SceneBinaryData>();
+	if (!parsed->Parse(std::vector<uint8_t>(data, data + size)))
+		return false;
+
+	SceneBinaryLoader loader(*this, std::move(parsed));
+	while (!loader.IsDone())
+	{
+		loader.Step(UINT32_MAX);
+	}
+
+	return true;
+}
+
+bool SceneBinaryData::Parse(std::vector<uint8_t> bytes)
+{
+	ZoneScoped;
+
+	m_Bytes = std::move(bytes);
+	m_UUIDs.clear();
+	m_Strings.clear();
+	m_Blocks.clear();
+
+	SceneBinaryReader in(m_Bytes.data(), m_Bytes.size());
+
+	uint32_t magic = 0, version = 0;
+	if (!in.Read(magic) || magic != SCENE_BINARY_MAGIC || !in.Read(version) || version != SCENE_BINARY_VERSION)
+	{
+		HY_ENGINE_ERROR("Not a binary scene or written by an unsupported version");
+		return false;
+	}
+
+	auto corrupt = []()
+		{
+			HY_ENGINE_ERROR("Binary scene is truncated or corrupt");
+			return false;
+		};
+
+	uint32_t entityCount = 0, stringCount = 0, blockCount = 0;
+	if (!in.Read(entityCount) || !in.Read(stringCount) || !in.Read(blockCount))
+		return corrupt();
+
+	m_UUIDs.resize(entityCount);
+	if (!in.ReadBytes(m_UUIDs.data(), m_UUIDs.size() * sizeof(uint64_t)))
+		return corrupt();
+
+	m_Strings.resize(stringCount);
+	for (auto& string : m_Strings)
+	{
+		uint32_t length = 0;
+		if (!in.Read(length))
+			return corrupt();
+
+		string.resize(length);
+		if (!in.ReadBytes(string.data(), length))
+			return corrupt();
+	}
+
+	// every index is checked here, so the loader can take them as they are
+	auto checkIndices = [&](size_t offset, uint32_t count, uint32_t limit, bool allowNone)
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+				uint32_t index = ReadIndex(offset, i);
+				if (index >= limit && !(allowNone && index == SCENE_BINARY_NO_INDEX))
+					return false;
+			}
+			return true;
+		};
+
+	// an entity listed twice in a block would have the component added twice, which the registry asserts on
+	std::vector<uint32_t> listedInBlock(entityCount, 0);
+	auto checkUnique = [&](size_t offset, uint32_t count, uint32_t blockNumber)
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+				uint32_t index = ReadIndex(offset, i);
+				if (listedInBlock[index] == blockNumber)
+					return false;
+				listedInBlock[index] = blockNumber;
+			}
+			return true;
+		};
+
+	// for the same reason every type has a single block
+	std::unordered_set<std::string_view> blockNames;
+
+	m_Blocks.resize(blockCount);
+	uint32_t blockNumber = 0;
+	for (auto& block : m_Blocks)
+	{
+		blockNumber++;
+
+		if (!in.Read(block.Name) || !in.Read(block.Kind) || !in.Read(block.Count) || block.Name >= stringCount)
+			return corrupt();
+
+		if (block.Kind != SceneBlockKind::Fields && block.Kind != SceneBlockKind::Json)
+			return corrupt();
+
+		if (!blockNames.insert(m_Strings[block.Name]).second)
+			return corrupt();
+
+		block.IndicesOffset = in.GetOffset();
+		if (!in.Skip((size_t)block.Count * sizeof(uint32_t)) || !checkIndices(block.IndicesOffset, block.Count, entityCount, false)
+			|| !checkUnique(block.IndicesOffset, block.Count, blockNumber))
+			return corrupt();
+
+		if (block.Kind == SceneBlockKind::Json)
+		{
+			block.JsonOffset = in.GetOffset();
+			if (!in.Skip((size_t)block.Count * sizeof(uint32_t)) || !checkIndices(block.JsonOffset, block.Count, stringCount, false))
+				return corrupt();
+			continue;
+		}
+
+		uint32_t columnCount = 0;
+		if (!in.Read(columnCount))
+			return corrupt();
+
+		block.Columns.resize(columnCount);
+		for (auto& column : block.Columns)
+		{
+			uint8_t type = 0;
+			if (!in.Read(column.Name) || !in.Read(type) || column.Name >= stringCount || GetFieldSize((FieldType)type) == 0)
+				return corrupt();
+
+			column.Type = (FieldType)type;
+		}
+
+		for (auto& column : block.Columns)
+		{
+			column.Offset = in.GetOffset();
+			if (!in.Skip((size_t)GetFieldSize(column.Type) * block.Count))
+				return corrupt();
+
+			if ((column.Type == FieldType::String || column.Type == FieldType::Asset) && !checkIndices(column.Offset, block.Count, stringCount, true))
+				return corrupt();
+		}
+	}
+
+	return true;
+}
+
+uint32_t SceneBinaryData::ReadIndex(size_t offset, uint32_t i) const
+{
+	uint32_t index;
+	std::memcpy(&index, m_Bytes.data() + offset + (size_t)i * sizeof(uint32_t), sizeof(uint32_t));
+	return index;
+}
+
+std::vector<std::string> SceneBinaryData::GetAssetNames() const
+{
+	std::vector<uint8_t> used(m_Strings.size(), 0);
+	for (const auto& block : m_Blocks)
+	{
+		for (const auto& column : block.Columns)
+		{
+			if (column.Type != FieldType::Asset)
+				continue;
+
+			for (uint32_t i = 0; i < block.Count; i++)
+			{
+				uint32_t index = ReadIndex(column.Offset, i);
+				if (index != SCENE_BINARY_NO_INDEX)
+					used[index] = 1;
+			}
+		}
+	}
+
+	std::vector<std::string> names;
+	for (size_t i = 0; i < used.size(); i++)
+	{
+		if (used[i])
+			names.push_back(m_Strings[i]);
+	}
+
+	return names;
+}
+
+SceneBinaryLoader::SceneBinaryLoader(Scene& scene, std::shared_ptr<const SceneBinaryData> data)
+	: m_Scene(scene), m_Data(std::move(data))
+{
+	const auto& allHandlers = ComponentRegistry::Get().GetAllHandlers();
+
+	m_Handlers.resize(m_Data->m_Blocks.size(), nullptr);
+	m_Targets.resize(m_Data->m_Blocks.size());
+	for (size_t i = 0; i < m_Data->m_Blocks.size(); i++)
+	{
+		const auto& block = m_Data->m_Blocks[i];
+		const std::string& name = m_Data->m_Strings[block.Name];
+
+		auto it = allHandlers.find(name);
+		if (it == allHandlers.end())
+		{
+			HY_ENGINE_WARN("Skipping unknown component '{}' in binary scene", name);
+			continue;
+		}
+		m_Handlers[i] = &it->second;
+
+		// fields are matched by name, so files stay readable after members were added, removed or reordered
+		for (const auto& column : block.Columns)
+		{
+			const FieldInfo* target = nullptr;
+			for (const auto& field : *it->second.Fields)
+			{
+				if (field.Name == m_Data->m_Strings[column.Name] && field.Type == column.Type)
+				{
+					target = &field;
+					break;
+				}
+			}
+			m_Targets[i].push_back(target);
+		}
+	}
+
+	m_Assets.resize(m_Data->m_Strings.size());
+	m_AssetResolved.resize(m_Data->m_Strings.size(), 0);
+}
+
+uint32_t SceneBinaryLoader::Step(uint32_t budget)
+{
+	ZoneScoped;
+
+	auto& registry = m_Scene.GetRegistry();
+	const auto& blocks = m_Data->m_Blocks;
+
+	budget = std::max(budget, 1u);
+	uint32_t done = 0;
+	while (m_Stage != Stage::Done && done < budget)
+	{
+		switch (m_Stage)
+		{
+		case Stage::Entities:
+		{
+			std::vector<UUIDComponent> uuids;
+			uuids.reserve(m_Data->m_UUIDs.size());
+			for (uint64_t uuid : m_Data->m_UUIDs)
+			{
+				uuids.emplace_back(uuid);
+			}
+
+			m_Entities.resize(uuids.size());
+			registry.create(m_Entities.begin(), m_Entities.end());
+			registry.insert<UUIDComponent>(m_Entities.begin(), m_Entities.end(), uuids.begin());
+
+			done += static_cast<uint32_t>(m_Entities.size());
+			m_Stage = Stage::Components;
+			break;
+		}
+
+		case Stage::Components:
+		{
+			if (m_Block == blocks.size())
+			{
+				m_Stage = Stage::Hierarchy;
+				break;
+			}
+
+			const auto& block = blocks[m_Block];
+			uint32_t count = std::min(block.Count - static_cast<uint32_t>(m_Next), budget - done);
+			done += LoadComponents(block, m_Block, static_cast<uint32_t>(m_Next), count);
+
+			m_Next += count;
+			if (m_Next == block.Count)
+			{
+				m_Block++;
+				m_Next = 0;
+			}
+			break;
+		}
+
+		case Stage::Hierarchy:
+		{
+			m_Scene.LinkHierarchy(m_Entities);
+
+			// bodies and colliders are made by the next physics step, once the world matrices of the new entities exist
+			m_Scene.GetPhysicsWorld().RequestPendingBodies();
+
+			done += static_cast<uint32_t>(m_Entities.size());
+			m_Stage = Stage::Scripts;
+			break;
+		}
+
+		case Stage::Scripts:
+		{
+			// script instances are created by the script system on the update after their container appeared
+			for (; m_Next < m_PendingPost.size() && done < budget; m_Next++, done++)
+			{
+				const auto& post = m_PendingPost[m_Next];
+				if (registry.valid(post.Entity))
+					post.Handlers->PostDeserialize(post.Value, Entity(post.Entity, &m_Scene));
+			}
+
+			if (m_Next == m_PendingPost.size())
+			{
+				m_PendingPost.clear();
+				m_Next = 0;
+				m_Stage = Stage::Done;
+			}
+			break;
+		}
+
+		case Stage::Done:
+			break;
+		}
+	}
+
+	return std::max(done, 1u);
+}
+
+uint32_t SceneBinaryLoader::LoadComponents(const SceneBinaryData::Block& block, uint32_t blockIndex, uint32_t begin, uint32_t count)
+{
+	const auto* handlers = m_Handlers[blockIndex];
+	if (!handlers || count == 0)
+		return count;
+
+	std::vector<entt::entity> entities(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		entities[i] = m_Entities[m_Data->ReadIndex(block.IndicesOffset, begin + i)];
+	}
+
+	if (block.Kind == SceneBlockKind::Json)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			json componentJson = json::parse(m_Data->m_Strings[m_Data->ReadIndex(block.JsonOffset, begin + i)]);
+			handlers->Deserialize(componentJson, Entity(entities[i], &m_Scene));
+			m_PendingPost.push_back({ handlers, entities[i], std::move(componentJson) });
+		}
+		return count;
+	}
+
+	std::vector<void*> components;
+	handlers->AddAll(m_Scene, entities, components);
+
+	const auto& targets = m_Targets[blockIndex];
+	for (size_t c = 0; c < block.Columns.size(); c++)
+	{
+		const FieldInfo* target = targets[c];
+		if (!target)
+			continue;
+
+		const auto& column = block.Columns[c];
+		uint32_t fieldSize = GetFieldSize(column.Type);
+		const uint8_t* values = m_Data->m_Bytes.data() + column.Offset + (size_t)begin * fieldSize;
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			char* fieldPtr = static_cast<char*>(components[i]) + target->Offset;
+
+			switch (column.Type)
+			{
+			case FieldType::String:
+			{
+				uint32_t index = m_Data->ReadIndex(column.Offset, begin + i);
+				*reinterpret_cast<std::string*>(fieldPtr) = index != SCENE_BINARY_NO_INDEX ? m_Data->m_Strings[index] : "";
+				break;
+			}
+
+			case FieldType::Asset:
+			{
+				uint32_t index = m_Data->ReadIndex(column.Offset, begin + i);
+				*reinterpret_cast<std::shared_ptr<Asset>*>(fieldPtr) = index != SCENE_BINARY_NO_INDEX ? ResolveAsset(index) : nullptr;
+				break;
+			}
+
+			default:
+				std::memcpy(fieldPtr, values + (size_t)i * fieldSize, fieldSize);
+				break;
+			}
+		}
+	}
+
+	if (handlers->ApplyFields)
+	{
+		for (void* component : components)
+			handlers->ApplyFields(component);
+	}
+
+	return count;
+}
+
+std::shared_ptr<Asset> SceneBinaryLoader::ResolveAsset(uint32_t stringIndex)
+{
+	if (!m_AssetResolved[stringIndex])
+	{
+		m_Assets[stringIndex] = Application::Get()->MainAssetManager.TryGetAsset(m_Data->m_Strings[stringIndex]);
+		m_AssetResolved[stringIndex] = 1;
+	}
+
+	return m_Assets[stringIndex];
+}
@@ -0,0 +1,217 @@
+#include "Hydrogen/Scene/Scene.hpp"
+#include "Hydrogen/Scene/Components.hpp"
+#include "Hydrogen/Scene/Camera.hpp"
+#include "Hydrogen/Scene/Animation.hpp"
+#include "Tracy/Tracy.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Hydrogen;
+
+// components copied through entt's snapshot, the physics handles in them are cleared in the clone
+using SnapshotComponents = entt::type_list<
+	UUIDComponent, TagComponent, RelationshipComponent, TransformComponent,
+	MeshRendererComponent, DirectionalLightComponent, PointLightComponent, CameraComponent,
+	SkeletalMeshRendererComponent, RigidbodyComponent, ColliderComponent>;
+
+// these hold an entity back reference or lua state and go through their registered serializers instead
+static const char* s_SerializedComponents[] = { "AnimatorComponent", "ScriptsComponent" };
+
+template<typename... Ts>
+static bool IsSnapshotted(entt::type_list<Ts...>, entt::id_type type)
+{
+	return ((entt::type_hash<Ts>::value() == type) || ...);
+}
+
+// a registered component in neither list would silently vanish from play mode clones
+static bool CheckSnapshotCoverage()
+{
+	bool covered = true;
+	for (const auto& [name, handlers] : ComponentRegistry::Get().GetAllHandlers())
+	{
+		bool serialized = std::find_if(std::begin(s_SerializedComponents), std::end(s_SerializedComponents),
+			[&name](const char* other) { return name == other; }) != std::end(s_SerializedComponents);
+
+		if (!serialized && !IsSnapshotted(SnapshotComponents{}, handlers.Type))
+		{
+			HY_ENGINE_ERROR("Component '{}' is registered but not copied by Scene::Clone", name);
+			covered = false;
+		}
+	}
+
+	return covered;
+}
+
+// trivially copyable components are stored as raw bytes, the rest as typed copies in a pool per type
+struct SceneSnapshotData
+{
+	struct PoolBase
+	{
+		virtual ~PoolBase() = default;
+	};
+
+	template<typename T>
+	struct Pool : PoolBase
+	{
+		std::vector<T> Items;
+		size_t Next = 0;
+	};
+
+	std::vector<uint8_t> Bytes;
+	size_t ReadOffset = 0;
+
+	std::unordered_map<entt::id_type, std::unique_ptr<PoolBase>> Pools;
+
+	template<typename T>
+	Pool<T>& GetPool()
+	{
+		auto& pool = Pools[entt::type_hash<T>::value()];
+		if (!pool)
+			pool = std::make_unique<Pool<T>>();
+
+		return static_cast<Pool<T>&>(*pool);
+	}
+};
+
+class SnapshotWriter
+{
+public:
+	SnapshotWriter(SceneSnapshotData& data)
+		: m_Data(data)
+	{
+	}
+
+	void operator()(std::underlying_type_t<entt::entity> value) { Write(&value, sizeof(value)); }
+	void operator()(entt::entity entity) { Write(&entity, sizeof(entity)); }
+
+	template<typename T>
+	void operator()(const T& component)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+			Write(&component, sizeof(T));
+		else
+			m_Data.GetPool<T>().Items.push_back(component);
+	}
+
+private:
+	void Write(const void* data, size_t size)
+	{
+		size_t offset = m_Data.Bytes.size();
+		m_Data.Bytes.resize(offset + size);
+		std::memcpy(m_Data.Bytes.data() + offset, data, size);
+	}
+
+	SceneSnapshotData& m_Data;
+};
+
+class SnapshotReader
+{
+public:
+	SnapshotReader(SceneSnapshotData& data)
+		: m_Data(data)
+	{
+	}
+
+	void operator()(std::underlying_type_t<entt::entity>& value) { Read(&value, sizeof(value)); }
+	void operator()(entt::entity& entity) { Read(&entity, sizeof(entity)); }
+
+	template<typename T>
+	void operator()(T& component)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			Read(&component, sizeof(T));
+		}
+		else
+		{
+			auto& pool = m_Data.GetPool<T>();
+			component = std::move(pool.Items[pool.Next++]);
+		}
+	}
+
+private:
+	void Read(void* data, size_t size)
+	{
+		HY_ASSERT(m_Data.ReadOffset + size <= m_Data.Bytes.size(), "Scene snapshot read past its end");
+
+		std::memcpy(data, m_Data.Bytes.data() + m_Data.ReadOffset, size);
+		m_Data.ReadOffset += size;
+	}
+
+	SceneSnapshotData& m_Data;
+};
+
+template<typename... Ts, typename Snapshot, typename Archive>
+static void SnapshotAll(entt::type_list<Ts...>, Snapshot& snapshot, Archive& archive)
+{
+	(snapshot.template get<Ts>(archive), ...);
+}
+
+void Scene::Clone(Scene& clone)
+{
+	ZoneScoped;
+	HY_ASSERT(clone.m_Registry.storage<entt::entity>().empty(), "Scenes can only be cloned into an empty scene");
+
+	static const bool s_Covered = CheckSnapshotCoverage();
+	HY_ASSERT(s_Covered, "Every registered component has to be listed in SceneSnapshot.cpp");
+
+	SceneSnapshotData data;
+	{
+		ZoneScopedN("Write Snapshot");
+
+		SnapshotWriter writer(data);
+		auto snapshot = entt::snapshot{ m_Registry };
+		snapshot.get<entt::entity>(writer);
+		SnapshotAll(SnapshotComponents{}, snapshot, writer);
+	}
+
+	// entity identifiers are kept, so the runtime hierarchy links and the UUID index stay valid in the clone
+	{
+		ZoneScopedN("Load Snapshot");
+
+		SnapshotReader reader(data);
+		auto loader = entt::snapshot_loader{ clone.m_Registry };
+		loader.get<entt::entity>(reader);
+		SnapshotAll(SnapshotComponents{}, loader, reader);
+	}
+
+	// the bodies belong to this scene's physics world, the clone creates its own before its first step
+	for (auto [entity, rigidbody] : clone.m_Registry.view<RigidbodyComponent>().each())
+	{
+		rigidbody.Rigidbody = nullptr;
+	}
+	for (auto [entity, collider] : clone.m_Registry.view<ColliderComponent>().each())
+	{
+		collider.Rigidbody = nullptr;
+		collider.Collider = nullptr;
+	}
+	clone.m_PhysicsWorld.RequestPendingBodies();
+
+	// script instances are not copied, the clone creates them on its first update
+	const auto& handlers = ComponentRegistry::Get().GetAllHandlers();
+	for (const char* name : s_SerializedComponents)
+	{
+		auto it = handlers.find(name);
+		if (it == handlers.end())
+			continue;
+
+		std::vector<std::pair<entt::entity, json>> serialized;
+		for (auto entity : m_Registry.view<entt::entity>())
+		{
+			json componentJson;
+			it->second.Serialize(componentJson, Entity(entity, this));
+			if (!componentJson.empty())
+				serialized.emplace_back(entity, std::move(componentJson));
+		}
+
+		for (const auto& [entity, componentJson] : serialized)
+		{
+			it->second.Deserialize(componentJson, Entity(entity, &clone));
+		}
+		for (const auto& [entity, componentJson] : serialized)
+		{
+			it->second.PostDeserialize(componentJson, Entity(entity, &clone));
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#include "Hydrogen/Scene/SystemScheduler.hpp"
+#include "Hydrogen/JobSystem.hpp"
+#include "Tracy/Tracy.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace Hydrogen;
+
+bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+{
+	if (Exclusive || other.Exclusive)
+	{
+		return true;
+	}
+
+	auto overlaps = [](const std::vector<entt::id_type>& a, const std::vector<entt::id_type>& b)
+		{
+			for (entt::id_type id : a)
+			{
+				if (std::find(b.begin(), b.end(), id) != b.end())
+					return true;
+			}
+			return false;
+		};
+
+	return overlaps(Writes, other.Writes) || overlaps(Writes, other.Reads) || overlaps(Reads, other.Writes);
+}
+
+void SystemScheduler::AddSystem(std::string name, SystemAccess access, SystemFunc func)
+{
+	uint32_t index = static_cast<uint32_t>(m_Systems.size());
+
+	System system;
+	system.Name = std::move(name);
+	system.Access = std::move(access);
+	system.Func = std::move(func);
+
+	for (uint32_t i = 0; i < index; i++)
+	{
+		if (m_Systems[i].Access.ConflictsWith(system.Access))
+		{
+			m_Systems[i].Dependents.push_back(index);
+			system.DependencyCount++;
+		}
+	}
+
+	m_Systems.push_back(std::move(system));
+}
+
+void SystemScheduler::Run(float dt)
+{
+	ZoneScoped;
+
+	if (m_Systems.empty())
+	{
+		return;
+	}
+
+	JobSystem& jobs = JobSystem::Get();
+
+	std::vector<std::atomic<uint32_t>> remainingDependencies(m_Systems.size());
+	for (size_t i = 0; i < m_Systems.size(); i++)
+	{
+		remainingDependencies[i] = m_Systems[i].DependencyCount;
+	}
+
+	JobCounter finished;
+
+	// dependents are queued from inside the finishing job, so the counter cannot reach zero in between
+	std::function<void(uint32_t)> schedule = [&](uint32_t index)
+		{
+			JobAffinity affinity = m_Systems[index].Access.MainThread ? JobAffinity::MainThread : JobAffinity::Any;
+
+			jobs.Submit([&, index]()
+				{
+					const System& system = m_Systems[index];
+					{
+						ZoneScoped;
+						ZoneName(system.Name.c_str(), system.Name.size());
+
+						system.Func(dt);
+					}
+
+					for (uint32_t dependent : system.Dependents)
+					{
+						if (--remainingDependencies[dependent] == 0)
+							schedule(dependent);
+					}
+				}, &finished, affinity);
+		};
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(m_Systems.size()); i++)
+	{
+		if (m_Systems[i].DependencyCount == 0)
+			schedule(i);
+	}
+
+	// main thread systems run in here as well
+	jobs.Wait(finished);
+}
@@ -0,0 +1,436 @@
+#include "Hydrogen/Scene/WorldPartition.hpp"
+#include "Hydrogen/Scene/Camera.hpp"
+#include "Hydrogen/Application.hpp"
+#include "Tracy/Tracy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+
+using namespace Hydrogen;
+
+static uint64_t GetCellKey(WorldCellCoord coord)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(coord.X)) << 32) | static_cast<uint32_t>(coord.Z);
+}
+
+static bool ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& outBytes)
+{
+	std::ifstream fin(path, std::ios::binary | std::ios::ate);
+	if (!fin)
+		return false;
+
+	std::streamsize size = fin.tellg();
+	fin.seekg(0, std::ios::beg);
+
+	outBytes.resize(static_cast<size_t>(size));
+	return static_cast<bool>(fin.read(reinterpret_cast<char*>(outBytes.data()), size));
+}
+
+static bool WriteFile(const std::filesystem::path& path, const std::vector<uint8_t>& bytes)
+{
+	std::ofstream fout(path, std::ios::binary);
+	if (!fout)
+	{
+		HY_ENGINE_ERROR("Failed to write world cell '{}'", path.string());
+		return false;
+	}
+
+	fout.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+	return true;
+}
+
+// creates the GPU side of an asset, which would otherwise happen on the frame that first draws it
+static void MakeResident(const std::shared_ptr<Asset>& asset, RenderDevice* device)
+{
+	if (auto mesh = std::dynamic_pointer_cast<StaticMeshAsset>(asset))
+	{
+		mesh->GetVertexBuffer();
+		mesh->GetIndexBuffer();
+	}
+	else if (auto skinnedMesh = std::dynamic_pointer_cast<SkeletalMeshAsset>(asset))
+	{
+		skinnedMesh->GetVertexBuffer();
+		skinnedMesh->GetIndexBuffer();
+	}
+	else if (auto material = std::dynamic_pointer_cast<MaterialAsset>(asset))
+	{
+		for (const auto& texture : { material->GetAlbedoMap(), material->GetNormalMap(), material->GetORMMap(), material->GetEmissiveMap() })
+		{
+			if (texture)
+				texture->GetTexture(device);
+		}
+	}
+	else if (auto texture = std::dynamic_pointer_cast<TextureAsset>(asset))
+	{
+		texture->GetTexture(device);
+	}
+}
+
+static void CollectHierarchy(entt::registry& registry, entt::entity root, std::vector<entt::entity>& outEntities)
+{
+	std::vector<entt::entity> stack = { root };
+	while (!stack.empty())
+	{
+		entt::entity entity = stack.back();
+		stack.pop_back();
+		outEntities.push_back(entity);
+
+		for (entt::entity child = registry.get<RelationshipComponent>(entity).FirstChild; child != entt::null; child = registry.get<RelationshipComponent>(child).NextSibling)
+			stack.push_back(child);
+	}
+}
+
+WorldPartition::WorldPartition(Scene& scene, const std::string& manifestPath, WorldPartitionSettings settings)
+	: m_Scene(scene), m_Settings(settings), m_Directory(std::filesystem::path(manifestPath).parent_path())
+{
+	ZoneScoped;
+
+	std::ifstream fin(manifestPath);
+	json manifest = fin ? json::parse(fin, nullptr, false) : json();
+	if (!manifest.is_object())
+	{
+		HY_ENGINE_ERROR("Failed to read world manifest '{}'", manifestPath);
+		return;
+	}
+
+	m_CellSize = manifest.value("CellSize", 64.0f);
+
+	for (const auto& cellJson : manifest.value("Cells", json::array()))
+	{
+		auto cell = std::make_unique<Cell>();
+		cell->Coord = { cellJson.value("X", 0), cellJson.value("Z", 0) };
+		cell->File = cellJson.value("File", "");
+		cell->AssetNames = cellJson.value("Assets", std::vector<std::string>());
+
+		m_CellsByCoord[GetCellKey(cell->Coord)] = cell.get();
+		m_Cells.push_back(std::move(cell));
+	}
+
+	// the persistent cell comes in at once, it holds what has to be there from the first frame
+	std::string persistent = manifest.value("Persistent", "");
+	if (!persistent.empty())
+	{
+		std::vector<uint8_t> bytes;
+		if (!ReadFile(m_Directory / persistent, bytes) || !m_Scene.DeserializeSceneBinary(bytes.data(), bytes.size()))
+			HY_ENGINE_ERROR("Failed to load persistent world cell '{}'", persistent);
+	}
+
+	HY_ENGINE_INFO("World '{}' has {} cells of {} units", manifestPath, m_Cells.size(), m_CellSize);
+}
+
+WorldPartition::~WorldPartition()
+{
+	// read jobs write into their cell, entities of loaded cells stay in the scene
+	for (auto& cell : m_Cells)
+	{
+		if (cell->ReadCounter)
+			JobSystem::Get().Wait(*cell->ReadCounter);
+	}
+}
+
+bool WorldPartition::Build(Scene& source, const std::string& manifestPath, float cellSize)
+{
+	ZoneScoped;
+	HY_ASSERT(cellSize > 0.0f, "World cells need a positive size");
+
+	source.UpdateTransforms();
+
+	std::filesystem::path manifestFile(manifestPath);
+	std::filesystem::path directory = manifestFile.parent_path();
+	std::string stem = manifestFile.stem().string();
+
+	auto& registry = source.GetRegistry();
+
+	// whole hierarchies go to the cell of their root, so a parent is always streamed with its children
+	std::vector<entt::entity> persistent;
+	std::map<std::pair<int32_t, int32_t>, std::vector<entt::entity>> cells;
+	for (auto [entity, relationship] : registry.view<RelationshipComponent>().each())
+	{
+		if (relationship.Parent != entt::null)
+			continue;
+
+		const auto* transform = registry.try_get<TransformComponent>(entity);
+		if (!transform || registry.any_of<CameraComponent, DirectionalLightComponent>(entity))
+		{
+			CollectHierarchy(registry, entity, persistent);
+			continue;
+		}
+
+		glm::vec3 position = transform->GetWorldPosition();
+		std::pair<int32_t, int32_t> coord = { (int32_t)std::floor(position.x / cellSize), (int32_t)std::floor(position.z / cellSize) };
+		CollectHierarchy(registry, entity, cells[coord]);
+	}
+
+	for (auto entity : registry.view<UUIDComponent>(entt::exclude<RelationshipComponent>))
+	{
+		persistent.push_back(entity);
+	}
+
+	json manifest;
+	manifest["CellSize"] = cellSize;
+	manifest["Cells"] = json::array();
+
+	if (!persistent.empty())
+	{
+		std::string file = stem + ".persistent.hycell";
+		if (!WriteFile(directory / file, source.SerializeSceneBinary(persistent)))
+			return false;
+
+		manifest["Persistent"] = file;
+	}
+
+	for (const auto& [coord, entities] : cells)
+	{
+		std::string file = stem + "." + std::to_string(coord.first) + "_" + std::to_string(coord.second) + ".hycell";
+
+		std::vector<uint8_t> bytes = source.SerializeSceneBinary(entities);
+		if (!WriteFile(directory / file, bytes))
+			return false;
+
+		SceneBinaryData data;
+		data.Parse(std::move(bytes));
+
+		json cellJson;
+		cellJson["X"] = coord.first;
+		cellJson["Z"] = coord.second;
+		cellJson["File"] = file;
+		cellJson["Assets"] = data.GetAssetNames();
+		manifest["Cells"].push_back(cellJson);
+	}
+
+	std::ofstream fout(manifestPath);
+	fout << manifest.dump(4);
+	fout.close();
+
+	HY_ENGINE_INFO("Split the scene into {} cells and {} persistent entities", cells.size(), persistent.size());
+	return true;
+}
+
+WorldCellCoord WorldPartition::GetCell(glm::vec3 position) const
+{
+	return { (int32_t)std::floor(position.x / m_CellSize), (int32_t)std::floor(position.z / m_CellSize) };
+}
+
+WorldCellState WorldPartition::GetCellState(WorldCellCoord coord) const
+{
+	auto it = m_CellsByCoord.find(GetCellKey(coord));
+	return it != m_CellsByCoord.end() ? it->second->State : WorldCellState::Unloaded;
+}
+
+uint32_t WorldPartition::GetActiveCellCount() const
+{
+	return static_cast<uint32_t>(std::count_if(m_Cells.begin(), m_Cells.end(), [](const auto& cell) { return cell->State == WorldCellState::Active; }));
+}
+
+void WorldPartition::Update(glm::vec3 focus)
+{
+	ZoneScoped;
+
+	std::vector<Cell*> cells;
+	cells.reserve(m_Cells.size());
+
+	uint32_t pendingReads = 0;
+	for (auto& cell : m_Cells)
+	{
+		glm::vec2 center = (glm::vec2((float)cell->Coord.X, (float)cell->Coord.Z) + 0.5f) * m_CellSize;
+		cell->Distance = glm::length(center - glm::vec2(focus.x, focus.z)) / m_CellSize;
+
+		if (cell->Distance <= m_Settings.LoadRadius)
+			cell->Wanted = true;
+		else if (cell->Distance > m_Settings.UnloadRadius)
+			cell->Wanted = false;
+
+		if (cell->State == WorldCellState::Reading)
+			pendingReads++;
+
+		cells.push_back(cell.get());
+	}
+
+	// the nearest cells get the reads and the budgets first
+	std::sort(cells.begin(), cells.end(), [](const Cell* lhs, const Cell* rhs) { return lhs->Distance < rhs->Distance; });
+
+	uint32_t activationBudget = m_Settings.ActivationBudget;
+	uint32_t preloadBudget = m_Settings.PreloadBudget;
+
+	for (Cell* cell : cells)
+	{
+		switch (cell->State)
+		{
+		case WorldCellState::Unloaded:
+		{
+			if (cell->Wanted && pendingReads < m_Settings.MaxPendingReads)
+			{
+				StartRead(*cell);
+				pendingReads++;
+			}
+			break;
+		}
+
+		case WorldCellState::Reading:
+		{
+			if (!cell->ReadCounter->IsDone())
+				break;
+
+			JobSystem::Get().Wait(*cell->ReadCounter);
+			cell->ReadCounter.reset();
+
+			if (cell->ReadFailed)
+			{
+				HY_ENGINE_ERROR("Failed to read world cell '{}'", cell->File);
+				cell->Data.reset();
+				cell->State = WorldCellState::Failed;
+				break;
+			}
+
+			if (!cell->Wanted)
+			{
+				cell->Data.reset();
+				cell->State = WorldCellState::Unloaded;
+				break;
+			}
+
+			// cells written without a preload set fall back to what their components refer to
+			const std::vector<std::string>& names = cell->AssetNames.empty() ? cell->Data->GetAssetNames() : cell->AssetNames;
+			for (const auto& name : names)
+			{
+				if (auto asset = Application::Get()->MainAssetManager.TryGetAsset(name))
+					cell->Assets.push_back(std::move(asset));
+			}
+
+			cell->NextAsset = 0;
+			cell->State = WorldCellState::Preloading;
+			break;
+		}
+
+		case WorldCellState::Preloading:
+		{
+			if (!cell->Wanted)
+			{
+				cell->Assets.clear();
+				cell->Data.reset();
+				cell->State = WorldCellState::Unloaded;
+				break;
+			}
+
+			if (Preload(*cell, preloadBudget))
+			{
+				cell->Loader = std::make_unique<SceneBinaryLoader>(m_Scene, cell->Data);
+				cell->State = WorldCellState::Activating;
+			}
+			break;
+		}
+
+		case WorldCellState::Activating:
+		{
+			// a cell left half way leaves like a loaded one, with whatever made it into the scene
+			if (!cell->Wanted)
+			{
+				cell->Entities = cell->Loader->GetEntities();
+				cell->Loader.reset();
+				cell->Data.reset();
+				cell->NextEntity = 0;
+				cell->State = WorldCellState::Deactivating;
+				break;
+			}
+
+			if (activationBudget == 0)
+				break;
+
+			activationBudget -= std::min(cell->Loader->Step(activationBudget), activationBudget);
+
+			if (cell->Loader->IsDone())
+			{
+				cell->Entities = cell->Loader->GetEntities();
+				cell->Loader.reset();
+				cell->Data.reset();
+				cell->State = WorldCellState::Active;
+			}
+			break;
+		}
+
+		case WorldCellState::Active:
+		{
+			if (!cell->Wanted)
+			{
+				cell->NextEntity = 0;
+				cell->State = WorldCellState::Deactivating;
+			}
+			break;
+		}
+
+		case WorldCellState::Deactivating:
+		{
+			// finishes even when the cell is wanted again, it is read anew afterwards
+			if (activationBudget == 0)
+				break;
+
+			Unload(*cell, activationBudget);
+
+			if (cell->NextEntity == cell->Entities.size())
+			{
+				cell->Entities.clear();
+				cell->Assets.clear();
+				cell->State = WorldCellState::Unloaded;
+			}
+			break;
+		}
+
+		case WorldCellState::Failed:
+			break;
+		}
+	}
+}
+
+void WorldPartition::StartRead(Cell& cell)
+{
+	cell.State = WorldCellState::Reading;
+	cell.ReadFailed = false;
+	cell.Data = std::make_shared<SceneBinaryData>();
+	cell.ReadCounter = std::make_unique<JobCounter>();
+
+	Cell* target = &cell;
+	std::filesystem::path path = m_Directory / cell.File;
+	JobSystem::Get().Submit([target, path]()
+		{
+			ZoneScopedN("Read World Cell");
+
+			std::vector<uint8_t> bytes;
+			target->ReadFailed = !ReadFile(path, bytes) || !target->Data->Parse(std::move(bytes));
+		}, cell.ReadCounter.get());
+}
+
+bool WorldPartition::Preload(Cell& cell, uint32_t& budget)
+{
+	ZoneScoped;
+
+	RenderDevice* device = Application::Get()->GetRenderDevice();
+	for (; cell.NextAsset < cell.Assets.size() && budget > 0; cell.NextAsset++)
+	{
+		if (!device)
+			continue;
+
+		MakeResident(cell.Assets[cell.NextAsset], device);
+		budget--;
+	}
+
+	return cell.NextAsset == cell.Assets.size();
+}
+
+void WorldPartition::Unload(Cell& cell, uint32_t& budget)
+{
+	ZoneScoped;
+
+	auto& registry = m_Scene.GetRegistry();
+	for (; cell.NextEntity < cell.Entities.size() && budget > 0; cell.NextEntity++)
+	{
+		// children went with their parent, gameplay may have destroyed others already
+		entt::entity entity = cell.Entities[cell.NextEntity];
+		if (!registry.valid(entity))
+			continue;
+
+		Entity(entity, &m_Scene).Delete();
+		budget--;
+	}
+}
@@ -1,6 +1,7 @@
 #include "Hydrogen/Scripting/ScriptEngine.hpp"
 #include "Hydrogen/Scene/Animation.hpp"
 #include "Hydrogen/Scene/Components.hpp"
+#include "Hydrogen/Scene/Prefab.hpp"
 #include "Hydrogen/Input.hpp"
 #include "Hydrogen/AssetManager.hpp"
 #include "Hydrogen/Application.hpp"
@@ -594,6 +595,54 @@ public:
 	}
 };
 
+class PrefabScriptModule : public ScriptModule
+{
+public:
+	void RegisterBindings(ScriptRegistry& registry) override
+	{
+		auto prefabNs = registry.BeginNamespace("Prefab");
+
+		// copies go into the scene of the given entity, all of them in one bulk instantiation
+		prefabNs.Function("spawn", [](Entity& entity, const std::string& name, uint32_t count, sol::this_state s) {
+			return Spawn(entity, name, count, {}, s);
+			}, "(entity, prefab, count)", "Spawns count copies of a prefab into the scene of the entity and returns their roots.");
+
+		prefabNs.Function("spawn_at", [](Entity& entity, const std::string& name, sol::table positions, sol::this_state s) {
+			std::vector<glm::vec3> targets;
+			targets.reserve(positions.size());
+			for (size_t i = 1; i <= positions.size(); i++)
+				targets.push_back(positions.get<glm::vec3>(i));
+
+			return Spawn(entity, name, static_cast<uint32_t>(targets.size()), targets, s);
+			}, "(entity, prefab, positions)", "Spawns one copy of a prefab per position, with its first root placed there, and returns their roots.");
+	}
+
+private:
+	static sol::table Spawn(Entity& entity, const std::string& name, uint32_t count, const std::vector<glm::vec3>& positions, sol::this_state s)
+	{
+		sol::state_view lua(s);
+		sol::table result = lua.create_table(count, 0);
+
+		auto prefab = Application::Get()->MainAssetManager.TryGetAsset<PrefabAsset>(name);
+		if (!prefab || !entity.IsValid())
+		{
+			HY_APP_ERROR("Script: cannot spawn prefab '{}'", name);
+			return result;
+		}
+
+		// Instantiate moves the roots by offsets, scripts give the positions they should end up at
+		std::vector<glm::vec3> offsets(positions.size());
+		for (size_t i = 0; i < positions.size(); i++)
+			offsets[i] = positions[i] - prefab->GetTemplate().Origin;
+
+		std::vector<Entity> roots = entity.GetScene()->Instantiate(*prefab, count, offsets);
+		for (size_t i = 0; i < roots.size(); i++)
+			result[i + 1] = roots[i];
+
+		return result;
+	}
+};
+
 void ScriptEngine::Init()
 {
 	ScriptRegistry registry;
@@ -604,6 +653,7 @@ void ScriptEngine::Init()
 	modules.push_back(std::make_unique<PhysicsScriptModule>());
 	modules.push_back(std::make_unique<InputScriptModule>());
 	modules.push_back(std::make_unique<EntityScriptModule>());
+	modules.push_back(std::make_unique<PrefabScriptModule>());
 
 	for (auto& mod : modules)
 	{
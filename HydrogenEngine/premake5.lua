@@ -37,6 +37,13 @@ project "HydrogenEngine"
 	filter "system:windows"
 		defines { "HY_SYSTEM_WINDOWS", "_CRT_SECURE_NO_WARNINGS" }
 
+	filter "system:linux"
+		defines { "HY_SYSTEM_LINUX" }
+		removefiles { "Source/Platform/Windows/**", "Include/Hydrogen/Platform/Windows/**",
+			"%{wks.location}/Extern/imgui-docking/backends/imgui_impl_win32.*" }
+		removelinks { "vulkan-1" }
+		links { "vulkan" }
+
 	filter "configurations:Debug"
 		defines { "HY_DEBUG" }
 		optimize "Off"
@@ -0,0 +1,84 @@
+#version 450
+
+#include "Clusters.glslh"
+
+layout(local_size_x = 128) in;
+
+layout(std430, binding = 0, set = 1) writeonly buffer ClusterLightCounts
+{
+    uint clusterLightCounts[];
+};
+
+layout(std430, binding = 1, set = 1) writeonly buffer ClusterLightIndices
+{
+    uint clusterLightIndices[];
+};
+
+shared uint sharedLightCount;
+
+vec3 GetViewRay(vec2 ndc)
+{
+    vec4 point = clusterParams.inverseProj * vec4(ndc, 1.0, 1.0);
+    return point.xyz / point.w;
+}
+
+bool SphereIntersectsAABB(vec3 center, float radius, vec3 aabbMin, vec3 aabbMax)
+{
+    vec3 closest = clamp(center, aabbMin, aabbMax);
+    vec3 delta = closest - center;
+    return dot(delta, delta) <= radius * radius;
+}
+
+// one work group per cluster, the threads stride over the light list
+void main()
+{
+    uvec3 cluster = gl_WorkGroupID;
+    uint clusterIndex = GetClusterIndex(cluster);
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        sharedLightCount = 0;
+    }
+    barrier();
+
+    vec2 tileSize = 2.0 / vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y);
+    vec2 tileMinNdc = vec2(cluster.xy) * tileSize - 1.0;
+    vec2 tileMaxNdc = tileMinNdc + tileSize;
+
+    vec3 minRay = GetViewRay(tileMinNdc);
+    vec3 maxRay = GetViewRay(tileMaxNdc);
+
+    float sliceNear = GetSliceDepth(cluster.z);
+    float sliceFar = GetSliceDepth(cluster.z + 1);
+
+    // the view looks down -z, scale each corner ray onto both slice planes
+    vec3 minNear = minRay * (sliceNear / -minRay.z);
+    vec3 minFar = minRay * (sliceFar / -minRay.z);
+    vec3 maxNear = maxRay * (sliceNear / -maxRay.z);
+    vec3 maxFar = maxRay * (sliceFar / -maxRay.z);
+
+    vec3 aabbMin = min(min(minNear, minFar), min(maxNear, maxFar));
+    vec3 aabbMax = max(max(minNear, minFar), max(maxNear, maxFar));
+
+    for (uint i = gl_LocalInvocationIndex; i < clusterParams.lightCount; i += gl_WorkGroupSize.x)
+    {
+        PointLight light = pointLights[i];
+        if (!SphereIntersectsAABB(light.viewPosition.xyz, light.positionRadius.w, aabbMin, aabbMax))
+        {
+            continue;
+        }
+
+        uint slot = atomicAdd(sharedLightCount, 1);
+        if (slot < MAX_LIGHTS_PER_CLUSTER)
+        {
+            clusterLightIndices[clusterIndex * MAX_LIGHTS_PER_CLUSTER + slot] = i;
+        }
+    }
+
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0)
+    {
+        clusterLightCounts[clusterIndex] = min(sharedLightCount, uint(MAX_LIGHTS_PER_CLUSTER));
+    }
+}
@@ -2,8 +2,8 @@
 
 #extension GL_KHR_vulkan_glsl : enable
 
-layout(set = 0, binding = 0, set = 1) uniform sampler2D hdrScene;
-layout(set = 0, binding = 1, set = 1) uniform sampler2D bloomBlur;
+layout(binding = 0, set = 1) uniform sampler2D hdrScene;
+layout(binding = 1, set = 1) uniform sampler2D bloomBlur;
 
 layout(location = 0) in vec2 inUV;
 
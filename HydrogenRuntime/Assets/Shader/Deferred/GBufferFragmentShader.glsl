@@ -4,44 +4,45 @@
 
 layout(binding = 0, set = 1) uniform sampler2D materialTextures[];
 
-layout(push_constant) uniform constants
-{
-    mat4 model;
-    
-    int albedoIndex;
-    int normalIndex;
-    int ormIndex;
-    int emissiveIndex;
-    
-    vec4 tint;
-    
-    float roughness;
-    float metallic;
-    float padding0;
-    float padding1;
-    
-    vec4 emissive;
-} PushConstants;
+#include "GBufferCommon.glslh"
+#include "GBufferEncoding.glslh"
 
 layout(location = 0) in vec3 fragPos;
 layout(location = 1) in vec2 fragUV;
 layout(location = 2) in vec3 fragNormal;
 layout(location = 3) in vec3 fragTangent;
+layout(location = 4) in vec4 fragPrevClip;
+layout(location = 5) in vec4 fragPrevClipStatic;
 
+#ifdef COMPACT_GBUFFER
+layout(location = 0) out vec2 outNormal; // octahedron encoded
+layout(location = 1) out vec4 outAlbedo;
+layout(location = 2) out vec4 outMaterial; // r = roughness, g = metallic, b = ao
+layout(location = 3) out vec3 outEmissive; // premultiplied by intensity
+layout(location = 4) out vec2 outVelocity;
+#else
 layout(location = 0) out vec4 outPosition;
 layout(location = 1) out vec4 outNormal;
 layout(location = 2) out vec4 outAlbedoRough;
 layout(location = 3) out vec4 outMaterial; // r = metallic, g = ao
 layout(location = 4) out vec4 outEmissive;
+layout(location = 5) out vec2 outVelocity;
+#endif
 
-void main()
+// uv offset to last frame caused by the object itself, camera motion is left to a depth reprojection
+vec2 ObjectVelocity()
 {
-    outPosition = vec4(fragPos, 1.0);
-    outMaterial = vec4(0.0, 1.0, 0.0, 0.0);
+    vec2 previous = fragPrevClip.xy / fragPrevClip.w;
+    vec2 previousStatic = fragPrevClipStatic.xy / fragPrevClipStatic.w;
+    return (previous - previousStatic) * 0.5;
+}
 
+void main()
+{
+    vec3 normal;
     if (PushConstants.normalIndex == -1)
     {
-        outNormal = vec4(normalize(fragNormal), 1.0);
+        normal = normalize(fragNormal);
     }
     else
     {
@@ -53,38 +54,58 @@ void main()
         vec3 B = cross(N, T);
         mat3 TBN = mat3(T, B, N);
         
-        outNormal = vec4(normalize(TBN * localNormal), 1.0);
+        normal = normalize(TBN * localNormal);
     }
 
+    vec3 albedo;
     if (PushConstants.albedoIndex == -1)
     {
-        outAlbedoRough.rgb = PushConstants.tint.rgb;
+        albedo = PushConstants.tint.rgb;
     }
     else
     {
-        outAlbedoRough.rgb = texture(materialTextures[nonuniformEXT(PushConstants.albedoIndex)], fragUV).rgb * PushConstants.tint.rgb;
+        albedo = texture(materialTextures[nonuniformEXT(PushConstants.albedoIndex)], fragUV).rgb * PushConstants.tint.rgb;
     }
 
+    float roughness;
+    float metallic;
+    float ao;
     if (PushConstants.ormIndex == -1)
     {
-        outAlbedoRough.a = PushConstants.roughness;
-        outMaterial.r = PushConstants.metallic;
-        outMaterial.g = 1.0;
+        roughness = PushConstants.roughness;
+        metallic = PushConstants.metallic;
+        ao = 1.0;
     }
     else
     {
         vec4 orm = texture(materialTextures[nonuniformEXT(PushConstants.ormIndex)], fragUV);
-        outAlbedoRough.a = orm.g;
-        outMaterial.r = orm.b;
-        outMaterial.g = orm.r;
+        roughness = orm.g;
+        metallic = orm.b;
+        ao = orm.r;
     }
 
+    vec4 emissive;
     if (PushConstants.emissiveIndex == -1)
     {
-        outEmissive = PushConstants.emissive;
+        emissive = PushConstants.emissive;
     }
     else
     {
-        outEmissive = texture(materialTextures[nonuniformEXT(PushConstants.emissiveIndex)], fragUV);
+        emissive = texture(materialTextures[nonuniformEXT(PushConstants.emissiveIndex)], fragUV);
     }
+
+#ifdef COMPACT_GBUFFER
+    outNormal = EncodeNormal(normal);
+    outAlbedo = vec4(albedo, 1.0);
+    outMaterial = vec4(roughness, metallic, ao, 0.0);
+    outEmissive = emissive.rgb * emissive.a;
+    outVelocity = ObjectVelocity();
+#else
+    outPosition = vec4(fragPos, 1.0);
+    outNormal = vec4(normal, 1.0);
+    outAlbedoRough = vec4(albedo, roughness);
+    outMaterial = vec4(metallic, ao, 0.0, 0.0);
+    outEmissive = emissive;
+    outVelocity = ObjectVelocity();
+#endif
 }
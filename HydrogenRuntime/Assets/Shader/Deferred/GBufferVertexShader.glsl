@@ -1,46 +1,97 @@
 #version 450
 
+#include "GBufferCommon.glslh"
+
 layout(binding = 0, set = 0) uniform UniformBufferObject
 {
     mat4 view;
     mat4 proj;
     vec3 viewPos;
     float pad;
+    mat4 inverseViewProj;
+    mat4 prevViewProj;
 } ubo;
 
-layout(push_constant) uniform constants
+#ifdef SHADOW_PASS
+layout(binding = 0, set = 1) uniform ShadowCascade
 {
-    mat4 model;
-    
-    int albedoIndex;
-    int normalIndex;
-    int ormIndex;
-    int emissiveIndex;
-    
-    vec4 tint;
-    
-    float roughness;
-    float metallic;
-    float padding0;
-    float padding1;
-    
-    vec4 emissive;
-} PushConstants;
+    mat4 lightViewProj;
+} cascade;
+#endif
+
+#ifdef SKINNED
+layout(std430, binding = 1, set = 1) readonly buffer DynamicBoneData
+{
+    mat4 allBones[];
+};
+#endif
+
+#ifndef SHADOW_PASS
+layout(std430, binding = 2, set = 1) readonly buffer PreviousModelData
+{
+    mat4 previousModels[];
+};
+
+#ifdef SKINNED
+layout(std430, binding = 3, set = 1) readonly buffer PreviousBoneData
+{
+    mat4 previousBones[];
+};
+#endif
+#endif
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inTexCoord;
 layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec3 inTangent;
+#ifdef SKINNED
+layout(location = 4) in ivec4 inBoneIDs;
+layout(location = 5) in vec4 inWeights;
+#endif
 
+#ifndef SHADOW_PASS
 layout(location = 0) out vec3 fragPos;
 layout(location = 1) out vec2 fragUV;
 layout(location = 2) out vec3 fragNormal;
 layout(location = 3) out vec3 fragTangent;
+layout(location = 4) out vec4 fragPrevClip;
+layout(location = 5) out vec4 fragPrevClipStatic; // where the surface would have been had only the camera moved
+#endif
+
+#ifdef SKINNED
+mat4 SkinningTransform(int baseIndex, bool previous)
+{
+    float totalWeight = inWeights.x + inWeights.y + inWeights.z + inWeights.w;
+    if (totalWeight <= 0.0)
+    {
+        return mat4(1.0);
+    }
+
+    ivec4 ids = baseIndex + inBoneIDs;
+#ifndef SHADOW_PASS
+    if (previous)
+    {
+        return previousBones[ids.x] * inWeights.x + previousBones[ids.y] * inWeights.y
+             + previousBones[ids.z] * inWeights.z + previousBones[ids.w] * inWeights.w;
+    }
+#endif
+    return allBones[ids.x] * inWeights.x + allBones[ids.y] * inWeights.y
+         + allBones[ids.z] * inWeights.z + allBones[ids.w] * inWeights.w;
+}
+#endif
 
 void main()
 {
+#ifdef SKINNED
+    mat4 boneTransform = SkinningTransform(PushConstants.boneBaseIndex, false);
+    vec4 worldPos = PushConstants.model * (boneTransform * vec4(inPosition, 1.0));
+#else
     vec4 worldPos = PushConstants.model * vec4(inPosition, 1.0);
+#endif
 
+#ifdef SHADOW_PASS
+    gl_Position = cascade.lightViewProj * worldPos;
+#else
     fragPos = worldPos.xyz;
     fragUV = inTexCoord;
 
@@ -49,6 +100,19 @@ void main()
     fragNormal = normalMatrix * inNormal;
     fragTangent = normalMatrix * inTangent;
 
+    // objects that did not move only pay for the camera reprojection, which the resolve does from depth
+    fragPrevClipStatic = ubo.prevViewProj * worldPos;
+    fragPrevClip = fragPrevClipStatic;
+    if (PushConstants.previousModelIndex >= 0)
+    {
+#ifdef SKINNED
+        vec4 prevWorldPos = previousModels[PushConstants.previousModelIndex] * (SkinningTransform(PushConstants.boneBaseIndex, true) * vec4(inPosition, 1.0));
+#else
+        vec4 prevWorldPos = previousModels[PushConstants.previousModelIndex] * vec4(inPosition, 1.0);
+#endif
+        fragPrevClip = ubo.prevViewProj * prevWorldPos;
+    }
 
     gl_Position = ubo.proj * ubo.view * worldPos;
+#endif
 }
@@ -1,24 +1,36 @@
 #version 450
 
-layout(location = 0) in vec2 inPos;
-layout(location = 1) in vec2 inUV;
+#extension GL_KHR_vulkan_glsl : enable
 
-layout(binding = 1) uniform CameraInfo
+layout(location = 0) out vec3 fragRayDir;
+
+layout(binding = 0, set = 0) uniform CameraBuffer
 {
-    mat4 viewProj;
+    mat4 view;
+    mat4 proj;
     vec3 viewPos;
-} camera;
-
-layout(location = 0) out vec3 fragRayDir;
+} ubo;
 
 void main()
 {
-    mat4 invViewProj = inverse(camera.viewProj);
+    vec2 positions[3] = vec2[](
+        vec2(-1.0, -1.0),
+        vec2( 3.0, -1.0),
+        vec2(-1.0,  3.0)
+    );
 
-    vec4 farPlaneTarget = invViewProj * vec4(inPos, 1.0, 1.0);
-    vec3 worldPosFar = farPlaneTarget.xyz / farPlaneTarget.w;
+    vec2 uvs[3] = vec2[](
+        vec2(0.0, 0.0),
+        vec2(2.0, 0.0),
+        vec2(0.0, 2.0)
+    );
+
+    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
 
-    fragRayDir = worldPosFar - camera.viewPos;
+    mat4 invViewProj = inverse(ubo.proj * ubo.view);
+
+    vec4 farPlaneTarget = invViewProj * vec4(positions[gl_VertexIndex], 1.0, 1.0);
+    vec3 worldPosFar = farPlaneTarget.xyz / farPlaneTarget.w;
 
-    gl_Position = vec4(inPos, 0.0, 1.0);
+    fragRayDir = worldPosFar - ubo.viewPos;
 }
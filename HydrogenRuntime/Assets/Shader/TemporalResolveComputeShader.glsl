@@ -0,0 +1,169 @@
+#version 450
+
+// temporal anti-aliasing with upscaling, one invocation per output pixel
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0, set = 1) uniform sampler2D currentColor;
+layout(binding = 1, set = 1) uniform sampler2D currentDepth;
+layout(binding = 2, set = 1) uniform sampler2D historyColor;
+layout(binding = 3, set = 1, rgba16f) uniform writeonly image2D resolvedImage;
+layout(binding = 4, set = 1) uniform sampler2D objectVelocity; // only the motion of the objects themselves
+
+layout(push_constant) uniform TemporalParams
+{
+    mat4 reprojection; // unjittered clip space of this frame to clip space of the previous one, camera motion only
+    vec2 jitter; // offset of every input sample from its pixel centre, in input pixels
+    vec2 inputSize;
+    vec2 outputSize;
+    vec2 outputTexelSize;
+    float feedbackMin;
+    float feedbackMax;
+    int historyValid;
+    float padding;
+} params;
+
+vec3 RGBToYCoCg(vec3 color)
+{
+    return vec3(
+         0.25 * color.r + 0.5 * color.g + 0.25 * color.b,
+         0.5  * color.r                 - 0.5  * color.b,
+        -0.25 * color.r + 0.5 * color.g - 0.25 * color.b);
+}
+
+vec3 YCoCgToRGB(vec3 color)
+{
+    return vec3(
+        color.x + color.y - color.z,
+        color.x + color.z,
+        color.x - color.y - color.z);
+}
+
+// weighting by inverse luma keeps single bright samples from dominating the blend
+float LumaWeight(vec3 colorYCoCg)
+{
+    return 1.0 / (1.0 + colorYCoCg.x);
+}
+
+// 5 tap Catmull-Rom, the four corner taps are dropped as they barely contribute
+vec3 SampleHistory(vec2 uv)
+{
+    vec2 samplePos = uv * params.outputSize;
+    vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+    vec2 f = samplePos - texPos1;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    vec2 w12 = w1 + w2;
+    vec2 texPos0 = (texPos1 - 1.0) * params.outputTexelSize;
+    vec2 texPos3 = (texPos1 + 2.0) * params.outputTexelSize;
+    vec2 texPos12 = (texPos1 + w2 / w12) * params.outputTexelSize;
+
+    vec3 result = vec3(0.0);
+    result += textureLod(historyColor, vec2(texPos12.x, texPos0.y), 0.0).rgb * (w12.x * w0.y);
+    result += textureLod(historyColor, vec2(texPos0.x, texPos12.y), 0.0).rgb * (w0.x * w12.y);
+    result += textureLod(historyColor, vec2(texPos12.x, texPos12.y), 0.0).rgb * (w12.x * w12.y);
+    result += textureLod(historyColor, vec2(texPos3.x, texPos12.y), 0.0).rgb * (w3.x * w12.y);
+    result += textureLod(historyColor, vec2(texPos12.x, texPos3.y), 0.0).rgb * (w12.x * w3.y);
+
+    float weight = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+    return max(result / weight, vec3(0.0));
+}
+
+// pulls the history towards the centre of the neighbourhood box instead of clamping per channel
+vec3 ClipToBox(vec3 history, vec3 boxMin, vec3 boxMax)
+{
+    vec3 centre = 0.5 * (boxMax + boxMin);
+    vec3 extents = 0.5 * (boxMax - boxMin) + 0.0001;
+
+    vec3 offset = history - centre;
+    vec3 units = abs(offset / extents);
+    float maxUnit = max(units.x, max(units.y, units.z));
+
+    return maxUnit > 1.0 ? centre + offset / maxUnit : history;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (pixel.x >= int(params.outputSize.x) || pixel.y >= int(params.outputSize.y))
+    {
+        return;
+    }
+
+    vec2 uv = (vec2(pixel) + 0.5) * params.outputTexelSize;
+    vec2 inputPos = uv * params.inputSize;
+    ivec2 nearest = ivec2(floor(inputPos - params.jitter));
+    ivec2 maxInput = ivec2(params.inputSize) - 1;
+
+    // reconstruct the current frame at the output pixel from the 3x3 jittered samples around it
+    vec3 current = vec3(0.0);
+    float currentWeight = 0.0;
+    vec3 moment1 = vec3(0.0);
+    vec3 moment2 = vec3(0.0);
+    float closestDepth = 1.0;
+    ivec2 closestPixel = nearest;
+
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            ivec2 samplePixel = clamp(nearest + ivec2(x, y), ivec2(0), maxInput);
+            vec3 color = RGBToYCoCg(max(texelFetch(currentColor, samplePixel, 0).rgb, vec3(0.0)));
+
+            vec2 delta = vec2(samplePixel) + 0.5 + params.jitter - inputPos;
+            float weight = exp(-2.29 * dot(delta, delta)) * LumaWeight(color); // gaussian fit of blackman-harris
+
+            current += color * weight;
+            currentWeight += weight;
+
+            moment1 += color;
+            moment2 += color * color;
+
+            float depth = texelFetch(currentDepth, samplePixel, 0).r;
+            if (depth < closestDepth)
+            {
+                closestDepth = depth;
+                closestPixel = samplePixel;
+            }
+        }
+    }
+
+    current /= max(currentWeight, 0.0001);
+
+    if (params.historyValid == 0)
+    {
+        imageStore(resolvedImage, pixel, vec4(YCoCgToRGB(current), 1.0));
+        return;
+    }
+
+    // the nearest depth of the neighbourhood keeps edges of moving foreground objects from smearing
+    vec4 previousClip = params.reprojection * vec4(uv * 2.0 - 1.0, closestDepth, 1.0);
+    vec2 historyUV = previousClip.xy / previousClip.w * 0.5 + 0.5 + texelFetch(objectVelocity, closestPixel, 0).rg;
+
+    if (any(lessThan(historyUV, vec2(0.0))) || any(greaterThan(historyUV, vec2(1.0))))
+    {
+        imageStore(resolvedImage, pixel, vec4(YCoCgToRGB(current), 1.0));
+        return;
+    }
+
+    vec3 mean = moment1 / 9.0;
+    vec3 sigma = sqrt(max(moment2 / 9.0 - mean * mean, vec3(0.0)));
+    vec3 boxMin = mean - 1.25 * sigma;
+    vec3 boxMax = mean + 1.25 * sigma;
+
+    vec3 history = ClipToBox(RGBToYCoCg(SampleHistory(historyUV)), boxMin, boxMax);
+
+    // keep more history where it agrees with the current frame
+    float lumaDifference = abs(current.x - history.x) / max(current.x, max(history.x, 0.2));
+    float agreement = 1.0 - lumaDifference;
+    float feedback = mix(params.feedbackMin, params.feedbackMax, agreement * agreement);
+
+    float historyBlend = feedback * LumaWeight(history);
+    float currentBlend = (1.0 - feedback) * LumaWeight(current);
+    vec3 resolved = (history * historyBlend + current * currentBlend) / max(historyBlend + currentBlend, 0.0001);
+
+    imageStore(resolvedImage, pixel, vec4(YCoCgToRGB(resolved), 1.0));
+}
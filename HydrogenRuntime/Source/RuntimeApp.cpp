@@ -1,8 +1,11 @@
 #include <Hydrogen/HydrogenMain.hpp>
 #include <imgui.h>
+#include <stb_image_write.h>
 #include <vector>
 #include <numeric>
 #include <algorithm>
+#include <filesystem>
+#include <format>
 
 using namespace Hydrogen;
 
@@ -34,8 +37,8 @@ private:
 			});
 
 		glm::ivec2 size = {
-				(int)MainViewport->GetHeight(),
-				(int)MainViewport->GetWidth()
+				(int)MainViewport->GetWidth(),
+				(int)MainViewport->GetHeight()
 		};
 
 		if (activeCameraEntity.IsValid())
@@ -50,7 +53,62 @@ private:
 		return false;
 	}
 
+	// --headless [--frames N] [--dump <dir>] [--scene <name>] [--world <manifest>] [--width W] [--height H]
+	void ParseCommandLine()
+	{
+		for (size_t i = 0; i < CommandLineArgs.size(); i++)
+		{
+			const std::string& arg = CommandLineArgs[i];
+			bool hasValue = i + 1 < CommandLineArgs.size();
+
+			if (arg == "--headless")
+				ApplicationSpec.Headless = true;
+			else if (arg == "--frames" && hasValue)
+				ApplicationSpec.FrameLimit = std::stoull(CommandLineArgs[++i]);
+			else if (arg == "--dump" && hasValue)
+				m_DumpDirectory = CommandLineArgs[++i];
+			else if (arg == "--scene" && hasValue)
+				ApplicationSpec.StartupScene = CommandLineArgs[++i];
+			else if (arg == "--world" && hasValue)
+				m_WorldManifest = CommandLineArgs[++i];
+			else if (arg == "--width" && hasValue)
+				ApplicationSpec.ViewportSize.x = (float)std::stoi(CommandLineArgs[++i]);
+			else if (arg == "--height" && hasValue)
+				ApplicationSpec.ViewportSize.y = (float)std::stoi(CommandLineArgs[++i]);
+			else
+				HY_APP_WARN("Ignoring unknown command line argument '{}'", arg);
+		}
+	}
+
+	std::unique_ptr<Renderer> CreateRenderer()
+	{
+		if (IsHeadless())
+			return std::make_unique<Renderer>(ActiveRenderDevice.get());
+
+		return std::make_unique<Renderer>(MainViewport, ActiveRenderDevice.get(), ActiveSwapChain.get());
+	}
+
+	void DumpFrame(const RgTextureView& output)
+	{
+		uint32_t width = (uint32_t)MainViewport->GetWidth();
+		uint32_t height = (uint32_t)MainViewport->GetHeight();
+		auto pixels = m_Renderer->ReadbackTexture(output, width, height, TextureFormat::RGBA16_SFLOAT);
+
+		std::filesystem::create_directories(m_DumpDirectory);
+		std::string path = (m_DumpDirectory / std::format("frame_{:05}.png", GetFrameCount())).string();
+		if (!stbi_write_png(path.c_str(), (int)width, (int)height, 4, pixels.data(), (int)width * 4))
+		{
+			HY_APP_ERROR("Failed to write frame dump '{}'", path);
+		}
+	}
+
 	std::unique_ptr<Renderer> m_Renderer;
+	std::filesystem::path m_DumpDirectory;
+
+	// cells of the world stream in around the camera position of the last rendered frame
+	std::string m_WorldManifest;
+	std::unique_ptr<WorldPartition> m_World;
+	glm::vec3 m_StreamingFocus{ 0.0f };
 
 public:
 	virtual void OnSetup() override
@@ -60,22 +118,36 @@ public:
 		ApplicationSpec.ViewportTitle = "Hydrogen Runtime";
 		ApplicationSpec.ViewportSize = { 1920, 1080 };
 		ApplicationSpec.UseDebugGUI = false;
+
+		ParseCommandLine();
 	}
 
 	virtual void OnStartup() override
 	{
-		m_Renderer = std::make_unique<Renderer>(MainViewport, ActiveRenderDevice.get(), ActiveSwapChain.get());
+		m_Renderer = CreateRenderer();
+
+		// the world streams into an empty scene, the startup scene may be the one the world was built from
+		// and its entities would come in a second time with the cells
+		if (!m_WorldManifest.empty())
+		{
+			CurrentScene->ClearScene();
+			m_World = std::make_unique<WorldPartition>(*CurrentScene->GetScene(), m_WorldManifest);
+		}
 
-		CurrentScene->GetScene()->CreateScripts();
+		CurrentScene->GetScene()->InitScripts();
 	}
 
 	virtual void OnShutdown() override
 	{
+		m_World.reset();
 		m_Renderer.reset();
 	}
 
 	virtual void OnUpdate(float dt) override
 	{
+		if (m_World)
+			m_World->Update(m_StreamingFocus);
+
 		PhysicsUpdate(dt);
 		RenderScene(dt);
 	}
@@ -96,7 +168,7 @@ public:
 
 	virtual void OnRenderDeviceChangeFinish() override
 	{
-		m_Renderer = std::make_unique<Renderer>(MainViewport, ActiveRenderDevice.get(), ActiveSwapChain.get());
+		m_Renderer = CreateRenderer();
 	}
 
 private:
@@ -109,10 +181,18 @@ private:
 		}
 
 		const auto& camera = cameraEntity.GetComponent<CameraComponent>();
-		const auto& cameraPos = cameraEntity.GetComponent<TransformComponent>().GetPosition();
+		glm::vec3 cameraPos = glm::vec3(glm::inverse(camera.View)[3]);
+		m_StreamingFocus = cameraPos;
+
 		const auto& scene = CurrentScene->GetScene();
 
-		DefaultRenderer::RenderSceneDeferred(m_Renderer.get(), { .Display = { .Width = (uint64_t)MainViewport->GetWidth(), .Height = (uint64_t)MainViewport->GetHeight() }}, camera, cameraPos, scene);
+		RenderSettings settings = { .Display = { .Width = (uint64_t)MainViewport->GetWidth(), .Height = (uint64_t)MainViewport->GetHeight(), .RenderToSwapChain = !IsHeadless() } };
+		auto output = DefaultRenderer::RenderSceneDeferred(m_Renderer.get(), settings, camera, cameraPos, scene);
+
+		if (IsHeadless() && !m_DumpDirectory.empty())
+		{
+			DumpFrame(output);
+		}
 	}
 };
 
@@ -16,6 +16,10 @@ project "HydrogenRuntime"
 
 	files { "Include/**.h", "Include/**.hpp", "Source/**.cpp", "Resources/resource.rc" }
 
+	filter "system:linux"
+		removefiles { "Resources/resource.rc" }
+		links { "vulkan", "pthread" }
+
 	filter "configurations:Debug"
 		kind "ConsoleApp"
 		defines { "HY_DEBUG" }
@@ -183,6 +183,14 @@ function Input.get_mouse_y() end
 function Input.get_mouse_delta_x() end
 function Input.get_mouse_delta_y() end
 
+---@class Prefab
+Prefab = {}
+
+--- Spawns count copies of a prefab into the scene of the entity and returns their roots.
+function Prefab.spawn(entity, prefab, count) end
+--- Spawns one copy of a prefab per position, with its first root placed there, and returns their roots.
+function Prefab.spawn_at(entity, prefab, positions) end
+
 ---@class vec2
 ---@field x number
 ---@field y number
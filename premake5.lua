@@ -13,5 +13,6 @@ outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 include "HydrogenEngine"
 include "HydrogenEditor"
 include "HydrogenRuntime"
+include "HydrogenBenchmark"
 include "HydrogenLauncher"
 include "HydrogenTools"